@@ -1,6 +1,7 @@
 TEMPLATE = subdirs
 SUBDIRS = daemon gui \
-    tests
+    tests \
+    benchmarks
 daemon.file = daemon.pro
 gui.file = gui.pro
-
+benchmarks.file = tests/benchmarks/benchmarks.pro
@@ -57,11 +57,16 @@ SOURCES += src/main_daemon.cpp \
     src/MPDevice.cpp \
     src/MPManager.cpp \
     src/Common.cpp \
+    src/AsyncLogger.cpp \
     src/WSServer.cpp \
     src/AppDaemon.cpp \
     src/AsyncJobs.cpp \
     src/MPNode.cpp \
     src/WSServerCon.cpp \
+    src/ExportFileGenerator.cpp \
+    src/IpcSocket.cpp \
+    src/WsCompression.cpp \
+    src/SocketActivation.cpp \
     src/MPDevice_emul.cpp \
     src/http-parser/http_parser.c \
     src/HttpClient.cpp \
@@ -69,14 +74,19 @@ SOURCES += src/main_daemon.cpp \
     src/MooltipassCmds.cpp \
     src/FilesCache.cpp \
     src/SimpleCrypt/SimpleCrypt.cpp \
+    src/AeadCrypt/AeadCrypt.cpp \
+    src/AeadCrypt/ChaChaPoly.cpp \
+    src/AeadCrypt/BlockCompressor.cpp \
     src/ParseDomain.cpp \
     src/MessageProtocol/MessageProtocolMini.cpp \
     src/MessageProtocol/MessageProtocolBLE.cpp \
     src/MPDeviceBleImpl.cpp \
+    src/FetchDataWriter.cpp \
     src/HaveIBeenPwned.cpp
 
 HEADERS  += \
     src/Common.h \
+    src/AsyncLogger.h \
     src/MPDevice.h \
     src/MPManager.h \
     src/MooltipassCmds.h \
@@ -87,17 +97,26 @@ HEADERS  += \
     src/MPNode.h \
     src/version.h \
     src/WSServerCon.h \
+    src/ExportFileGenerator.h \
+    src/IpcSocket.h \
+    src/WsCompression.h \
+    src/SocketActivation.h \
     src/MPDevice_emul.h \
     src/http-parser/http_parser.h \
     src/HttpClient.h \
     src/HttpServer.h \
     src/FilesCache.h \
     src/SimpleCrypt/SimpleCrypt.h \
+    src/AeadCrypt/AeadCrypt.h \
+    src/AeadCrypt/ChaChaPoly.h \
+    src/AeadCrypt/BlockCompressor.h \
     src/ParseDomain.h \
     src/MessageProtocol/IMessageProtocol.h \
+    src/MessageProtocol/CommandMap.h \
     src/MessageProtocol/MessageProtocolMini.h \
     src/MessageProtocol/MessageProtocolBLE.h \
     src/MPDeviceBleImpl.h \
+    src/FetchDataWriter.h \
     src/HaveIBeenPwned.h \
     src/BleCommon.h
 
@@ -146,5 +165,6 @@ unix {
     # systemd service files
     systemd_user.path = $$PREFIX/lib/systemd/system/
     systemd_user.files += $$PWD/systemd/moolticuted.service
+    systemd_user.files += $$PWD/systemd/moolticuted.socket
     INSTALLS += systemd_user
 }
@@ -24,15 +24,20 @@ SOURCES += src/main_gui.cpp \
     src/MainWindow.cpp \
     src/ParseDomain.cpp \
     src/Common.cpp \
+    src/AsyncLogger.cpp \
     src/WSClient.cpp \
+    src/IpcSocket.cpp \
+    src/WsCompression.cpp \
     src/RotateSpinner.cpp \
     src/AppGui.cpp \
     src/DaemonMenuAction.cpp \
     src/AutoStartup.cpp \
     src/WindowLog.cpp \
-    src/OutputLog.cpp \
+    src/LogModel.cpp \
+    src/LogParser.cpp \
     src/AnsiEscapeCodeHandler.cpp \
     src/PasswordLineEdit.cpp \
+    src/PasswordStrengthScorer.cpp \
     src/CredentialsManagement.cpp \
     src/zxcvbn-c/zxcvbn.c \
     src/FilesManagement.cpp \
@@ -40,6 +45,7 @@ SOURCES += src/main_gui.cpp \
     src/CredentialView.cpp \
     src/CredentialModel.cpp \
     src/CredentialModelFilter.cpp \
+    src/CredentialSearchIndex.cpp \
     src/ItemDelegate.cpp \
     src/LoginItem.cpp \
     src/TreeItem.cpp \
@@ -64,17 +70,22 @@ SOURCES += src/main_gui.cpp \
 HEADERS  += src/MainWindow.h \
     src/ParseDomain.h \
     src/Common.h \
+    src/AsyncLogger.h \
     src/QtHelper.h \
     src/WSClient.h \
+    src/IpcSocket.h \
+    src/WsCompression.h \
     src/RotateSpinner.h \
     src/version.h \
     src/AppGui.h \
     src/DaemonMenuAction.h \
     src/AutoStartup.h \
     src/WindowLog.h \
-    src/OutputLog.h \
+    src/LogModel.h \
+    src/LogParser.h \
     src/AnsiEscapeCodeHandler.h \
     src/PasswordLineEdit.h \
+    src/PasswordStrengthScorer.h \
     src/CredentialsManagement.h \
     src/zxcvbn-c/dict-src.h \
     src/zxcvbn-c/zxcvbn.h \
@@ -88,6 +99,7 @@ HEADERS  += src/MainWindow.h \
     src/ItemDelegate.h \
     src/CredentialModel.h \
     src/CredentialModelFilter.h \
+    src/CredentialSearchIndex.h \
     src/AnimatedColorButton.h \
     src/PasswordProfilesModel.h \
     src/PassGenerationProfilesDialog.h \
@@ -0,0 +1,412 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#include "AeadCrypt.h"
+#include "ChaChaPoly.h"
+
+#include <QMessageAuthenticationCode>
+#include <QtEndian>
+#include <cstring>
+
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
+#include <QRandomGenerator>
+#else
+#include <random>
+#endif
+
+static const char AEAD_MAGIC[AeadCrypt::MAGIC_SIZE] = { 'M', 'C', 'A', 'E' };
+static const char AEAD_KDF_INFO[] = "moolticute aead v1";
+
+static const int MIN_CHUNK_LOG2 = 10;
+static const int MAX_CHUNK_LOG2 = 24;
+static const quint8 FLAGS_CODEC_MASK = 0x0F;
+
+static void wipe(QByteArray &data)
+{
+    if (data.isEmpty())
+        return;
+    memset(data.data(), 0, static_cast<size_t>(data.size()));
+    data.clear();
+}
+
+static const quint8 *u8(const char *data)
+{
+    return reinterpret_cast<const quint8 *>(data);
+}
+
+AeadCrypt::AeadCrypt()
+{
+}
+
+AeadCrypt::AeadCrypt(const QByteArray &keyMaterial):
+    m_keyMaterial(keyMaterial)
+{
+}
+
+AeadCrypt::~AeadCrypt()
+{
+    wipe(m_keyMaterial);
+}
+
+void AeadCrypt::setKeyMaterial(const QByteArray &keyMaterial)
+{
+    wipe(m_keyMaterial);
+    m_keyMaterial = keyMaterial;
+}
+
+QByteArray AeadCrypt::randomBytes(int size)
+{
+    QByteArray out(size, Qt::Uninitialized);
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
+    for (int i = 0;i < size;i++)
+        out[i] = static_cast<char>(QRandomGenerator::system()->generate() & 0xFF);
+#else
+    std::random_device rd;
+    for (int i = 0;i < size;i++)
+        out[i] = static_cast<char>(rd() & 0xFF);
+#endif
+    return out;
+}
+
+QByteArray AeadCrypt::deriveKey(const QByteArray &salt) const
+{
+    //HKDF-SHA256 (RFC 5869), one block of output is exactly the key size
+    QByteArray prk = QMessageAuthenticationCode::hash(m_keyMaterial, salt, QCryptographicHash::Sha256);
+    QByteArray info(AEAD_KDF_INFO);
+    info.append(static_cast<char>(0x01));
+    QByteArray key = QMessageAuthenticationCode::hash(info, prk, QCryptographicHash::Sha256);
+    wipe(prk);
+    return key;
+}
+
+void AeadCrypt::makeNonce(const QByteArray &header, quint32 index, bool last, quint8 *nonce)
+{
+    memcpy(nonce, header.constData() + HEADER_SIZE - NONCE_PREFIX_SIZE, NONCE_PREFIX_SIZE);
+    qToBigEndian(index, nonce + NONCE_PREFIX_SIZE);
+    nonce[ChaChaPoly::NONCE_SIZE - 1] = last? 1 : 0;
+}
+
+bool AeadCrypt::isAeadData(const QByteArray &data)
+{
+    return data.size() >= HEADER_SIZE + TAG_SIZE &&
+           memcmp(data.constData(), AEAD_MAGIC, MAGIC_SIZE) == 0;
+}
+
+bool AeadCrypt::isAeadString(const QString &cipher)
+{
+    //"MCAE" is "TUNBRQ" once base64 encoded
+    return cipher.startsWith(QStringLiteral("TUNBRQ"));
+}
+
+QByteArray AeadCrypt::encrypt(const QByteArray &plaintext)
+{
+    if (!hasKey())
+    {
+        m_lastError = ErrorNoKeySet;
+        return QByteArray();
+    }
+
+    BlockCompressor::Codec codec = BlockCompressor::CodecStore;
+    QByteArray compressed = BlockCompressor::compress(plaintext, m_compressionLevel, codec);
+
+    Encryptor enc(*this, DEFAULT_CHUNK_LOG2, codec);
+    QByteArray out = enc.update(compressed);
+    out.append(enc.finish());
+    if (codec != BlockCompressor::CodecStore)
+        wipe(compressed);
+    return out;
+}
+
+QByteArray AeadCrypt::decrypt(const QByteArray &cipher)
+{
+    Decryptor dec(*this);
+    QByteArray out;
+    if (!dec.update(cipher, out) || !dec.finish(out))
+    {
+        wipe(out);
+        return QByteArray();
+    }
+
+    if (dec.codec() == BlockCompressor::CodecStore)
+        return out;
+
+    QByteArray plaintext;
+    bool ok = BlockCompressor::decompress(out, dec.codec(), plaintext);
+    wipe(out);
+    if (!ok)
+    {
+        m_lastError = ErrorDecompressionFailed;
+        wipe(plaintext);
+        return QByteArray();
+    }
+    return plaintext;
+}
+
+QString AeadCrypt::encryptToString(const QByteArray &plaintext)
+{
+    return QString::fromLatin1(encrypt(plaintext).toBase64());
+}
+
+QByteArray AeadCrypt::decryptToByteArray(const QString &cipher)
+{
+    return decrypt(QByteArray::fromBase64(cipher.toLatin1()));
+}
+
+AeadCrypt::Encryptor::Encryptor(AeadCrypt &crypt, int chunkLog2, BlockCompressor::Codec codec):
+    m_crypt(crypt)
+{
+    chunkLog2 = qBound(MIN_CHUNK_LOG2, chunkLog2, MAX_CHUNK_LOG2);
+    m_chunkSize = 1 << chunkLog2;
+
+    m_crypt.m_lastError = ErrorNoError;
+    if (!m_crypt.hasKey())
+    {
+        m_crypt.m_lastError = ErrorNoKeySet;
+        m_finished = true;
+        return;
+    }
+
+    QByteArray salt = randomBytes(SALT_SIZE);
+    m_header.reserve(HEADER_SIZE);
+    m_header.append(AEAD_MAGIC, MAGIC_SIZE);
+    m_header.append(static_cast<char>(VERSION));
+    m_header.append(static_cast<char>(codec & FLAGS_CODEC_MASK)); //flags
+    m_header.append(static_cast<char>(chunkLog2));
+    m_header.append(salt);
+    m_header.append(randomBytes(NONCE_PREFIX_SIZE));
+
+    m_key = m_crypt.deriveKey(salt);
+}
+
+AeadCrypt::Encryptor::~Encryptor()
+{
+    wipe(m_key);
+    wipe(m_pending);
+}
+
+void AeadCrypt::Encryptor::sealChunk(const char *data, int len, bool last, QByteArray &out)
+{
+    quint8 nonce[ChaChaPoly::NONCE_SIZE];
+    makeNonce(m_header, m_chunkIndex++, last, nonce);
+
+    int pos = out.size();
+    out.resize(pos + len + TAG_SIZE);
+    ChaChaPoly::seal(u8(m_key.constData()), nonce,
+                     u8(m_header.constData()), static_cast<size_t>(m_header.size()),
+                     u8(data), static_cast<size_t>(len),
+                     reinterpret_cast<quint8 *>(out.data() + pos));
+}
+
+QByteArray AeadCrypt::Encryptor::update(const QByteArray &plaintext)
+{
+    QByteArray out;
+    if (m_finished)
+        return out;
+
+    if (!m_headerSent)
+    {
+        out.append(m_header);
+        m_headerSent = true;
+    }
+
+    const char *data = plaintext.constData();
+    int len = plaintext.size();
+
+    //Complete a previously buffered chunk first
+    if (!m_pending.isEmpty())
+    {
+        int take = qMin(len, m_chunkSize - m_pending.size());
+        m_pending.append(data, take);
+        data += take;
+        len -= take;
+        if (len == 0)
+            return out;
+
+        //The last chunk is only sealed in finish(), so a full chunk is
+        //written only when more data follows it
+        sealChunk(m_pending.constData(), m_pending.size(), false, out);
+        wipe(m_pending);
+    }
+
+    out.reserve(out.size() + (len / m_chunkSize + 1) * (m_chunkSize + TAG_SIZE));
+    while (len > m_chunkSize)
+    {
+        sealChunk(data, m_chunkSize, false, out);
+        data += m_chunkSize;
+        len -= m_chunkSize;
+    }
+
+    m_pending.append(data, len);
+    return out;
+}
+
+QByteArray AeadCrypt::Encryptor::finish()
+{
+    QByteArray out;
+    if (m_finished)
+        return out;
+
+    if (!m_headerSent)
+    {
+        out.append(m_header);
+        m_headerSent = true;
+    }
+
+    sealChunk(m_pending.constData(), m_pending.size(), true, out);
+    wipe(m_pending);
+    wipe(m_key);
+    m_finished = true;
+    return out;
+}
+
+AeadCrypt::Decryptor::Decryptor(AeadCrypt &crypt):
+    m_crypt(crypt)
+{
+    m_crypt.m_lastError = ErrorNoError;
+    if (!m_crypt.hasKey())
+    {
+        m_crypt.m_lastError = ErrorNoKeySet;
+        m_failed = true;
+    }
+}
+
+AeadCrypt::Decryptor::~Decryptor()
+{
+    wipe(m_key);
+}
+
+bool AeadCrypt::Decryptor::parseHeader()
+{
+    if (memcmp(m_header.constData(), AEAD_MAGIC, MAGIC_SIZE) != 0)
+    {
+        m_crypt.m_lastError = ErrorInvalidHeader;
+        return false;
+    }
+
+    quint8 version = static_cast<quint8>(m_header.at(MAGIC_SIZE));
+    quint8 flags = static_cast<quint8>(m_header.at(MAGIC_SIZE + 1));
+    int chunkLog2 = static_cast<quint8>(m_header.at(MAGIC_SIZE + 2));
+    if (version != VERSION)
+    {
+        m_crypt.m_lastError = ErrorUnknownVersion;
+        return false;
+    }
+    quint8 codec = flags & FLAGS_CODEC_MASK;
+    if ((flags & ~FLAGS_CODEC_MASK) != 0 || codec > BlockCompressor::CodecZlib ||
+        chunkLog2 < MIN_CHUNK_LOG2 || chunkLog2 > MAX_CHUNK_LOG2)
+    {
+        m_crypt.m_lastError = ErrorInvalidHeader;
+        return false;
+    }
+
+    m_codec = static_cast<BlockCompressor::Codec>(codec);
+    m_chunkSize = 1 << chunkLog2;
+    m_key = m_crypt.deriveKey(m_header.mid(MAGIC_SIZE + 3, SALT_SIZE));
+    return true;
+}
+
+bool AeadCrypt::Decryptor::openChunk(const char *data, int len, bool last, QByteArray &out)
+{
+    quint8 nonce[ChaChaPoly::NONCE_SIZE];
+    makeNonce(m_header, m_chunkIndex++, last, nonce);
+
+    int plainLen = len - TAG_SIZE;
+    int pos = out.size();
+    out.resize(pos + plainLen);
+    if (!ChaChaPoly::open(u8(m_key.constData()), nonce,
+                          u8(m_header.constData()), static_cast<size_t>(m_header.size()),
+                          u8(data), static_cast<size_t>(plainLen),
+                          reinterpret_cast<quint8 *>(out.data() + pos)))
+    {
+        out.resize(pos);
+        m_crypt.m_lastError = ErrorIntegrityFailed;
+        m_failed = true;
+        return false;
+    }
+    return true;
+}
+
+bool AeadCrypt::Decryptor::update(const QByteArray &cipher, QByteArray &plaintext)
+{
+    if (m_failed || m_finished)
+        return !m_failed;
+
+    //Avoid copying when there is nothing buffered (one shot decryption)
+    QByteArray buffer;
+    if (m_pending.isEmpty())
+        buffer = cipher;
+    else
+    {
+        m_pending.append(cipher);
+        buffer.swap(m_pending);
+    }
+
+    const char *data = buffer.constData();
+    int len = buffer.size();
+
+    if (m_header.isEmpty())
+    {
+        if (len < HEADER_SIZE)
+        {
+            m_pending = buffer;
+            return true;
+        }
+
+        m_header = QByteArray(data, HEADER_SIZE);
+        data += HEADER_SIZE;
+        len -= HEADER_SIZE;
+        if (!parseHeader())
+        {
+            m_failed = true;
+            return false;
+        }
+    }
+
+    //Keep the last chunk for finish(), it is sealed with the last marker
+    const int sealedChunk = m_chunkSize + TAG_SIZE;
+    plaintext.reserve(plaintext.size() + (len / sealedChunk) * m_chunkSize);
+    while (len > sealedChunk)
+    {
+        if (!openChunk(data, sealedChunk, false, plaintext))
+            return false;
+        data += sealedChunk;
+        len -= sealedChunk;
+    }
+
+    m_pending = QByteArray(data, len);
+    return true;
+}
+
+bool AeadCrypt::Decryptor::finish(QByteArray &plaintext)
+{
+    if (m_failed || m_finished)
+        return !m_failed;
+
+    m_finished = true;
+    if (m_header.isEmpty() || m_pending.size() < TAG_SIZE)
+    {
+        m_crypt.m_lastError = m_header.isEmpty()? ErrorInvalidHeader : ErrorTruncated;
+        m_failed = true;
+        return false;
+    }
+
+    bool ok = openChunk(m_pending.constData(), m_pending.size(), true, plaintext);
+    m_pending.clear();
+    wipe(m_key);
+    return ok;
+}
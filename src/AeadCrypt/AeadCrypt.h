@@ -0,0 +1,154 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#ifndef AEADCRYPT_H
+#define AEADCRYPT_H
+
+#include <QByteArray>
+#include <QString>
+#include "BlockCompressor.h"
+
+/* Authenticated encryption of exports and caches, replaces SimpleCrypt.
+ *
+ * Data is split in chunks which are sealed independently with
+ * ChaCha20-Poly1305. Output layout:
+ *
+ *   header: "MCAE" | version | flags | chunk size log2 | salt (16) | nonce prefix (7)
+ *   chunks: ciphertext | tag (16), every chunk but the last one is full
+ *
+ * The low bits of flags hold the BlockCompressor codec used on the plaintext
+ * by encrypt(). The streaming classes work on raw data, the codec is only
+ * carried in the header for them.
+ *
+ * The key is derived with HKDF-SHA256 from the key material (the card CPZ)
+ * and the random per file salt. The chunk nonce is the nonce prefix followed
+ * by the big endian chunk index and a last chunk marker, and the header is
+ * authenticated with every chunk, so chunks can't be reordered, dropped or
+ * truncated without decryption failing.
+ */
+class AeadCrypt
+{
+public:
+    enum Error
+    {
+        ErrorNoError,
+        ErrorNoKeySet,
+        ErrorUnknownVersion,
+        ErrorInvalidHeader,
+        ErrorIntegrityFailed,
+        ErrorTruncated,
+        ErrorDecompressionFailed,
+    };
+
+    static const quint8 VERSION = 1;
+    static const int MAGIC_SIZE = 4;
+    static const int SALT_SIZE = 16;
+    static const int NONCE_PREFIX_SIZE = 7;
+    static const int HEADER_SIZE = MAGIC_SIZE + 3 + SALT_SIZE + NONCE_PREFIX_SIZE;
+    static const int TAG_SIZE = 16;
+    static const int DEFAULT_CHUNK_LOG2 = 16;
+    //Fast zlib level, exports are dominated by device I/O, not by CPU
+    static const int DEFAULT_COMPRESSION_LEVEL = 1;
+
+    AeadCrypt();
+    explicit AeadCrypt(const QByteArray &keyMaterial);
+    ~AeadCrypt();
+
+    void setKeyMaterial(const QByteArray &keyMaterial);
+    bool hasKey() const { return !m_keyMaterial.isEmpty(); }
+
+    Error lastError() const { return m_lastError; }
+
+    //0 disables compression in encrypt()
+    void setCompressionLevel(int level) { m_compressionLevel = level; }
+    int compressionLevel() const { return m_compressionLevel; }
+
+    QByteArray encrypt(const QByteArray &plaintext);
+    QByteArray decrypt(const QByteArray &cipher);
+
+    //Base64 variants, used in JSON files and line based caches
+    QString encryptToString(const QByteArray &plaintext);
+    QByteArray decryptToByteArray(const QString &cipher);
+
+    //Check if raw (non base64) data starts with an AEAD header
+    static bool isAeadData(const QByteArray &data);
+    static bool isAeadString(const QString &cipher);
+
+    class Encryptor
+    {
+    public:
+        //The header is produced by the first call to update() or finish()
+        explicit Encryptor(AeadCrypt &crypt, int chunkLog2 = DEFAULT_CHUNK_LOG2,
+                           BlockCompressor::Codec codec = BlockCompressor::CodecStore);
+        ~Encryptor();
+
+        QByteArray update(const QByteArray &plaintext);
+        QByteArray finish();
+
+    private:
+        void sealChunk(const char *data, int len, bool last, QByteArray &out);
+
+        AeadCrypt &m_crypt;
+        QByteArray m_header;
+        QByteArray m_key;
+        QByteArray m_pending;
+        int m_chunkSize;
+        quint32 m_chunkIndex = 0;
+        bool m_headerSent = false;
+        bool m_finished = false;
+    };
+
+    class Decryptor
+    {
+    public:
+        explicit Decryptor(AeadCrypt &crypt);
+        ~Decryptor();
+
+        //Return false as soon as something can't be authenticated
+        bool update(const QByteArray &cipher, QByteArray &plaintext);
+        bool finish(QByteArray &plaintext);
+
+        //Valid once the header has been read
+        BlockCompressor::Codec codec() const { return m_codec; }
+
+    private:
+        bool parseHeader();
+        bool openChunk(const char *data, int len, bool last, QByteArray &out);
+
+        AeadCrypt &m_crypt;
+        QByteArray m_header;
+        QByteArray m_key;
+        QByteArray m_pending;
+        int m_chunkSize = 0;
+        BlockCompressor::Codec m_codec = BlockCompressor::CodecStore;
+        quint32 m_chunkIndex = 0;
+        bool m_failed = false;
+        bool m_finished = false;
+    };
+
+private:
+    QByteArray deriveKey(const QByteArray &salt) const;
+    static void makeNonce(const QByteArray &header, quint32 index, bool last, quint8 *nonce);
+    static QByteArray randomBytes(int size);
+
+    QByteArray m_keyMaterial;
+    int m_compressionLevel = DEFAULT_COMPRESSION_LEVEL;
+    Error m_lastError = ErrorNoError;
+};
+
+#endif // AEADCRYPT_H
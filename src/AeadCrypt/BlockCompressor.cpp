@@ -0,0 +1,192 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#include "BlockCompressor.h"
+
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QVector>
+#include <QtEndian>
+#include <functional>
+
+static const quint32 BLOCK_STORED = 0x80000000;
+//Compressed samples must be smaller than this percentage of the input
+static const int SAMPLE_MAX_RATIO = 90;
+
+namespace
+{
+class BlockTask: public QRunnable
+{
+public:
+    BlockTask(const std::function<void(int)> &fn, int index):
+        fn(fn), index(index)
+    {
+    }
+
+    virtual void run() override
+    {
+        fn(index);
+    }
+
+private:
+    std::function<void(int)> fn;
+    int index;
+};
+}
+
+//Run fn(0) .. fn(count - 1), on worker threads when there is more than one block
+static void parallelFor(int count, const std::function<void(int)> &fn)
+{
+    if (count <= 1 || QThread::idealThreadCount() <= 1)
+    {
+        for (int i = 0;i < count;i++)
+            fn(i);
+        return;
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMin(count, QThread::idealThreadCount()));
+    for (int i = 0;i < count;i++)
+        pool.start(new BlockTask(fn, i));
+    pool.waitForDone();
+}
+
+bool BlockCompressor::isWorthCompressing(const QByteArray &data, int level)
+{
+    if (level <= 0 || data.isEmpty())
+        return false;
+
+    //Small inputs are compressed directly, a block that grows is stored anyway
+    if (data.size() <= 4 * SAMPLE_SIZE)
+        return true;
+
+    //Beginning, middle and end of the input
+    int offsets[] = { 0, (data.size() - SAMPLE_SIZE) / 2, data.size() - SAMPLE_SIZE };
+    int total = 0;
+    for (int offset: offsets)
+        total += qCompress(reinterpret_cast<const uchar *>(data.constData() + offset), SAMPLE_SIZE, level).size();
+
+    return total * 100 < 3 * SAMPLE_SIZE * SAMPLE_MAX_RATIO;
+}
+
+QByteArray BlockCompressor::compress(const QByteArray &data, int level, Codec &codec)
+{
+    if (!isWorthCompressing(data, level))
+    {
+        codec = CodecStore;
+        return data;
+    }
+
+    int count = (data.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    QVector<QByteArray> blocks(count);
+    QByteArray *out = blocks.data();
+
+    parallelFor(count, [&data, level, out](int i)
+    {
+        const uchar *src = reinterpret_cast<const uchar *>(data.constData()) + i * BLOCK_SIZE;
+        int remaining = data.size() - i * BLOCK_SIZE;
+        int len = remaining < BLOCK_SIZE? remaining : BLOCK_SIZE;
+        QByteArray c = qCompress(src, len, level);
+
+        bool stored = c.size() >= len;
+        if (stored)
+            c = QByteArray(reinterpret_cast<const char *>(src), len);
+
+        quint32 header = static_cast<quint32>(c.size()) | (stored? BLOCK_STORED : 0);
+        QByteArray block(4, Qt::Uninitialized);
+        qToBigEndian(header, reinterpret_cast<uchar *>(block.data()));
+        block.append(c);
+        out[i] = block;
+    });
+
+    QByteArray result;
+    int total = 0;
+    for (const QByteArray &b: blocks)
+        total += b.size();
+    result.reserve(total);
+    for (const QByteArray &b: blocks)
+        result.append(b);
+
+    codec = CodecZlib;
+    return result;
+}
+
+bool BlockCompressor::decompress(const QByteArray &data, Codec codec, QByteArray &out)
+{
+    if (codec == CodecStore)
+    {
+        out = data;
+        return true;
+    }
+
+    if (codec != CodecZlib)
+        return false;
+
+    //Split the frames first, then inflate them in parallel
+    struct Frame
+    {
+        int offset;
+        int size;
+        bool stored;
+    };
+    QVector<Frame> frames;
+    int pos = 0;
+    while (pos < data.size())
+    {
+        if (data.size() - pos < 4)
+            return false;
+
+        quint32 header = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(data.constData() + pos));
+        int size = static_cast<int>(header & ~BLOCK_STORED);
+        pos += 4;
+        if (size > data.size() - pos)
+            return false;
+
+        frames.append({ pos, size, (header & BLOCK_STORED) != 0 });
+        pos += size;
+    }
+
+    QVector<QByteArray> blocks(frames.size());
+    QByteArray *result = blocks.data();
+    const Frame *f = frames.constData();
+    parallelFor(frames.size(), [&data, f, result](int i)
+    {
+        const char *src = data.constData() + f[i].offset;
+        if (f[i].stored)
+            result[i] = QByteArray(src, f[i].size);
+        else
+            result[i] = qUncompress(reinterpret_cast<const uchar *>(src), f[i].size);
+    });
+
+    int total = 0;
+    for (int i = 0;i < blocks.size();i++)
+    {
+        //qUncompress returns an empty array on error, blocks are never empty
+        if (blocks.at(i).isEmpty())
+            return false;
+        total += blocks.at(i).size();
+    }
+
+    out.clear();
+    out.reserve(total);
+    for (const QByteArray &b: blocks)
+        out.append(b);
+
+    return true;
+}
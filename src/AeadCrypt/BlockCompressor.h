@@ -0,0 +1,52 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#ifndef BLOCKCOMPRESSOR_H
+#define BLOCKCOMPRESSOR_H
+
+#include <QByteArray>
+
+/* Compression stage applied before AEAD encryption.
+ *
+ * Input is cut in fixed size blocks that are compressed independently on
+ * a thread pool. Each block is written as a 32 bits big endian length,
+ * with the high bit set when the block is stored as is because it did not
+ * shrink, followed by the block data (qCompress output otherwise).
+ * Before doing any work a few samples are compressed, when they don't
+ * shrink enough the whole input is stored.
+ */
+class BlockCompressor
+{
+public:
+    enum Codec
+    {
+        CodecStore = 0,
+        CodecZlib = 1,
+    };
+
+    static const int BLOCK_SIZE = 256 * 1024;
+    static const int SAMPLE_SIZE = 16 * 1024;
+
+    //level is the zlib level, 0 disables compression. codec receives what was used
+    static QByteArray compress(const QByteArray &data, int level, Codec &codec);
+    static bool decompress(const QByteArray &data, Codec codec, QByteArray &out);
+
+    static bool isWorthCompressing(const QByteArray &data, int level);
+};
+
+#endif // BLOCKCOMPRESSOR_H
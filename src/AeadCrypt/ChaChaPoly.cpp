@@ -0,0 +1,341 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#include "ChaChaPoly.h"
+#include <cstring>
+
+namespace ChaChaPoly
+{
+
+static inline uint32_t load32(const uint8_t *p)
+{
+    return static_cast<uint32_t>(p[0]) |
+           (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static inline void store32(uint8_t *p, uint32_t v)
+{
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+    p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+static inline void store64(uint8_t *p, uint64_t v)
+{
+    store32(p, static_cast<uint32_t>(v));
+    store32(p + 4, static_cast<uint32_t>(v >> 32));
+}
+
+static inline uint32_t rotl(uint32_t v, int c)
+{
+    return (v << c) | (v >> (32 - c));
+}
+
+static const int LANES = 4;
+static const size_t BLOCK_SIZE = 64;
+
+//One quarter round on every lane
+#define QR_LANES(a, b, c, d) \
+    for (int l = 0;l < LANES;l++) \
+    { \
+        x[a][l] += x[b][l]; x[d][l] = rotl(x[d][l] ^ x[a][l], 16); \
+        x[c][l] += x[d][l]; x[b][l] = rotl(x[b][l] ^ x[c][l], 12); \
+        x[a][l] += x[b][l]; x[d][l] = rotl(x[d][l] ^ x[a][l], 8); \
+        x[c][l] += x[d][l]; x[b][l] = rotl(x[b][l] ^ x[c][l], 7); \
+    }
+
+//Generate LANES consecutive keystream blocks
+static void chachaBlocks(const uint32_t input[16], uint8_t out[LANES * BLOCK_SIZE])
+{
+    uint32_t x[16][LANES];
+    for (int i = 0;i < 16;i++)
+        for (int l = 0;l < LANES;l++)
+            x[i][l] = input[i];
+    for (int l = 0;l < LANES;l++)
+        x[12][l] += static_cast<uint32_t>(l);
+
+    for (int i = 0;i < 10;i++)
+    {
+        QR_LANES(0, 4, 8, 12)
+        QR_LANES(1, 5, 9, 13)
+        QR_LANES(2, 6, 10, 14)
+        QR_LANES(3, 7, 11, 15)
+        QR_LANES(0, 5, 10, 15)
+        QR_LANES(1, 6, 11, 12)
+        QR_LANES(2, 7, 8, 13)
+        QR_LANES(3, 4, 9, 14)
+    }
+
+    for (int l = 0;l < LANES;l++)
+    {
+        for (int i = 0;i < 16;i++)
+        {
+            uint32_t v = input[i] + (i == 12? static_cast<uint32_t>(l) : 0);
+            store32(out + l * BLOCK_SIZE + i * 4, x[i][l] + v);
+        }
+    }
+}
+
+#undef QR_LANES
+
+void chacha20Xor(const uint8_t key[KEY_SIZE], const uint8_t nonce[NONCE_SIZE],
+                 uint32_t counter, const uint8_t *in, uint8_t *out, size_t len)
+{
+    uint32_t input[16];
+    input[0] = 0x61707865;
+    input[1] = 0x3320646e;
+    input[2] = 0x79622d32;
+    input[3] = 0x6b206574;
+    for (int i = 0;i < 8;i++)
+        input[4 + i] = load32(key + i * 4);
+    input[12] = counter;
+    input[13] = load32(nonce);
+    input[14] = load32(nonce + 4);
+    input[15] = load32(nonce + 8);
+
+    uint8_t ks[LANES * BLOCK_SIZE];
+    while (len > 0)
+    {
+        chachaBlocks(input, ks);
+        input[12] += LANES;
+
+        size_t n = len < sizeof(ks)? len : sizeof(ks);
+        for (size_t i = 0;i < n;i++)
+            out[i] = in[i] ^ ks[i];
+
+        in += n;
+        out += n;
+        len -= n;
+    }
+}
+
+Poly1305::Poly1305(const uint8_t key[32])
+{
+    r[0] = (load32(key + 0)) & 0x3ffffff;
+    r[1] = (load32(key + 3) >> 2) & 0x3ffff03;
+    r[2] = (load32(key + 6) >> 4) & 0x3ffc0ff;
+    r[3] = (load32(key + 9) >> 6) & 0x3f03fff;
+    r[4] = (load32(key + 12) >> 8) & 0x00fffff;
+
+    for (int i = 0;i < 5;i++)
+        h[i] = 0;
+
+    for (int i = 0;i < 4;i++)
+        pad[i] = load32(key + 16 + i * 4);
+}
+
+void Poly1305::blocks(const uint8_t *m, size_t len)
+{
+    const uint32_t hibit = final? 0 : (1UL << 24);
+    const uint32_t r0 = r[0], r1 = r[1], r2 = r[2], r3 = r[3], r4 = r[4];
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = h[0], h1 = h[1], h2 = h[2], h3 = h[3], h4 = h[4];
+
+    while (len >= 16)
+    {
+        h0 += (load32(m + 0)) & 0x3ffffff;
+        h1 += (load32(m + 3) >> 2) & 0x3ffffff;
+        h2 += (load32(m + 6) >> 4) & 0x3ffffff;
+        h3 += (load32(m + 9) >> 6) & 0x3ffffff;
+        h4 += (load32(m + 12) >> 8) | hibit;
+
+        uint64_t d0 = static_cast<uint64_t>(h0) * r0 + static_cast<uint64_t>(h1) * s4 +
+                      static_cast<uint64_t>(h2) * s3 + static_cast<uint64_t>(h3) * s2 +
+                      static_cast<uint64_t>(h4) * s1;
+        uint64_t d1 = static_cast<uint64_t>(h0) * r1 + static_cast<uint64_t>(h1) * r0 +
+                      static_cast<uint64_t>(h2) * s4 + static_cast<uint64_t>(h3) * s3 +
+                      static_cast<uint64_t>(h4) * s2;
+        uint64_t d2 = static_cast<uint64_t>(h0) * r2 + static_cast<uint64_t>(h1) * r1 +
+                      static_cast<uint64_t>(h2) * r0 + static_cast<uint64_t>(h3) * s4 +
+                      static_cast<uint64_t>(h4) * s3;
+        uint64_t d3 = static_cast<uint64_t>(h0) * r3 + static_cast<uint64_t>(h1) * r2 +
+                      static_cast<uint64_t>(h2) * r1 + static_cast<uint64_t>(h3) * r0 +
+                      static_cast<uint64_t>(h4) * s4;
+        uint64_t d4 = static_cast<uint64_t>(h0) * r4 + static_cast<uint64_t>(h1) * r3 +
+                      static_cast<uint64_t>(h2) * r2 + static_cast<uint64_t>(h3) * r1 +
+                      static_cast<uint64_t>(h4) * r0;
+
+        uint32_t c;
+        c = static_cast<uint32_t>(d0 >> 26); h0 = static_cast<uint32_t>(d0) & 0x3ffffff;
+        d1 += c; c = static_cast<uint32_t>(d1 >> 26); h1 = static_cast<uint32_t>(d1) & 0x3ffffff;
+        d2 += c; c = static_cast<uint32_t>(d2 >> 26); h2 = static_cast<uint32_t>(d2) & 0x3ffffff;
+        d3 += c; c = static_cast<uint32_t>(d3 >> 26); h3 = static_cast<uint32_t>(d3) & 0x3ffffff;
+        d4 += c; c = static_cast<uint32_t>(d4 >> 26); h4 = static_cast<uint32_t>(d4) & 0x3ffffff;
+        h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+        h1 += c;
+
+        m += 16;
+        len -= 16;
+    }
+
+    h[0] = h0; h[1] = h1; h[2] = h2; h[3] = h3; h[4] = h4;
+}
+
+void Poly1305::update(const uint8_t *m, size_t len)
+{
+    if (leftover)
+    {
+        size_t want = 16 - leftover;
+        if (want > len)
+            want = len;
+        memcpy(buffer + leftover, m, want);
+        len -= want;
+        m += want;
+        leftover += want;
+        if (leftover < 16)
+            return;
+        blocks(buffer, 16);
+        leftover = 0;
+    }
+
+    if (len >= 16)
+    {
+        size_t want = len & ~static_cast<size_t>(15);
+        blocks(m, want);
+        m += want;
+        len -= want;
+    }
+
+    if (len)
+    {
+        memcpy(buffer, m, len);
+        leftover = len;
+    }
+}
+
+void Poly1305::finish(uint8_t mac[TAG_SIZE])
+{
+    if (leftover)
+    {
+        buffer[leftover++] = 1;
+        while (leftover < 16)
+            buffer[leftover++] = 0;
+        final = true;
+        blocks(buffer, 16);
+    }
+
+    uint32_t h0 = h[0], h1 = h[1], h2 = h[2], h3 = h[3], h4 = h[4];
+    uint32_t c;
+
+    //fully carry h
+    c = h1 >> 26; h1 &= 0x3ffffff;
+    h2 += c; c = h2 >> 26; h2 &= 0x3ffffff;
+    h3 += c; c = h3 >> 26; h3 &= 0x3ffffff;
+    h4 += c; c = h4 >> 26; h4 &= 0x3ffffff;
+    h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+    h1 += c;
+
+    //compute h - p
+    uint32_t g0 = h0 + 5; c = g0 >> 26; g0 &= 0x3ffffff;
+    uint32_t g1 = h1 + c; c = g1 >> 26; g1 &= 0x3ffffff;
+    uint32_t g2 = h2 + c; c = g2 >> 26; g2 &= 0x3ffffff;
+    uint32_t g3 = h3 + c; c = g3 >> 26; g3 &= 0x3ffffff;
+    uint32_t g4 = h4 + c - (1UL << 26);
+
+    //select h if h < p, or h - p if h >= p
+    uint32_t mask = (g4 >> 31) - 1;
+    g0 &= mask; g1 &= mask; g2 &= mask; g3 &= mask; g4 &= mask;
+    mask = ~mask;
+    h0 = (h0 & mask) | g0;
+    h1 = (h1 & mask) | g1;
+    h2 = (h2 & mask) | g2;
+    h3 = (h3 & mask) | g3;
+    h4 = (h4 & mask) | g4;
+
+    //h = h % 2^128
+    h0 = (h0 | (h1 << 26)) & 0xffffffff;
+    h1 = ((h1 >> 6) | (h2 << 20)) & 0xffffffff;
+    h2 = ((h2 >> 12) | (h3 << 14)) & 0xffffffff;
+    h3 = ((h3 >> 18) | (h4 << 8)) & 0xffffffff;
+
+    //mac = (h + pad) % 2^128
+    uint64_t f;
+    f = static_cast<uint64_t>(h0) + pad[0]; h0 = static_cast<uint32_t>(f);
+    f = static_cast<uint64_t>(h1) + pad[1] + (f >> 32); h1 = static_cast<uint32_t>(f);
+    f = static_cast<uint64_t>(h2) + pad[2] + (f >> 32); h2 = static_cast<uint32_t>(f);
+    f = static_cast<uint64_t>(h3) + pad[3] + (f >> 32); h3 = static_cast<uint32_t>(f);
+
+    store32(mac + 0, h0);
+    store32(mac + 4, h1);
+    store32(mac + 8, h2);
+    store32(mac + 12, h3);
+
+    //wipe the key
+    memset(r, 0, sizeof(r));
+    memset(pad, 0, sizeof(pad));
+}
+
+static void computeTag(const uint8_t key[KEY_SIZE], const uint8_t nonce[NONCE_SIZE],
+                       const uint8_t *aad, size_t aadLen,
+                       const uint8_t *cipher, size_t len,
+                       uint8_t tag[TAG_SIZE])
+{
+    static const uint8_t zeros[16] = { 0 };
+
+    uint8_t otk[64] = { 0 };
+    chacha20Xor(key, nonce, 0, otk, otk, sizeof(otk));
+
+    Poly1305 poly(otk);
+    poly.update(aad, aadLen);
+    if (aadLen % 16)
+        poly.update(zeros, 16 - aadLen % 16);
+    poly.update(cipher, len);
+    if (len % 16)
+        poly.update(zeros, 16 - len % 16);
+
+    uint8_t lengths[16];
+    store64(lengths, aadLen);
+    store64(lengths + 8, len);
+    poly.update(lengths, sizeof(lengths));
+    poly.finish(tag);
+
+    memset(otk, 0, sizeof(otk));
+}
+
+void seal(const uint8_t key[KEY_SIZE], const uint8_t nonce[NONCE_SIZE],
+          const uint8_t *aad, size_t aadLen,
+          const uint8_t *in, size_t len,
+          uint8_t *out)
+{
+    chacha20Xor(key, nonce, 1, in, out, len);
+    computeTag(key, nonce, aad, aadLen, out, len, out + len);
+}
+
+bool open(const uint8_t key[KEY_SIZE], const uint8_t nonce[NONCE_SIZE],
+          const uint8_t *aad, size_t aadLen,
+          const uint8_t *in, size_t len,
+          uint8_t *out)
+{
+    uint8_t tag[TAG_SIZE];
+    computeTag(key, nonce, aad, aadLen, in, len, tag);
+
+    //constant time compare
+    uint8_t diff = 0;
+    for (size_t i = 0;i < TAG_SIZE;i++)
+        diff |= tag[i] ^ in[len + i];
+    if (diff != 0)
+        return false;
+
+    chacha20Xor(key, nonce, 1, in, out, len);
+    return true;
+}
+
+}
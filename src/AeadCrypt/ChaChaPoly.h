@@ -0,0 +1,79 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#ifndef CHACHAPOLY_H
+#define CHACHAPOLY_H
+
+#include <cstddef>
+#include <cstdint>
+
+/* ChaCha20-Poly1305 AEAD (RFC 8439), portable implementation.
+ *
+ * Self contained, no dependency on Qt. The ChaCha20 keystream is generated
+ * four blocks at a time with the state laid out as 4 independent lanes so
+ * the compiler can map the rounds to SIMD registers. Poly1305 uses 26 bits
+ * limbs (poly1305-donna 32 bits).
+ */
+
+namespace ChaChaPoly
+{
+
+static const size_t KEY_SIZE = 32;
+static const size_t NONCE_SIZE = 12;
+static const size_t TAG_SIZE = 16;
+
+/* XOR len bytes of in with the ChaCha20 keystream starting at block counter,
+ * in and out may be the same buffer */
+void chacha20Xor(const uint8_t key[KEY_SIZE], const uint8_t nonce[NONCE_SIZE],
+                 uint32_t counter, const uint8_t *in, uint8_t *out, size_t len);
+
+class Poly1305
+{
+public:
+    explicit Poly1305(const uint8_t key[32]);
+
+    void update(const uint8_t *m, size_t len);
+    void finish(uint8_t mac[TAG_SIZE]);
+
+private:
+    void blocks(const uint8_t *m, size_t len);
+
+    uint32_t r[5];
+    uint32_t h[5];
+    uint32_t pad[4];
+    size_t leftover = 0;
+    uint8_t buffer[16];
+    bool final = false;
+};
+
+/* out receives len bytes of ciphertext followed by the tag */
+void seal(const uint8_t key[KEY_SIZE], const uint8_t nonce[NONCE_SIZE],
+          const uint8_t *aad, size_t aadLen,
+          const uint8_t *in, size_t len,
+          uint8_t *out);
+
+/* in is len bytes of ciphertext followed by the tag. Returns false, and
+ * leaves out untouched, when authentication fails */
+bool open(const uint8_t key[KEY_SIZE], const uint8_t nonce[NONCE_SIZE],
+          const uint8_t *aad, size_t aadLen,
+          const uint8_t *in, size_t len,
+          uint8_t *out);
+
+}
+
+#endif // CHACHAPOLY_H
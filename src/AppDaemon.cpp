@@ -20,6 +20,7 @@
 #include "HttpServer.h"
 #include "Common.h"
 #include "version.h"
+#include "SocketActivation.h"
 
 #ifdef Q_OS_MAC
 #include "MacUtils.h"
@@ -86,6 +87,8 @@ bool AppDaemon::initialize()
         return false;
     }
 
+    Common::markStartupPhase("shared_memory");
+
     QCommandLineParser parser;
 
     parser.setApplicationDescription("Moolticute Daemon");
@@ -108,8 +111,27 @@ bool AppDaemon::initialize()
                                        QCoreApplication::translate("main", "port"));
     parser.addOption(debugHttpServer);
 
+    QCommandLineOption logRulesOption(QStringList() << "l" << "log-rules",
+                                      QCoreApplication::translate("main", "Logging filter rules separated by ';', ie. \"moolticute.device.packet.debug=false;moolticute.device.node.debug=false\"."),
+                                      QCoreApplication::translate("main", "rules"));
+    parser.addOption(logRulesOption);
+
+    QCommandLineOption lazyOption(QStringList() << "lazy",
+                                  QCoreApplication::translate("main", "Start USB monitoring only when a client connects or a device appears. This is the default when started by systemd socket activation."));
+    parser.addOption(lazyOption);
+
+    QCommandLineOption idleTimeoutOption(QStringList() << "idle-timeout",
+                                         QCoreApplication::translate("main", "Exit after this many seconds without any client or device. 0 (default) never exits."),
+                                         QCoreApplication::translate("main", "seconds"));
+    parser.addOption(idleTimeoutOption);
+
     parser.process(qApp->arguments());
 
+    if (parser.isSet(logRulesOption))
+        QLoggingCategory::setFilterRules(parser.value(logRulesOption).replace(';', '\n'));
+
+    Common::markStartupPhase("command_line");
+
     emulationMode = parser.isSet(emulMode);
 
 #ifdef Q_OS_MAC
@@ -135,15 +157,105 @@ bool AppDaemon::initialize()
         return false;
     }
 
-    QTimer::singleShot(500, []()
+    Common::markStartupPhase("websocket_server");
+
+    int idleTimeout = parser.value(idleTimeoutOption).toInt();
+    if (idleTimeout > 0)
     {
-        if (!MPManager::Instance()->initialize())
-            qCritical() << "USBManager Fatal error";
-    });
+        idleTimer = new QTimer(this);
+        idleTimer->setSingleShot(true);
+        idleTimer->setInterval(idleTimeout * 1000);
+        connect(idleTimer, &QTimer::timeout, [=]()
+        {
+            qInfo() << "No client or device for" << idleTimeout << "s, exiting";
+            quit();
+        });
+    }
+
+    //Queued, client and device lists are updated after the signals
+    connect(WSServer::Instance(), &WSServer::clientsChanged, this, &AppDaemon::clientsChanged, Qt::QueuedConnection);
+    connect(MPManager::Instance(), &MPManager::mpConnected, this, &AppDaemon::checkIdle, Qt::QueuedConnection);
+    connect(MPManager::Instance(), &MPManager::mpDisconnected, this, &AppDaemon::checkIdle, Qt::QueuedConnection);
+
+    if (parser.isSet(lazyOption) || SocketActivation::isActivated())
+    {
+        qInfo() << "Startup: device discovery waits for a client or a device";
+        watchDevices();
+    }
+    else
+    {
+        //Start USB discovery as soon as the event loop runs
+        QTimer::singleShot(0, this, [=]() { startDevices(); });
+    }
+
+    checkIdle();
 
     return true;
 }
 
+void AppDaemon::watchDevices()
+{
+#ifdef Q_OS_LINUX
+    //inotify on /dev costs nothing while no node is added, the USB monitor
+    //is only started once a new hidraw node shows up
+    devWatcher = new QFileSystemWatcher(QStringList() << "/dev", this);
+    hidrawNodes = QDir("/dev").entryList(QStringList() << "hidraw*", QDir::System);
+    connect(devWatcher, &QFileSystemWatcher::directoryChanged, [=]()
+    {
+        QStringList nodes = QDir("/dev").entryList(QStringList() << "hidraw*", QDir::System);
+        for (const QString &n: qAsConst(nodes))
+        {
+            if (!hidrawNodes.contains(n))
+            {
+                qInfo() << "New HID device" << n;
+                startDevices();
+                return;
+            }
+        }
+        hidrawNodes = nodes;
+    });
+#endif
+}
+
+void AppDaemon::startDevices()
+{
+    if (devicesStarted)
+        return;
+    devicesStarted = true;
+
+    if (devWatcher)
+    {
+        devWatcher->deleteLater();
+        devWatcher = nullptr;
+    }
+
+    if (!MPManager::Instance()->initialize())
+        qCritical() << "USBManager Fatal error";
+    Common::markStartupPhase("device_discovery");
+}
+
+void AppDaemon::clientsChanged()
+{
+    if (WSServer::Instance()->getClientCount() > 0)
+        startDevices();
+    checkIdle();
+}
+
+void AppDaemon::checkIdle()
+{
+    if (!idleTimer)
+        return;
+
+    if (WSServer::Instance()->getClientCount() == 0 &&
+        MPManager::Instance()->getDeviceCount() == 0)
+    {
+        if (!idleTimer->isActive())
+            idleTimer->start();
+    }
+    else
+        idleTimer->stop();
+}
+
 AppDaemon::~AppDaemon()
 {
     MPManager::Instance()->stop();
@@ -22,6 +22,7 @@
 #include <QObject>
 #include <QSettings>
 #include <QLocalServer>
+#include <QFileSystemWatcher>
 
 #if defined(Q_OS_MAC) || defined(Q_OS_WIN)
 #include <QApplication>
@@ -48,9 +49,24 @@ public:
     static bool isEmulationMode();
     static QHostAddress getListenAddress();
 
+private slots:
+    void clientsChanged();
+    void checkIdle();
+
 private:
+    void watchDevices();
+    void startDevices();
+
     HttpServer *httpServer = nullptr;
 
+    //Lazy mode: USB monitoring starts with the first client or device
+    bool devicesStarted = false;
+    QFileSystemWatcher *devWatcher = nullptr;
+    QStringList hidrawNodes;
+
+    //Exits the daemon when no client and no device are left
+    QTimer *idleTimer = nullptr;
+
     //This is for communication between app/daemon
     QSharedMemory sharedMem;
 
@@ -21,6 +21,8 @@
 #include "QSimpleUpdater.h"
 #include "DbMasterController.h"
 #include "PromptWidget.h"
+#include "PasswordStrengthScorer.h"
+#include "IpcSocket.h"
 #include "SystemNotifications/SystemNotification.h"
 
 #ifdef Q_OS_WIN
@@ -181,6 +183,10 @@ bool AppGui::initialize()
     });
 
     connect(wsClient, &WSClient::displayStatusWarning, this, &AppGui::displayStatusWarningNotification);
+    //Daemon presence follows the client connection, its exit is seen
+    //right away and WSClient reconnects by itself
+    connect(wsClient, &WSClient::wsConnected, [this]() { setDaemonFound(true); });
+    connect(wsClient, &WSClient::wsDisconnected, [this]() { setDaemonFound(false); });
 
     connectedChanged();
 
@@ -232,21 +238,14 @@ bool AppGui::initialize()
         dRunning = true;
     });
 
-    //search for a potential daemon already running
-    searchDaemonTick();
-
     //only start daemon if none are found
-    if (!foundDaemon)
+    if (!isDaemonRunning())
         daemonProcess->start(program, arguments);
 
 #ifdef Q_OS_WIN
     connect(daemonAction, &DaemonMenuAction::restartClicked, this, &AppGui::restartDaemon);
 #endif
 
-    timerDaemon = new QTimer(this);
-    connect(timerDaemon, SIGNAL(timeout()), SLOT(searchDaemonTick()));
-    timerDaemon->start(800);
-
     startSSHAgent();
 
     connect(QSimpleUpdater::getInstance(), &QSimpleUpdater::updateAvailable, this, &AppGui::updateAvailableReceived);
@@ -386,9 +385,6 @@ void AppGui::updateSystrayTooltip()
 
 AppGui::~AppGui()
 {
-    if (timerDaemon)
-        timerDaemon->stop();
-
 #ifndef Q_OS_WIN
     if (sshAgentProcess)
     {
@@ -464,27 +460,41 @@ void AppGui::disableDaemon()
 #endif
 }
 
-void AppGui::searchDaemonTick()
+bool AppGui::isDaemonRunning()
 {
-    //Search for the daemon from the shared mem segment
-    bool search = false;
+    if (wsClient->isConnected())
+        return true;
+
+    //A listening local socket means a daemon is running, or that systemd
+    //will start one for us
+    QLocalSocket probe;
+    probe.connectToServer(IpcSocket::daemonSocketName());
+    if (probe.waitForConnected(500))
+    {
+        probe.abort();
+        return true;
+    }
 
+    //Daemons without the local socket are found from the shared mem segment
+    bool running = false;
     if (sharedMem.attach())
     {
         QJsonObject obj = Common::readSharedMemory(sharedMem);
 
         //PID is stored as string to prevent double conversion in json
         qint64 pid = obj["daemon_pid"].toString().toLongLong();
-
-        if (Common::isProcessRunning(pid))
-            search = true;
+        running = Common::isProcessRunning(pid);
 
         sharedMem.detach();
     }
+    return running;
+}
 
-    if (search == foundDaemon)
+void AppGui::setDaemonFound(bool found)
+{
+    if (found == foundDaemon)
         return;
-    foundDaemon = search;
+    foundDaemon = found;
 
 #ifndef Q_OS_WIN
     restartDaemonAction->setEnabled(foundDaemon && !needRestart);
@@ -502,12 +512,6 @@ void AppGui::searchDaemonTick()
 #endif
     if (foundDaemon)
     {
-        //Force reopen connection, this prevents waiting for a timeout
-        //before retrying the connection. On macOS the timeout being too long
-        //the gui waits too much before reconnecting
-        wsClient->closeWebsocket();
-        wsClient->openWebsocket();
-
         delete logSocket;
         logSocket = new QLocalSocket(this);
         logSocket->connectToServer(MOOLTICUTE_DAEMON_LOG_SOCK);
@@ -584,16 +588,13 @@ void AppGui::slotConnectionEstablished()
 
 void AppGui::daemonLogRead()
 {
-    while (logSocket->canReadLine())
-    {
-        logBuffer.append(logSocket->readLine());
+    //Forward everything available at once, the log window splits lines itself
+    logBuffer.append(logSocket->readAll());
 
-        if (win)
-        {
-            win->daemonLogAppend(logBuffer);
-            logBuffer.clear();
-        }
-        //qDebug() << QString::fromUtf8(out);
+    if (win)
+    {
+        win->daemonLogAppend(logBuffer);
+        logBuffer.clear();
     }
 }
 
@@ -663,6 +664,12 @@ QtAwesome *AppGui::qtAwesome()
     return a;
 }
 
+PasswordStrengthScorer *AppGui::passwordStrengthScorer()
+{
+    static PasswordStrengthScorer *s = new PasswordStrengthScorer(qApp);
+    return s;
+}
+
 void AppGui::restartDaemon()
 {
     //We don't have control over daemon process, cannot restart it
@@ -33,6 +33,7 @@
 #include <QtAwesome.h>
 
 class DbMasterController;
+class PasswordStrengthScorer;
 class AppGui : public QApplication
 {
     Q_OBJECT
@@ -49,6 +50,7 @@ public:
     void setupLanguage();
 
     static QtAwesome *qtAwesome();
+    static PasswordStrengthScorer *passwordStrengthScorer();
 
     void checkUpdate(bool displayMessage);
 
@@ -58,13 +60,15 @@ private slots:
     void restartDaemon();
     void connectedChanged();
     void updateSystrayTooltip();
-    void searchDaemonTick();
+    void setDaemonFound(bool found);
     void slotConnectionEstablished();
     void daemonLogRead();
     void updateAvailableReceived(QString version, QString changesetURL);
     void displayStatusWarningNotification();
 
 private:
+     bool isDaemonRunning();
+
      MainWindow *win = nullptr;
      QSystemTrayIcon *systray = nullptr;
      WSClient *wsClient = nullptr;
@@ -85,7 +89,6 @@ private:
 
      //This is for communication between app/daemon
      QSharedMemory sharedMem;
-     QTimer *timerDaemon = nullptr;
 
      //local server for single instance of the app
      QLocalServer *localServer = nullptr;
@@ -128,6 +128,9 @@ void AsyncJobs::jobDone(const QByteArray &data)
 {
     disconnect(currentJob, SIGNAL(done(QByteArray)), this, SLOT(jobDone(QByteArray)));
     disconnect(currentJob, SIGNAL(error()), this, SLOT(jobFailed()));
+    //Long job lists (bundle upload, ...) would otherwise keep every job until the end
+    currentJob->deleteLater();
+    currentJob = nullptr;
     dequeueStartJob(data);
 }
 
@@ -0,0 +1,295 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#include "AsyncLogger.h"
+#include "version.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef Q_OS_WIN_DISABLE_FOR_NOW
+#define COLOR_RED
+#define COLOR_GREEN
+#define COLOR_YELLOW
+#define COLOR_ORANGE
+#define COLOR_CYAN
+#define COLOR_RESET
+#else
+#define COLOR_RED       "\033[31m"
+#define COLOR_GREEN     "\033[32;1m"
+#define COLOR_YELLOW    "\033[33;1m"
+#define COLOR_ORANGE    "\033[0;33m"
+#define COLOR_CYAN      "\033[36m"
+#define COLOR_RESET     "\033[0m"
+#endif
+
+static qint64 steadyMsecs()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+LogRingBuffer::LogRingBuffer(int capacityPow2):
+    cells(new Cell[capacityPow2]),
+    mask(static_cast<size_t>(capacityPow2) - 1),
+    enqueuePos(0),
+    dequeuePos(0)
+{
+    Q_ASSERT(capacityPow2 >= 2 && (capacityPow2 & (capacityPow2 - 1)) == 0);
+    for (size_t i = 0;i <= mask;i++)
+        cells[i].seq.store(i, std::memory_order_relaxed);
+}
+
+LogRingBuffer::~LogRingBuffer()
+{
+    delete [] cells;
+}
+
+bool LogRingBuffer::push(LogEntry &&entry)
+{
+    Cell *cell;
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    forever
+    {
+        cell = &cells[pos & mask];
+        size_t seq = cell->seq.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+            return false; //full
+        else
+            pos = enqueuePos.load(std::memory_order_relaxed);
+    }
+
+    cell->entry = std::move(entry);
+    cell->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool LogRingBuffer::pop(LogEntry &entry)
+{
+    //Single consumer: only the writer thread pops
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Cell *cell = &cells[pos & mask];
+    size_t seq = cell->seq.load(std::memory_order_acquire);
+    if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) != 0)
+        return false;
+
+    dequeuePos.store(pos + 1, std::memory_order_relaxed);
+    entry = std::move(cell->entry);
+    cell->entry = LogEntry();
+    cell->seq.store(pos + mask + 1, std::memory_order_release);
+    return true;
+}
+
+bool LogRingBuffer::isEmpty() const
+{
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    const Cell *cell = &cells[pos & mask];
+    return cell->seq.load(std::memory_order_acquire) != pos + 1;
+}
+
+AsyncLogger::AsyncLogger(QObject *parent):
+    QThread(parent),
+    ring(RING_SIZE),
+    writerSleeping(false),
+    stopping(false),
+    rateWindowStart(steadyMsecs()),
+    rateWindowCount(0),
+    droppedFull(0),
+    droppedRate(0)
+{
+    //In release, do not display qDebug messages from GUI
+    guiDebugEnabled = QStringLiteral(APP_VERSION) == "git";
+    setObjectName("AsyncLogger");
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    stop();
+}
+
+QString AsyncLogger::formatMessage(QtMsgType type, const char *file, int line, const QString &msg)
+{
+    QString fname = file;
+    fname = fname.section('\\', -1, -1);
+
+    switch (type) {
+    default:
+    case QtDebugMsg:
+        return QString(COLOR_CYAN "DEBUG" COLOR_RESET ": %1:%2 - %3\n").arg(fname).arg(line).arg(msg);
+    case QtInfoMsg:
+        return QString(COLOR_GREEN "INFO" COLOR_RESET ": %1:%2 - %3\n").arg(fname).arg(line).arg(msg);
+    case QtWarningMsg:
+        return QString(COLOR_YELLOW "WARNING" COLOR_RESET ": %1:%2 - %3\n").arg(fname).arg(line).arg(msg);
+    case QtCriticalMsg:
+        return QString(COLOR_ORANGE "CRITICAL" COLOR_RESET ": %1:%2 - %3\n").arg(fname).arg(line).arg(msg);
+    case QtFatalMsg:
+        return QString(COLOR_RED "FATAL" COLOR_RESET ": %1:%2 - %3\n").arg(fname).arg(line).arg(msg);
+    }
+}
+
+void AsyncLogger::log(QtMsgType type, const QMessageLogContext &context, const QString &msg)
+{
+    if (stopping.load(std::memory_order_acquire))
+    {
+        //Writer is gone (application shutdown), write directly
+        QString s = formatMessage(type, context.file, context.line, msg);
+        printf("%s", qPrintable(s));
+        fflush(stdout);
+        return;
+    }
+
+    if (!allowByRate(type))
+    {
+        droppedRate.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    LogEntry e;
+    e.type = type;
+    //context.file is not guaranteed to outlive this call, keep a copy of the basename
+    if (context.file)
+    {
+        const char *base = strrchr(context.file, '\\');
+        e.file = base? base + 1 : context.file;
+    }
+    e.line = context.line;
+    e.msg = msg;
+
+    if (!ring.push(std::move(e)))
+    {
+        droppedFull.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    wakeWriter();
+}
+
+bool AsyncLogger::allowByRate(QtMsgType type)
+{
+    if (type != QtDebugMsg && type != QtInfoMsg)
+        return true;
+
+    qint64 now = steadyMsecs();
+    qint64 start = rateWindowStart.load(std::memory_order_relaxed);
+    if (now - start >= 1000 &&
+        rateWindowStart.compare_exchange_strong(start, now, std::memory_order_relaxed))
+        rateWindowCount.store(0, std::memory_order_relaxed);
+
+    return rateWindowCount.fetch_add(1, std::memory_order_relaxed) < RATE_LIMIT_PER_SEC;
+}
+
+void AsyncLogger::wakeWriter()
+{
+    //Only post to the semaphore when the writer is actually waiting on it.
+    //Pairs with the fence in run(): either the writer sees the pushed entry
+    //or we see writerSleeping set, a wakeup cannot be lost.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writerSleeping.exchange(false, std::memory_order_seq_cst))
+        wakeup.release();
+}
+
+void AsyncLogger::stop()
+{
+    if (stopping.exchange(true))
+        return;
+
+    if (isRunning())
+    {
+        writerSleeping.store(false);
+        wakeup.release();
+        wait();
+    }
+}
+
+void AsyncLogger::run()
+{
+    forever
+    {
+        while (!ring.isEmpty())
+            writeBatch();
+
+        if (stopping.load(std::memory_order_acquire))
+        {
+            //Pick up anything pushed while we were stopping
+            while (!ring.isEmpty())
+                writeBatch();
+            writeBatch();
+            return;
+        }
+
+        writerSleeping.store(true, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ring.isEmpty())
+        {
+            writerSleeping.store(false, std::memory_order_release);
+            continue;
+        }
+
+        //Wake up once in a while to report dropped messages even if nothing is logged
+        if (!wakeup.tryAcquire(1, 1000))
+        {
+            writerSleeping.store(false, std::memory_order_release);
+            writeBatch();
+        }
+    }
+}
+
+void AsyncLogger::writeBatch()
+{
+    QByteArray out;
+    QByteArray localOut;
+    QByteArray guiOut;
+
+    LogEntry e;
+    for (int i = 0;i < MAX_BATCH_SIZE && ring.pop(e);i++)
+    {
+        QString s = formatMessage(e.type, e.file.constData(), e.line, e.msg);
+        QByteArray u = s.toUtf8();
+        out.append(u);
+        localOut.append(s.toLocal8Bit());
+        if (guiDebugEnabled || e.type != QtDebugMsg)
+            guiOut.append(u);
+    }
+
+    quint64 full = droppedFull.exchange(0, std::memory_order_relaxed);
+    quint64 rate = droppedRate.exchange(0, std::memory_order_relaxed);
+    if (full || rate)
+    {
+        QString s = formatMessage(QtWarningMsg, __FILE__, __LINE__,
+                                  QStringLiteral("%1 log messages dropped (%2 rate limited, %3 buffer full)")
+                                  .arg(full + rate).arg(rate).arg(full));
+        QByteArray u = s.toUtf8();
+        out.append(u);
+        localOut.append(s.toLocal8Bit());
+        guiOut.append(u);
+    }
+
+    if (out.isEmpty())
+        return;
+
+    fwrite(localOut.constData(), 1, static_cast<size_t>(localOut.size()), stdout);
+    fflush(stdout);
+
+    emit batchReady(out, guiOut);
+}
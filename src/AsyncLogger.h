@@ -0,0 +1,116 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#ifndef ASYNCLOGGER_H
+#define ASYNCLOGGER_H
+
+#include <QtCore>
+#include <atomic>
+#include <cstdint>
+
+struct LogEntry
+{
+    QtMsgType type = QtDebugMsg;
+    QByteArray file;
+    int line = 0;
+    QString msg;
+};
+
+/* Bounded multi-producer/single-consumer queue. Producers never block:
+ * when the ring is full the entry is rejected and the caller counts
+ * it as dropped.
+ */
+class LogRingBuffer
+{
+public:
+    explicit LogRingBuffer(int capacityPow2);
+    ~LogRingBuffer();
+
+    bool push(LogEntry &&entry);
+    bool pop(LogEntry &entry);
+    bool isEmpty() const;
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> seq;
+        LogEntry entry;
+    };
+
+    Cell *cells;
+    size_t mask;
+    std::atomic<size_t> enqueuePos;
+    std::atomic<size_t> dequeuePos;
+};
+
+/* Receives messages from the Qt message handler on any thread and formats
+ * and writes them from a background thread. Output to log sockets and to
+ * the GUI callback is handed back to the thread owning the logger in
+ * batches, because QLocalSocket can only be used from its own thread.
+ */
+class AsyncLogger: public QThread
+{
+    Q_OBJECT
+public:
+    static const int RING_SIZE = 8192;
+    //debug/info messages allowed per second, warnings and above are never limited
+    static const int RATE_LIMIT_PER_SEC = 2000;
+    static const int MAX_BATCH_SIZE = 256;
+
+    explicit AsyncLogger(QObject *parent = nullptr);
+    virtual ~AsyncLogger();
+
+    //Called from the message handler, never blocks
+    void log(QtMsgType type, const QMessageLogContext &context, const QString &msg);
+
+    //Drain everything queued and stop the writer thread
+    void stop();
+
+    static QString formatMessage(QtMsgType type, const char *file, int line, const QString &msg);
+
+    //Messages dropped since the last batch, reported by the writer thread
+    quint64 getDroppedFull() const { return droppedFull.load(std::memory_order_relaxed); }
+    quint64 getDroppedRate() const { return droppedRate.load(std::memory_order_relaxed); }
+
+signals:
+    //Emitted from the writer thread, delivered queued to the logger's thread
+    void batchReady(const QByteArray &data, const QByteArray &guiData);
+
+protected:
+    virtual void run() override;
+
+private:
+    bool allowByRate(QtMsgType type);
+    void wakeWriter();
+    void writeBatch();
+
+    LogRingBuffer ring;
+    QSemaphore wakeup;
+    std::atomic<bool> writerSleeping;
+    std::atomic<bool> stopping;
+
+    std::atomic<qint64> rateWindowStart;
+    std::atomic<int> rateWindowCount;
+
+    std::atomic<quint64> droppedFull;
+    std::atomic<quint64> droppedRate;
+
+    bool guiDebugEnabled;
+};
+
+#endif // ASYNCLOGGER_H
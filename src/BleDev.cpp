@@ -25,6 +25,7 @@ BleDev::BleDev(QWidget *parent) :
     ui->btnFileBrowser->setIcon(AppGui::qtAwesome()->icon(fa::file, whiteButtons));
     ui->btnFetchDataBrowse->setIcon(AppGui::qtAwesome()->icon(fa::file, whiteButtons));
     ui->progressBarFetchData->setVisible(false);
+    ui->label_FetchDataStats->setVisible(false);
     ui->horizontalLayout_Fetch->setAlignment(Qt::AlignLeft);
     ui->progressBarFetchData->setMinimum(0);
     ui->progressBarFetchData->setMaximum(0);
@@ -45,6 +46,7 @@ void BleDev::setWsClient(WSClient *c)
     wsClient = c;
     connect(wsClient, &WSClient::displayDebugPlatInfo, this, &BleDev::displayDebugPlatInfoReceived);
     connect(wsClient, &WSClient::displayUploadBundleResult, this, &BleDev::displayUploadBundleResultReceived);
+    connect(wsClient, &WSClient::fetchDataStats, this, &BleDev::fetchDataStatsReceived);
 }
 
 void BleDev::clearWidgets()
@@ -97,6 +99,8 @@ void BleDev::fetchData(const Common::FetchType &fetchType)
     if (Common::FetchState::STOPPED == fetchState)
     {
         ui->progressBarFetchData->show();
+        ui->label_FetchDataStats->clear();
+        ui->label_FetchDataStats->show();
         selectedButton->setText(tr("Stop Fetch"));
         inactiveButton->hide();
         fetchState = Common::FetchState::STARTED;
@@ -104,14 +108,30 @@ void BleDev::fetchData(const Common::FetchType &fetchType)
     }
     else
     {
-        ui->progressBarFetchData->hide();
-        selectedButton->setText(isAccFetch ? FETCH_ACC_DATA_TEXT : FETCH_RANDOM_DATA_TEXT);
-        inactiveButton->show();
-        fetchState = Common::FetchState::STOPPED;
+        resetFetchDataUi();
         wsClient->sendStopFetchData();
     }
 }
 
+void BleDev::resetFetchDataUi()
+{
+    ui->progressBarFetchData->hide();
+    ui->btnFetchAccData->setText(FETCH_ACC_DATA_TEXT);
+    ui->btnFetchAccData->show();
+    ui->btnFetchRandomData->setText(FETCH_RANDOM_DATA_TEXT);
+    ui->btnFetchRandomData->show();
+    fetchState = Common::FetchState::STOPPED;
+}
+
+void BleDev::fetchDataStatsReceived(qint64 bytes, qint64 bytesPerSec, bool finished)
+{
+    ui->label_FetchDataStats->setText(tr("%1 bytes fetched (%2 B/s)").arg(bytes).arg(bytesPerSec));
+
+    //Capture stopped by the daemon (duration or size limit reached)
+    if (finished && Common::FetchState::STARTED == fetchState)
+        resetFetchDataUi();
+}
+
 void BleDev::on_btnFileBrowser_clicked()
 {
     QSettings s;
@@ -42,9 +42,12 @@ private slots:
 
     void on_btnFetchRandomData_clicked();
 
+    void fetchDataStatsReceived(qint64 bytes, qint64 bytesPerSec, bool finished);
+
 private:
     void initUITexts();
     void fetchData(const Common::FetchType &fetchType);
+    void resetFetchDataUi();
 
     Ui::BleDev *ui;
     WSClient *wsClient = nullptr;
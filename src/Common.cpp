@@ -21,6 +21,7 @@
 #include <QLocalSocket>
 #include <time.h>
 #include "version.h"
+#include "AsyncLogger.h"
 #include <chrono>
 
 #ifndef Q_OS_WIN
@@ -35,34 +36,6 @@
 #include <qt_windows.h>
 #endif
 
-#ifdef Q_OS_WIN_DISABLE_FOR_NOW
-#define COLOR_LIGHTRED
-#define COLOR_RED
-#define COLOR_LIGHTBLUE
-#define COLOR_BLUE
-#define COLOR_GREEN
-#define COLOR_YELLOW
-#define COLOR_ORANGE
-#define COLOR_WHITE
-#define COLOR_LIGHTCYAN
-#define COLOR_CYAN
-#define COLOR_RESET
-#define COLOR_HIGH
-#else
-#define COLOR_LIGHTRED  "\033[31;1m"
-#define COLOR_RED       "\033[31m"
-#define COLOR_LIGHTBLUE "\033[34;1m"
-#define COLOR_BLUE      "\033[34m"
-#define COLOR_GREEN     "\033[32;1m"
-#define COLOR_YELLOW    "\033[33;1m"
-#define COLOR_ORANGE    "\033[0;33m"
-#define COLOR_WHITE     "\033[37;1m"
-#define COLOR_LIGHTCYAN "\033[36;1m"
-#define COLOR_CYAN      "\033[36m"
-#define COLOR_RESET     "\033[0m"
-#define COLOR_HIGH      "\033[1m"
-#endif
-
 QHash<Common::MPStatus, QString> Common::MPStatusUserString = {
     { Common::UnknownStatus, QObject::tr("Unknown status") },
     { Common::NoCardInserted, QObject::tr("No card inserted") },
@@ -106,62 +79,64 @@ Common::MPStatus Common::statusFromString(const QString &st)
 static QLocalServer *debugLogServer = nullptr;
 static QList<QLocalSocket *> debugLogClients;
 static Common::GuiLogCallback guiLogCallback = [](const QByteArray &) {};
+static AsyncLogger *asyncLogger = nullptr;
+
+//Socket clients that can't keep up get log batches skipped instead of
+//growing their write buffer forever
+#define LOG_CLIENT_MAX_BACKLOG  (1024 * 1024)
+static QHash<QLocalSocket *, qint64> debugLogClientsDropped;
+
+Q_LOGGING_CATEGORY(lcDevicePacket, "moolticute.device.packet")
+Q_LOGGING_CATEGORY(lcDeviceNode, "moolticute.device.node")
+Q_LOGGING_CATEGORY(lcWsMessage, "moolticute.ws.message", QtInfoMsg)
+
 static void _messageOutput(QtMsgType type, const QMessageLogContext &context, const QString &msg)
 {
-    QString fname = context.file;
-    fname = fname.section('\\', -1, -1);
-
-    QString s;
-    switch (type) {
-    default:
-    case QtDebugMsg:
+    if (asyncLogger && type != QtFatalMsg)
     {
-        s = QString(COLOR_CYAN "DEBUG" COLOR_RESET ": %1:%2 - %3\n").arg(fname).arg(context.line).arg(msg);
-        break;
-    }
-    case QtInfoMsg:
-    {
-        s = QString(COLOR_GREEN "INFO" COLOR_RESET ": %1:%2 - %3\n").arg(fname).arg(context.line).arg(msg);
-        break;
-    }
-    case QtWarningMsg:
-    {
-        s = QString(COLOR_YELLOW "WARNING" COLOR_RESET ": %1:%2 - %3\n").arg(fname).arg(context.line).arg(msg);
-        break;
-    }
-    case QtCriticalMsg:
-    {
-        s = QString(COLOR_ORANGE "CRITICAL" COLOR_RESET ": %1:%2 - %3\n").arg(fname).arg(context.line).arg(msg);
-        break;
-    }
-    case QtFatalMsg:
-    {
-        s = QString(COLOR_RED "FATAL" COLOR_RESET ": %1:%2 - %3\n").arg(fname).arg(context.line).arg(msg);
-        break;
-    }
+        asyncLogger->log(type, context, msg);
+        return;
     }
 
-    if (!s.isEmpty())
+    //Fatal messages abort the process right after we return,
+    //flush everything queued before writing it synchronously
+    if (asyncLogger)
+        asyncLogger->stop();
+
+    QString s = AsyncLogger::formatMessage(type, context.file, context.line, msg);
+    printf("%s", qPrintable(s));
+    fflush(stdout);
+}
+
+static void _writeLogBatch(const QByteArray &data, const QByteArray &guiData)
+{
+    if (!guiData.isEmpty())
+        guiLogCallback(guiData);
+
+    for (QLocalSocket *sock: qAsConst(debugLogClients))
     {
-        printf("%s", qPrintable(s));
-        fflush(stdout);
-
-        //In release, do not display qDebug messages from GUI
-        if (QStringLiteral(APP_VERSION) == "git" ||
-            type == QtFatalMsg ||
-            type == QtCriticalMsg ||
-            type == QtWarningMsg ||
-            type == QtInfoMsg)
-            guiLogCallback(s.toUtf8());
-
-        for (QLocalSocket *sock: debugLogClients)
+        if (sock->bytesToWrite() > LOG_CLIENT_MAX_BACKLOG)
         {
-            sock->write(s.toUtf8());
-            sock->flush();
+            debugLogClientsDropped[sock] += data.size();
+            continue;
         }
+
+        qint64 dropped = debugLogClientsDropped.take(sock);
+        if (dropped > 0)
+            sock->write(AsyncLogger::formatMessage(QtWarningMsg, __FILE__, __LINE__,
+                                                   QStringLiteral("%1 bytes of log dropped, client too slow").arg(dropped)).toUtf8());
+
+        //No flush(), the event loop writes the data as the socket drains
+        sock->write(data);
     }
 }
 
+static void _stopLogger()
+{
+    if (asyncLogger)
+        asyncLogger->stop();
+}
+
 void Common::installMessageOutputHandler(QLocalServer *logServer, GuiLogCallback guicb)
 {
     debugLogServer = logServer;
@@ -181,11 +156,23 @@ void Common::installMessageOutputHandler(QLocalServer *logServer, GuiLogCallback
             QObject::connect(s, &QLocalSocket::disconnected, [s]()
             {
                 debugLogClients.removeAll(s);
+                debugLogClientsDropped.remove(s);
                 s->deleteLater();
             });
         });
     }
     guiLogCallback = guicb;
+
+    if (!asyncLogger)
+    {
+        //Never deleted: other threads may still log while the application
+        //shuts down, a stopped logger writes synchronously instead
+        asyncLogger = new AsyncLogger();
+        QObject::connect(asyncLogger, &AsyncLogger::batchReady, asyncLogger, &_writeLogBatch, Qt::QueuedConnection);
+        asyncLogger->start(QThread::LowPriority);
+        qAddPostRoutine(_stopLogger);
+    }
+
     qInstallMessageHandler(_messageOutput);
 }
 
@@ -377,3 +364,29 @@ void Common::updateSeed(std::vector<qint64> &newInts)
 {
     mpRngIntegers = newInts;
 }
+
+//Started when the binary is loaded, close enough to the process start
+static QElapsedTimer startupElapsed = []()
+{
+    QElapsedTimer t;
+    t.start();
+    return t;
+}();
+static QJsonArray startupPhases;
+
+//Devices can be plugged many times, only keep the first phases
+#define STARTUP_PHASES_MAX      32
+
+void Common::markStartupPhase(const QString &phase)
+{
+    qint64 ms = startupElapsed.elapsed();
+    qInfo() << "Startup:" << phase << "after" << ms << "ms";
+
+    if (startupPhases.size() < STARTUP_PHASES_MAX)
+        startupPhases.append(QJsonObject{{ "phase", phase }, { "ms", ms }});
+}
+
+QJsonArray Common::getStartupPhases()
+{
+    return startupPhases;
+}
@@ -67,6 +67,19 @@
 
 #define MOOLTICUTE_DAEMON_LOG_SOCK    "moolticuted_local_log_sock"
 
+//Local socket used by the GUI to talk to the daemon without going through TCP
+#define MOOLTICUTE_DAEMON_IPC_SOCK    "moolticuted_local_ipc_sock"
+//Same socket when it is created by systemd/moolticuted.socket
+#define MOOLTICUTE_DAEMON_SYSTEMD_SOCK "/run/moolticuted.sock"
+
+//Logging categories for high volume device logs. Those can be turned off
+//with filter rules, ie. "moolticute.device.packet.debug=false"
+Q_DECLARE_LOGGING_CATEGORY(lcDevicePacket)
+Q_DECLARE_LOGGING_CATEGORY(lcDeviceNode)
+//Per message websocket logs, debug is off unless enabled with
+//"moolticute.ws.message.debug=true"
+Q_DECLARE_LOGGING_CATEGORY(lcWsMessage)
+
 #define BITMAP_ID_OFFSET        128
 #define ID_KEYB_EN_US_LUT       BITMAP_ID_OFFSET+18
 #define ID_KEYB_FR_FR_LUT       BITMAP_ID_OFFSET+19
@@ -161,6 +174,10 @@ public:
     static std::vector<qint64> getRngSeed();
     static void updateSeed(std::vector<qint64> &newInts);
 
+    //Daemon startup profiling, times are counted from the process start
+    static void markStartupPhase(const QString &phase);
+    static QJsonArray getStartupPhases();
+
     typedef enum
     {
         MP_Classic = 0,
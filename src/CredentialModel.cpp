@@ -150,6 +150,11 @@ int CredentialModel::rowCount(const QModelIndex &parent) const
     else
         pParentItem = static_cast<TreeItem *>(parent.internalPointer());
 
+    // Logins are exposed once fetched, see fetchMore()
+    if ((pParentItem->treeType() == TreeItem::Service) &&
+        !static_cast<ServiceItem *>(pParentItem)->loginsFetched())
+        return 0;
+
     return pParentItem->childCount();
 }
 
@@ -159,6 +164,51 @@ int CredentialModel::columnCount(const QModelIndex &parent) const
     return 2;
 }
 
+bool CredentialModel::hasChildren(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return m_pRootItem->childCount() > 0;
+    if (parent.column() > 0)
+        return false;
+
+    // Report unfetched logins too, so views show the service as expandable
+    return static_cast<TreeItem *>(parent.internalPointer())->childCount() > 0;
+}
+
+bool CredentialModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.column() > 0)
+        return false;
+
+    ServiceItem *pServiceItem = getServiceItemByIndex(parent);
+    return (pServiceItem != nullptr) && !pServiceItem->loginsFetched();
+}
+
+void CredentialModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    // Login items already exist, only their rows are announced here
+    ServiceItem *pServiceItem = getServiceItemByIndex(parent);
+    int iLoginCount = pServiceItem->childCount();
+    if (iLoginCount == 0)
+    {
+        pServiceItem->setLoginsFetched(true);
+        return;
+    }
+
+    beginInsertRows(parent, 0, iLoginCount - 1);
+    pServiceItem->setLoginsFetched(true);
+    endInsertRows();
+}
+
+void CredentialModel::fetchLogins(const QModelIndex &serviceIndex)
+{
+    if (canFetchMore(serviceIndex))
+        fetchMore(serviceIndex);
+}
+
 TreeItem *CredentialModel::getItemByIndex(const QModelIndex &idx) const
 {
     if (!idx.isValid())
@@ -171,7 +221,11 @@ void CredentialModel::load(const QJsonArray &json)
     if (json.isEmpty())
         return;
 
-    beginResetModel();
+    // Nothing to diff against on first load, build the whole tree at once.
+    // Otherwise apply the changes with row signals so views keep their state.
+    bool bReset = m_pRootItem->childCount() == 0;
+    if (bReset)
+        beginResetModel();
 
     m_pRootItem->setItemsStatus(TreeItem::UNUSED);
     for (int i=0; i<json.size(); i++)
@@ -179,69 +233,186 @@ void CredentialModel::load(const QJsonArray &json)
         QJsonObject pnode = json.at(i).toObject();
 
         QJsonArray jchilds = pnode["childs"].toArray();
+        if (jchilds.isEmpty())
+            continue;
+
+        // Retrieve credential data
+        QString sServiceName = pnode["service"].toString();
+
+        // Check if this service already exists
+        ServiceItem *pServiceItem = m_pRootItem->findServiceByName(sServiceName);
+        if (pServiceItem != nullptr)
+        {
+            pServiceItem->setStatus(TreeItem::USED);
+            for (int j=0; j<jchilds.size(); j++)
+                loadLogin(pServiceItem, jchilds.at(j).toObject(), !bReset);
+            continue;
+        }
+
+        // Service does not exist, fill it before adding it so the
+        // inserted row comes with all its logins
+        pServiceItem = new ServiceItem(sServiceName);
+        pServiceItem->setStatus(TreeItem::USED);
         for (int j=0; j<jchilds.size(); j++)
+            loadLogin(pServiceItem, jchilds.at(j).toObject(), false);
+
+        if (!bReset)
+            beginInsertRows(QModelIndex(), m_pRootItem->childCount(), m_pRootItem->childCount());
+        m_pRootItem->addChild(pServiceItem);
+        if (!bReset)
+            endInsertRows();
+    }
+
+    if (bReset)
+        endResetModel();
+    else
+        removeUnusedItems();
+
+    bool bClearLoginDescription = m_pRootItem->childCount() == 0;
+    emit modelLoaded(bClearLoginDescription);
+}
+
+void CredentialModel::loadLogin(ServiceItem *pServiceItem, const QJsonObject &cnode, bool bNotify)
+{
+    QString sLoginName = cnode["login"].toString();
+
+    // Check if this login already exists
+    LoginItem *pLoginItem = pServiceItem->findLoginByName(sLoginName);
+    if (pLoginItem != nullptr)
+    {
+        pLoginItem->setStatus(TreeItem::USED);
+        if (!setLoginData(pLoginItem, cnode) || !bNotify)
+            return;
+
+        // Rows of unfetched logins are not known to views yet, the service
+        // row is refreshed instead so the filter checks it again
+        QModelIndex serviceIndex = createIndex(pServiceItem->row(), 0, pServiceItem);
+        if (!pServiceItem->loginsFetched())
         {
-            QJsonObject cnode = jchilds.at(j).toObject();
+            emit unfetchedLoginChanged(pLoginItem);
+            emit dataChanged(serviceIndex, serviceIndex.sibling(serviceIndex.row(), 1));
+            return;
+        }
 
-            // Retrieve credential data
-            QString sServiceName = pnode["service"].toString();
+        int iRow = pLoginItem->row();
+        emit dataChanged(index(iRow, 0, serviceIndex), index(iRow, 1, serviceIndex));
+        return;
+    }
 
-            // Check if this service already exists
-            ServiceItem *pServiceItem = m_pRootItem->findServiceByName(sServiceName);
+    // Login does not exist, add it
+    pLoginItem = new LoginItem(sLoginName);
+    pLoginItem->setStatus(TreeItem::USED);
+    setLoginData(pLoginItem, cnode);
 
-            // Service does not exist, add it
-            if (pServiceItem == nullptr)
-                pServiceItem = m_pRootItem->addService(sServiceName);
-            pServiceItem->setStatus(TreeItem::USED);
+    if (!bNotify)
+    {
+        pServiceItem->addChild(pLoginItem);
+        return;
+    }
 
-            QString sLoginName = cnode["login"].toString();
+    QModelIndex serviceIndex = createIndex(pServiceItem->row(), 0, pServiceItem);
+    if (pServiceItem->loginsFetched())
+    {
+        beginInsertRows(serviceIndex, pServiceItem->childCount(), pServiceItem->childCount());
+        pServiceItem->addChild(pLoginItem);
+        endInsertRows();
+    }
+    else
+    {
+        // Announced with the other logins by fetchMore()
+        pServiceItem->addChild(pLoginItem);
+        emit unfetchedLoginAdded(pLoginItem);
+    }
 
-            // Check if this login already exists
-            LoginItem *pLoginItem = pServiceItem->findLoginByName(sLoginName);
+    // Logins summary of the service row changed
+    emit dataChanged(serviceIndex, serviceIndex.sibling(serviceIndex.row(), 1));
+}
 
-            // Login does not exist, add it
-            if (pLoginItem == nullptr)
-                pLoginItem = pServiceItem->addLogin(sLoginName);
-            pLoginItem->setStatus(TreeItem::USED);
+bool CredentialModel::setLoginData(LoginItem *pLoginItem, const QJsonObject &cnode)
+{
+    bool bChanged = false;
 
-            // Update login item description
-            QString sDescription = cnode["description"].toString();
-            pLoginItem->setDescription(sDescription);
+    // Update login item description
+    QString sDescription = cnode["description"].toString();
+    if (sDescription != pLoginItem->description())
+    {
+        pLoginItem->setDescription(sDescription);
+        bChanged = true;
+    }
 
-            // Update login item created date
-            QDate dCreatedDate = QDate::fromString(cnode["date_created"].toString(), Qt::ISODate);
-            pLoginItem->setUpdatedDate(dCreatedDate);
+    // Update login item created and updated dates, parsed when first displayed
+    if (pLoginItem->setUpdatedDate(cnode["date_created"].toString()))
+        bChanged = true;
+    if (pLoginItem->setAccessedDate(cnode["date_last_used"].toString()))
+        bChanged = true;
 
-            // Update login item updated date
-            QDate dUpdatedDate = QDate::fromString(cnode["date_last_used"].toString(), Qt::ISODate);
-            pLoginItem->setAccessedDate(dUpdatedDate);
+    QJsonArray a = cnode["address"].toArray();
+    if (a.size() < 2)
+    {
+        qWarning() << "Moolticute daemon did not send the node address, please upgrade moolticute daemon.";
+        return bChanged;
+    }
+    QByteArray bAddress;
+    bAddress.append((char)a.at(0).toInt());
+    bAddress.append((char)a.at(1).toInt());
 
-            QJsonArray a = cnode["address"].toArray();
-            if (a.size() < 2)
-            {
-                qWarning() << "Moolticute daemon did not send the node address, please upgrade moolticute daemon.";
-                continue;
-            }
-            QByteArray bAddress;
-            bAddress.append((char)a.at(0).toInt());
-            bAddress.append((char)a.at(1).toInt());
+    // Update login item address
+    if (bAddress != pLoginItem->address())
+    {
+        pLoginItem->setAddress(bAddress);
+        bChanged = true;
+    }
 
-            // Update login item address
-            pLoginItem->setAddress(bAddress);
+    // Update login favorite
+    qint8 iFavorite = (qint8)cnode["favorite"].toInt();
+    if (iFavorite != pLoginItem->favorite())
+    {
+        pLoginItem->setFavorite(iFavorite);
+        bChanged = true;
+    }
 
-            // Update login favorite
-            int iFavorite = cnode["favorite"].toInt();
-            pLoginItem->setFavorite(iFavorite);
+    return bChanged;
+}
+
+void CredentialModel::removeUnusedItems()
+{
+    // Walk backwards so rows of remaining items stay valid
+    for (int i = m_pRootItem->childCount() - 1; i >= 0; i--)
+    {
+        TreeItem *pServiceItem = m_pRootItem->child(i);
+        if (pServiceItem->status() == TreeItem::UNUSED)
+        {
+            beginRemoveRows(QModelIndex(), i, i);
+            if (m_pRootItem->removeOne(pServiceItem))
+                delete pServiceItem;
+            endRemoveRows();
+            continue;
         }
-    }
 
-    // Remove unused items
-    m_pRootItem->removeUnusedItems();
+        QModelIndex serviceIndex = createIndex(i, 0, pServiceItem);
+        // Login rows of unfetched services are not known to views, remove them silently
+        bool bFetched = static_cast<ServiceItem *>(pServiceItem)->loginsFetched();
+        bool bLoginRemoved = false;
+        for (int j = pServiceItem->childCount() - 1; j >= 0; j--)
+        {
+            TreeItem *pLoginItem = pServiceItem->child(j);
+            if (pLoginItem->status() != TreeItem::UNUSED)
+                continue;
 
-    endResetModel();
+            if (bFetched)
+                beginRemoveRows(serviceIndex, j, j);
+            else
+                emit unfetchedLoginAboutToBeRemoved(pLoginItem);
+            if (pServiceItem->removeOne(pLoginItem))
+                delete pLoginItem;
+            if (bFetched)
+                endRemoveRows();
+            bLoginRemoved = true;
+        }
 
-    bool bClearLoginDescription = m_pRootItem->childCount() == 0;
-    emit modelLoaded(bClearLoginDescription);
+        if (bLoginRemoved)
+            emit dataChanged(serviceIndex, serviceIndex.sibling(i, 1));
+    }
 }
 
 ServiceItem *CredentialModel::addService(const QString &sServiceName)
@@ -403,6 +574,24 @@ QJsonArray CredentialModel::getJsonChanges()
     return jarr;
 }
 
+QHash<QString, QString> CredentialModel::clearTextPasswords() const
+{
+    //Passwords already fetched from the device, keyed by "service/login"
+    //This is what gets fed to the background strength scorer
+    QHash<QString, QString> passwords;
+    for (TreeItem *pService : m_pRootItem->childs())
+    {
+        for (TreeItem *pLogin : pService->childs())
+        {
+            LoginItem *pLoginItem = static_cast<LoginItem *>(pLogin);
+            if (!pLoginItem->password().isEmpty())
+                passwords[pService->name() + "/" + pLoginItem->name()] = pLoginItem->password();
+        }
+    }
+
+    return passwords;
+}
+
 void CredentialModel::addCredential(QString sServiceName, const QString &sLoginName, const QString &sPassword, const QString &sDescription)
 {
     //Force all service names to lowercase
@@ -424,6 +613,7 @@ void CredentialModel::addCredential(QString sServiceName, const QString &sLoginN
             QModelIndex serviceIndex = getServiceIndexByName(pTargetService->name());
             if (serviceIndex.isValid())
             {
+                fetchLogins(serviceIndex);
                 beginInsertRows(serviceIndex, rowCount(serviceIndex), rowCount(serviceIndex));
                 pAddedLoginItem = pTargetService->addLogin(sLoginName);
                 pAddedLoginItem->setPasswordLocked(false);
@@ -443,6 +633,7 @@ void CredentialModel::addCredential(QString sServiceName, const QString &sLoginN
         QModelIndex serviceIndex = getServiceIndexByName(pAddedService->name());
         if (serviceIndex.isValid())
         {
+            fetchLogins(serviceIndex);
             beginInsertRows(serviceIndex, rowCount(serviceIndex), rowCount(serviceIndex));
             pAddedLoginItem = pAddedService->addLogin(sLoginName);
             pAddedLoginItem->setPasswordLocked(false);
@@ -4,9 +4,11 @@
 // Qt
 #include <QAbstractItemModel>
 #include <QJsonArray>
+#include <QJsonObject>
 #include <QDate>
 #include <QTimer>
 #include <QIcon>
+#include <QHash>
 
 // Application
 #include "Common.h"
@@ -39,6 +41,9 @@ public:
     virtual QModelIndex parent(const QModelIndex &idx) const;
     virtual int rowCount(const QModelIndex &parent = QModelIndex()) const;
     virtual int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    virtual bool hasChildren(const QModelIndex &parent = QModelIndex()) const;
+    virtual bool canFetchMore(const QModelIndex &parent) const;
+    virtual void fetchMore(const QModelIndex &parent);
     void load(const QJsonArray &json);
     void setClearTextPassword(const QString &sServiceName, const QString &sLoginName, const QString &sPassword);
     QJsonArray getJsonChanges();
@@ -51,9 +56,14 @@ public:
     QModelIndex getServiceIndexByName(const QString &sServiceName, int column = 0) const;
     LoginItem *getLoginItemByIndex(const QModelIndex &idx) const;
     ServiceItem *getServiceItemByIndex(const QModelIndex &idx) const;
+    QHash<QString, QString> clearTextPasswords() const;
 
 private:
     ServiceItem *addService(const QString &sServiceName);
+    void loadLogin(ServiceItem *pServiceItem, const QJsonObject &cnode, bool bNotify);
+    bool setLoginData(LoginItem *pLoginItem, const QJsonObject &cnode);
+    void fetchLogins(const QModelIndex &serviceIndex);
+    void removeUnusedItems();
 
 private:
     RootItem *m_pRootItem;
@@ -61,6 +71,12 @@ private:
 signals:
     void modelLoaded(bool bClearLoginDescription);
     void selectLoginItem(LoginItem *pLoginItem);
+
+    // Logins of services not fetched yet change without row signals,
+    // these keep the filter search index up to date
+    void unfetchedLoginAdded(TreeItem *pLoginItem);
+    void unfetchedLoginChanged(TreeItem *pLoginItem);
+    void unfetchedLoginAboutToBeRemoved(TreeItem *pLoginItem);
 };
 
 #endif // CREDENTIALMODEL_H
@@ -16,10 +16,118 @@ CredentialModelFilter::~CredentialModelFilter()
 
 void CredentialModelFilter::setFilter(const QString &sFilter)
 {
-    m_sFilter = sFilter;
+    m_searchIndex.setQuery(sFilter);
     invalidateFilter();
 }
 
+void CredentialModelFilter::setFuzzyFilter(bool bFuzzy)
+{
+    if (bFuzzy == m_searchIndex.isFuzzy())
+        return;
+
+    m_searchIndex.setFuzzy(bFuzzy);
+    invalidateFilter();
+}
+
+void CredentialModelFilter::setSourceModel(QAbstractItemModel *pSourceModel)
+{
+    if (sourceModel())
+        disconnect(sourceModel(), nullptr, this, nullptr);
+
+    // Connect before the base class so the index is up to date
+    // when the proxy filters inserted or changed rows
+    if (pSourceModel)
+    {
+        connect(pSourceModel, &QAbstractItemModel::rowsInserted, this, &CredentialModelFilter::onSourceRowsInserted);
+        connect(pSourceModel, &QAbstractItemModel::rowsAboutToBeRemoved, this, &CredentialModelFilter::onSourceRowsAboutToBeRemoved);
+        connect(pSourceModel, &QAbstractItemModel::dataChanged, this, &CredentialModelFilter::onSourceDataChanged);
+        connect(pSourceModel, &QAbstractItemModel::modelReset, this, &CredentialModelFilter::rebuildSearchIndex);
+
+        CredentialModel *pSrcModel = dynamic_cast<CredentialModel *>(pSourceModel);
+        if (pSrcModel)
+        {
+            connect(pSrcModel, &CredentialModel::unfetchedLoginAdded, this, &CredentialModelFilter::onUnfetchedLoginAdded);
+            connect(pSrcModel, &CredentialModel::unfetchedLoginChanged, this, &CredentialModelFilter::onUnfetchedLoginChanged);
+            connect(pSrcModel, &CredentialModel::unfetchedLoginAboutToBeRemoved, this, &CredentialModelFilter::onUnfetchedLoginAboutToBeRemoved);
+        }
+    }
+
+    QSortFilterProxyModel::setSourceModel(pSourceModel);
+    rebuildSearchIndex();
+}
+
+void CredentialModelFilter::onSourceRowsInserted(const QModelIndex &srcParent, int iFirst, int iLast)
+{
+    CredentialModel *pSrcModel = dynamic_cast<CredentialModel *>(sourceModel());
+    for (int i = iFirst; i <= iLast; i++)
+        indexItem(pSrcModel->getItemByIndex(pSrcModel->index(i, 0, srcParent)));
+}
+
+void CredentialModelFilter::onSourceRowsAboutToBeRemoved(const QModelIndex &srcParent, int iFirst, int iLast)
+{
+    CredentialModel *pSrcModel = dynamic_cast<CredentialModel *>(sourceModel());
+    for (int i = iFirst; i <= iLast; i++)
+        unindexItem(pSrcModel->getItemByIndex(pSrcModel->index(i, 0, srcParent)));
+}
+
+void CredentialModelFilter::onSourceDataChanged(const QModelIndex &srcTopLeft, const QModelIndex &srcBottomRight)
+{
+    CredentialModel *pSrcModel = dynamic_cast<CredentialModel *>(sourceModel());
+    for (int i = srcTopLeft.row(); i <= srcBottomRight.row(); i++)
+    {
+        TreeItem *pItem = pSrcModel->getItemByIndex(pSrcModel->index(i, 0, srcTopLeft.parent()));
+        if (pItem != nullptr)
+            m_searchIndex.updateItem(pItem);
+    }
+}
+
+void CredentialModelFilter::onUnfetchedLoginAdded(TreeItem *pLoginItem)
+{
+    indexItem(pLoginItem);
+}
+
+void CredentialModelFilter::onUnfetchedLoginChanged(TreeItem *pLoginItem)
+{
+    m_searchIndex.updateItem(pLoginItem);
+}
+
+void CredentialModelFilter::onUnfetchedLoginAboutToBeRemoved(TreeItem *pLoginItem)
+{
+    unindexItem(pLoginItem);
+}
+
+void CredentialModelFilter::rebuildSearchIndex()
+{
+    m_searchIndex.clear();
+
+    CredentialModel *pSrcModel = dynamic_cast<CredentialModel *>(sourceModel());
+    if (pSrcModel == nullptr)
+        return;
+
+    for (int i = 0; i < pSrcModel->rowCount(); i++)
+        indexItem(pSrcModel->getItemByIndex(pSrcModel->index(i, 0)));
+}
+
+void CredentialModelFilter::indexItem(TreeItem *pItem)
+{
+    if (pItem == nullptr)
+        return;
+
+    m_searchIndex.addItem(pItem);
+    foreach (TreeItem *pChild, pItem->childs())
+        indexItem(pChild);
+}
+
+void CredentialModelFilter::unindexItem(TreeItem *pItem)
+{
+    if (pItem == nullptr)
+        return;
+
+    foreach (TreeItem *pChild, pItem->childs())
+        unindexItem(pChild);
+    m_searchIndex.removeItem(pItem);
+}
+
 bool CredentialModelFilter::switchFavFilter()
 {
     m_favFilter = !m_favFilter;
@@ -66,6 +174,8 @@ QModelIndexList CredentialModelFilter::getNextRow(const QModelIndex& rowIdx)
         if  (rowCount(parent.parent()) > parent.row()+1)
         {
             QModelIndex nextParent = index(parent.row()+1, 0, parent.parent());
+            if (canFetchMore(nextParent))
+                fetchMore(nextParent);
             nextRow << index(0, 0, nextParent);
             nextRow << index(0, 1, nextParent);
         }
@@ -78,6 +188,8 @@ QModelIndexList CredentialModelFilter::getNextRow(const QModelIndex& rowIdx)
         else if (parent.row() > 0)
         {
             QModelIndex prevousParent = index(parent.row()-1, 0, parent.parent());
+            if (canFetchMore(prevousParent))
+                fetchMore(prevousParent);
             nextRow << index(rowCount(prevousParent)-1, 0, prevousParent);
             nextRow << index(rowCount(prevousParent)-1, 1, prevousParent);
         }
@@ -101,10 +213,16 @@ bool CredentialModelFilter::filterAcceptsRow(int iSrcRow, const QModelIndex &src
     if (srcIndex.isValid())
     {
         // If any of children matches the filter, then current index matches the filter as well
-        int iRowCount = sourceModel()->rowCount(srcIndex);
-        for (int i=0; i<iRowCount; ++i)
-            if (filterAcceptsRow(i, srcIndex))
-                return true;
+        // Matching is a lookup in the search index, so this stays cheap for big trees.
+        // Children are walked on the items as their rows may not be fetched yet.
+        CredentialModel *pCredentialModel = dynamic_cast<CredentialModel *>(sourceModel());
+        TreeItem *pItem = pCredentialModel->getItemByIndex(srcIndex);
+        if (pItem != nullptr)
+        {
+            foreach (TreeItem *pChild, pItem->childs())
+                if (acceptItem(pChild))
+                    return true;
+        }
         return acceptRow(iSrcRow, srcParent);
     }
 
@@ -112,17 +230,6 @@ bool CredentialModelFilter::filterAcceptsRow(int iSrcRow, const QModelIndex &src
     return QSortFilterProxyModel::filterAcceptsRow(iSrcRow, srcParent) ;
 }
 
-bool CredentialModelFilter::testItemAgainstNameAndDescription(TreeItem *pItem, const QString &sFilter) const
-{
-    if (pItem)
-    {
-        bool bCondition1 = pItem->name().contains(sFilter, Qt::CaseInsensitive);
-        bool bCondition2 = pItem->description().contains(sFilter, Qt::CaseInsensitive);
-        return bCondition1 || bCondition2;
-    }
-    return false;
-}
-
 bool CredentialModelFilter::acceptRow(int iSrcRow, const QModelIndex &srcParent) const
 {
     // Get src model
@@ -135,36 +242,28 @@ bool CredentialModelFilter::acceptRow(int iSrcRow, const QModelIndex &srcParent)
         // Get item
         TreeItem *pItem = pCredentialModel->getItemByIndex(srcIndex);
         if (pItem != nullptr)
-        {
-            // Is it a login item?
-            LoginItem *pLoginItem = dynamic_cast<LoginItem *>(pItem);
+            return acceptItem(pItem);
+    }
 
-            bool shouldDisplayByFavFilter = true;
-            if (m_favFilter)
-            {
-                if (pLoginItem != nullptr)
-                {
-                    shouldDisplayByFavFilter = !m_favFilter || (pLoginItem->favorite() != -1 && m_favFilter);
-                }
-                else
-                {
-                    shouldDisplayByFavFilter = !m_favFilter;
-                }
-            }
+    return true;
+}
 
-            if (pLoginItem != nullptr)
-            {
-                TreeItem *pParentItem = pLoginItem->parentItem();
-                bool bCondition = testItemAgainstNameAndDescription(pParentItem, m_sFilter) && shouldDisplayByFavFilter;
-                if (bCondition)
-                    return true;
-            }
+bool CredentialModelFilter::acceptItem(TreeItem *pItem) const
+{
+    // Is it a login item?
+    bool bIsLogin = pItem->treeType() == TreeItem::Login;
 
-            return testItemAgainstNameAndDescription(pItem, m_sFilter) && shouldDisplayByFavFilter;
-        }
+    // Favorite filter only shows favorite logins
+    if (m_favFilter)
+    {
+        if (!bIsLogin || static_cast<LoginItem *>(pItem)->favorite() == -1)
+            return false;
     }
 
-    return true;
+    if (bIsLogin && m_searchIndex.matches(pItem->parentItem()))
+        return true;
+
+    return m_searchIndex.matches(pItem);
 }
 
 bool CredentialModelFilter::lessThan(const QModelIndex &srcLeft, const QModelIndex &srcRight) const
@@ -205,6 +304,8 @@ QModelIndex CredentialModelFilter::getProxyIndexFromItem(TreeItem *pItem, int co
     case TreeItem::TreeType::Login:
     {
         QModelIndex parentIndex = getProxyIndexFromItem(pItem->parentItem());
+        if (canFetchMore(parentIndex))
+            fetchMore(parentIndex);
 
         for (int i = 0; i < rowCount(parentIndex); i ++)
         {
@@ -5,6 +5,7 @@
 #include <QSortFilterProxyModel>
 
 // Application
+#include "CredentialSearchIndex.h"
 class TreeItem;
 
 class CredentialModelFilter : public QSortFilterProxyModel
@@ -15,6 +16,8 @@ public:
     CredentialModelFilter(QObject *parent = nullptr);
     ~CredentialModelFilter();
     void setFilter(const QString &sFilter);
+    void setFuzzyFilter(bool bFuzzy);
+    void setSourceModel(QAbstractItemModel *pSourceModel) Q_DECL_OVERRIDE;
     bool switchFavFilter();
     TreeItem *getItemByProxyIndex(const QModelIndex &proxyIndex);
     const TreeItem *getItemByProxyIndex(const QModelIndex &proxyIndex) const;
@@ -27,12 +30,23 @@ protected:
     virtual bool filterAcceptsRow(int iSrcRow, const QModelIndex &srcParent) const override;
     virtual bool lessThan(const QModelIndex &srcLeft, const QModelIndex &srcRight) const override;
 
+private slots:
+    void onSourceRowsInserted(const QModelIndex &srcParent, int iFirst, int iLast);
+    void onSourceRowsAboutToBeRemoved(const QModelIndex &srcParent, int iFirst, int iLast);
+    void onSourceDataChanged(const QModelIndex &srcTopLeft, const QModelIndex &srcBottomRight);
+    void onUnfetchedLoginAdded(TreeItem *pLoginItem);
+    void onUnfetchedLoginChanged(TreeItem *pLoginItem);
+    void onUnfetchedLoginAboutToBeRemoved(TreeItem *pLoginItem);
+    void rebuildSearchIndex();
+
 private:
     bool acceptRow(int iSrcRow, const QModelIndex &srcParent) const;
-    bool testItemAgainstNameAndDescription(TreeItem *pItem, const QString &sFilter) const;
+    bool acceptItem(TreeItem *pItem) const;
+    void indexItem(TreeItem *pItem);
+    void unindexItem(TreeItem *pItem);
 
 private:
-    QString m_sFilter;
+    CredentialSearchIndex m_searchIndex;
     bool m_favFilter = false;
     Qt::SortOrder tempSortOrder;
 };
@@ -0,0 +1,202 @@
+// Application
+#include "CredentialSearchIndex.h"
+#include "TreeItem.h"
+
+void CredentialSearchIndex::clear()
+{
+    m_hTexts.clear();
+    m_hGrams.clear();
+    m_matches.clear();
+}
+
+void CredentialSearchIndex::addItem(TreeItem *pItem)
+{
+    if (pItem == nullptr || m_hTexts.contains(pItem))
+        return;
+
+    QString sText = itemText(pItem);
+    m_hTexts.insert(pItem, sText);
+    foreach (const QString &sGram, grams(sText))
+        m_hGrams[sGram].insert(pItem);
+
+    if (!m_sQuery.isEmpty() && textMatches(sText))
+        m_matches.insert(pItem);
+}
+
+void CredentialSearchIndex::removeItem(TreeItem *pItem)
+{
+    auto it = m_hTexts.find(pItem);
+    if (it == m_hTexts.end())
+        return;
+
+    foreach (const QString &sGram, grams(it.value()))
+    {
+        auto gramIt = m_hGrams.find(sGram);
+        if (gramIt == m_hGrams.end())
+            continue;
+        gramIt->remove(pItem);
+        if (gramIt->isEmpty())
+            m_hGrams.erase(gramIt);
+    }
+
+    m_hTexts.erase(it);
+    m_matches.remove(pItem);
+}
+
+void CredentialSearchIndex::updateItem(TreeItem *pItem)
+{
+    auto it = m_hTexts.constFind(pItem);
+    if (it != m_hTexts.constEnd() && it.value() == itemText(pItem))
+        return;
+
+    removeItem(pItem);
+    addItem(pItem);
+}
+
+bool CredentialSearchIndex::contains(TreeItem *pItem) const
+{
+    return m_hTexts.contains(pItem);
+}
+
+void CredentialSearchIndex::setQuery(const QString &sQuery)
+{
+    QString sNewQuery = sQuery.toCaseFolded();
+    if (sNewQuery == m_sQuery)
+        return;
+
+    // Anything matching the new query also matched the previous one
+    // when the new one only adds characters, in both search modes
+    bool bNarrowing = !m_sQuery.isEmpty() && sNewQuery.contains(m_sQuery);
+
+    m_sQuery = sNewQuery;
+    if (m_sQuery.isEmpty())
+    {
+        m_matches.clear();
+        return;
+    }
+
+    search(bNarrowing ? m_matches : candidates());
+}
+
+const QString &CredentialSearchIndex::query() const
+{
+    return m_sQuery;
+}
+
+void CredentialSearchIndex::setFuzzy(bool bFuzzy)
+{
+    if (m_bFuzzy == bFuzzy)
+        return;
+
+    m_bFuzzy = bFuzzy;
+    if (!m_sQuery.isEmpty())
+        search(candidates());
+}
+
+bool CredentialSearchIndex::isFuzzy() const
+{
+    return m_bFuzzy;
+}
+
+bool CredentialSearchIndex::matches(TreeItem *pItem) const
+{
+    if (m_sQuery.isEmpty())
+        return true;
+
+    if (m_hTexts.contains(pItem))
+        return m_matches.contains(pItem);
+
+    // Not indexed yet
+    return (pItem != nullptr) && textMatches(itemText(pItem));
+}
+
+int CredentialSearchIndex::matchCount() const
+{
+    return m_sQuery.isEmpty() ? m_hTexts.size() : m_matches.size();
+}
+
+QString CredentialSearchIndex::itemText(const TreeItem *pItem)
+{
+    // Name and description are searched separately, the separator
+    // can't be typed in the filter so no match spans both
+    return (pItem->name() + QChar('\n') + pItem->description()).toCaseFolded();
+}
+
+QSet<QString> CredentialSearchIndex::grams(const QString &sText)
+{
+    QSet<QString> sGrams;
+    for (int i = 0; i < sText.length(); i++)
+    {
+        sGrams.insert(sText.mid(i, 1));
+        if (i + 3 <= sText.length())
+            sGrams.insert(sText.mid(i, 3));
+    }
+    return sGrams;
+}
+
+bool CredentialSearchIndex::textMatches(const QString &sText) const
+{
+    if (sText.contains(m_sQuery))
+        return true;
+
+    if (!m_bFuzzy)
+        return false;
+
+    // Query characters in the same order, anywhere in name or description
+    int iPos = 0;
+    for (const QChar &c : m_sQuery)
+    {
+        iPos = sText.indexOf(c, iPos);
+        if (iPos < 0)
+            return false;
+        iPos++;
+    }
+    return true;
+}
+
+QSet<TreeItem *> CredentialSearchIndex::candidates() const
+{
+    // Trigrams only hold for contiguous matches, fuzzy search
+    // falls back to the single characters of the query
+    bool bUseUnigrams = m_bFuzzy || (m_sQuery.length() < 3);
+    QSet<QString> sQueryGrams;
+    foreach (const QString &sGram, grams(m_sQuery))
+    {
+        if (sGram.length() == (bUseUnigrams ? 1 : 3))
+            sQueryGrams.insert(sGram);
+    }
+
+    // Intersect postings, smallest first
+    const QSet<TreeItem *> *pSmallest = nullptr;
+    foreach (const QString &sGram, sQueryGrams)
+    {
+        auto it = m_hGrams.constFind(sGram);
+        if (it == m_hGrams.constEnd())
+            return QSet<TreeItem *>();
+        if (pSmallest == nullptr || it->size() < pSmallest->size())
+            pSmallest = &it.value();
+    }
+
+    if (pSmallest == nullptr)
+        return QSet<TreeItem *>();
+
+    QSet<TreeItem *> result = *pSmallest;
+    foreach (const QString &sGram, sQueryGrams)
+    {
+        const QSet<TreeItem *> &postings = *m_hGrams.constFind(sGram);
+        if (&postings != pSmallest)
+            result.intersect(postings);
+    }
+    return result;
+}
+
+void CredentialSearchIndex::search(const QSet<TreeItem *> &candidates)
+{
+    QSet<TreeItem *> matches;
+    foreach (TreeItem *pItem, candidates)
+    {
+        if (textMatches(m_hTexts.value(pItem)))
+            matches.insert(pItem);
+    }
+    m_matches = matches;
+}
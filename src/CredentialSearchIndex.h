@@ -0,0 +1,49 @@
+#ifndef CREDENTIALSEARCHINDEX_H
+#define CREDENTIALSEARCHINDEX_H
+
+// Qt
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+// Application
+class TreeItem;
+
+// Lower-cased gram index over service/login names and descriptions.
+// Single characters and trigrams are indexed, a query is first narrowed
+// to the items sharing all its grams before the real substring check.
+// Results of the last query are kept so that typing more characters only
+// re-checks the previous matches.
+class CredentialSearchIndex
+{
+public:
+    void clear();
+    void addItem(TreeItem *pItem);
+    void removeItem(TreeItem *pItem);
+    void updateItem(TreeItem *pItem);
+    bool contains(TreeItem *pItem) const;
+
+    void setQuery(const QString &sQuery);
+    const QString &query() const;
+    // Fuzzy mode also accepts items containing the query characters in order
+    void setFuzzy(bool bFuzzy);
+    bool isFuzzy() const;
+    bool matches(TreeItem *pItem) const;
+    int matchCount() const;
+
+private:
+    static QString itemText(const TreeItem *pItem);
+    static QSet<QString> grams(const QString &sText);
+    bool textMatches(const QString &sText) const;
+    QSet<TreeItem *> candidates() const;
+    void search(const QSet<TreeItem *> &candidates);
+
+private:
+    QHash<TreeItem *, QString> m_hTexts;
+    QHash<QString, QSet<TreeItem *>> m_hGrams;
+    QSet<TreeItem *> m_matches;
+    QString m_sQuery;
+    bool m_bFuzzy = false;
+};
+
+#endif // CREDENTIALSEARCHINDEX_H
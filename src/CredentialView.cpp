@@ -66,6 +66,23 @@ void CredentialView::onModelLoaded(bool bClearLoginDescription)
         for (int i = 0; i < pCredModelFilter->rowCount(); i ++)
         {
             QModelIndex serviceIndex = pCredModelFilter->index(i, 0, QModelIndex());
+
+            // Only fetch login rows of services having a favorite
+            TreeItem *pServiceItem = pCredModelFilter->getItemByProxyIndex(serviceIndex);
+            bool bHasFavorite = false;
+            foreach (TreeItem *pChild, pServiceItem->childs())
+            {
+                if (static_cast<LoginItem *>(pChild)->favorite() >= 0)
+                {
+                    bHasFavorite = true;
+                    break;
+                }
+            }
+            if (!bHasFavorite)
+                continue;
+
+            if (pCredModelFilter->canFetchMore(serviceIndex))
+                pCredModelFilter->fetchMore(serviceIndex);
             for (int j = 0; j < pCredModelFilter->rowCount(serviceIndex); j ++)
             {
                 QModelIndex itemIndex = pCredModelFilter->index(j, 0, serviceIndex);
@@ -232,7 +249,7 @@ void CredentialView::resetCurrentIndex()
                 }
             }
 
-            if (pCredModelFilter->rowCount(serviceIndex) > 0)
+            if (pCredModelFilter->hasChildren(serviceIndex))
             {
                 setExpanded(serviceIndex, false);
                 selectionModel()->setCurrentIndex(serviceIndex
@@ -27,6 +27,7 @@
 #include "TreeItem.h"
 #include "LoginItem.h"
 #include "ServiceItem.h"
+#include "PasswordStrengthScorer.h"
 
 CredentialsManagement::CredentialsManagement(QWidget *parent) :
     QWidget(parent), ui(new Ui::CredentialsManagement), m_pAddedLoginItem(nullptr)
@@ -133,6 +134,16 @@ CredentialsManagement::CredentialsManagement(QWidget *parent) :
     connect(ui->credentialTreeView, &CredentialView::expandedStateChanged, this, &CredentialsManagement::onExpandedStateChanged);
     connect(m_pCredModel, &CredentialModel::selectLoginItem, this, &CredentialsManagement::onSelectLoginItem, Qt::QueuedConnection);
 
+    //Passwords known in clear are scored in background, weak ones are listed below the tree
+    ui->labelWeakPasswords->hide();
+    connect(m_pCredModel, &CredentialModel::modelReset, this, &CredentialsManagement::updateWeakPasswordsReport);
+    connect(m_pCredModel, &CredentialModel::dataChanged, this, &CredentialsManagement::updateWeakPasswordsReport);
+    connect(m_pCredModel, &CredentialModel::rowsInserted, this, &CredentialsManagement::updateWeakPasswordsReport);
+    connect(m_pCredModel, &CredentialModel::rowsRemoved, this, &CredentialsManagement::updateWeakPasswordsReport);
+
+    ui->addCredPasswordInput->setStrengthScoringEnabled(true);
+    connect(ui->addCredPasswordInput, &PasswordLineEdit::strengthChanged, this, &CredentialsManagement::onTypedPasswordStrength);
+
     m_tSelectLoginTimer.setInterval(50);
     m_tSelectLoginTimer.setSingleShot(true);
     connect(&m_tSelectLoginTimer, &QTimer::timeout, this, &CredentialsManagement::onSelectLoginTimerTimeOut);
@@ -341,6 +352,7 @@ void CredentialsManagement::onPasswordUnlocked(const QString & service, const QS
             if (service == serviceItem->name() && login == selectedLogin->name())
             {
                 m_pCredModel->setClearTextPassword(service, login, password);
+                updateWeakPasswordsReport();
                 ui->credDisplayPasswordInput->setText(password);
                 ui->credDisplayPasswordInput->setLocked(false);
             }
@@ -877,12 +889,11 @@ void CredentialsManagement::updateFavMenu()
         int services = m_pCredModel->rowCount();
         for (int i = 0; i < services; i ++)
         {
-            auto service_index = m_pCredModel->index(i,0);
-            int logins = m_pCredModel->rowCount(service_index);
-            for (int j = 0; j < logins; j++)
+            // Login rows may not be fetched yet, walk the items instead
+            auto service = m_pCredModel->getServiceItemByIndex(m_pCredModel->index(i,0));
+            for (TreeItem *item : service->childs())
             {
-                auto login_index = m_pCredModel->index(j, 0, service_index);
-                auto login = m_pCredModel->getLoginItemByIndex(login_index);
+                auto login = static_cast<LoginItem *>(item);
                 int favNumber = login->favorite();
                 if (favNumber >= 0 && actions.length() > favNumber &&
                         actions.at(favNumber+1) != nullptr)
@@ -903,6 +914,51 @@ void CredentialsManagement::credentialDataChanged()
     disconnect(m_pCredModel, &CredentialModel::rowsRemoved, this, &CredentialsManagement::credentialDataChanged);
 }
 
+void CredentialsManagement::updateWeakPasswordsReport()
+{
+    AppGui::passwordStrengthScorer()->scoreBatch(this, m_pCredModel->clearTextPasswords(),
+                                                 [this](const QHash<QString, double> &entropies)
+    {
+        QStringList weak;
+        for (auto it = entropies.constBegin(); it != entropies.constEnd(); ++it)
+        {
+            if (PasswordStrengthScorer::isWeak(it.value()))
+                weak << it.key();
+        }
+        weak.sort(Qt::CaseInsensitive);
+
+        ui->labelWeakPasswords->setVisible(!weak.isEmpty());
+        ui->labelWeakPasswords->setText(tr("%n weak password(s): %1", "", weak.size()).arg(weak.join(", ")));
+    });
+}
+
+void CredentialsManagement::onTypedPasswordStrength(double entropy)
+{
+    if (ui->addCredPasswordInput->text().isEmpty())
+    {
+        ui->addCredPasswordInput->setToolTip(QString());
+        return;
+    }
+
+    QString quality;
+    switch (PasswordStrengthScorer::levelForEntropy(entropy))
+    {
+    case PasswordStrengthScorer::StrengthPoor:
+        quality = tr("Poor");
+        break;
+    case PasswordStrengthScorer::StrengthWeak:
+        quality = tr("Weak");
+        break;
+    case PasswordStrengthScorer::StrengthGood:
+        quality = tr("Good");
+        break;
+    case PasswordStrengthScorer::StrengthExcellent:
+        quality = tr("Excellent");
+        break;
+    }
+    ui->addCredPasswordInput->setToolTip(tr("Password Quality: %1").arg(quality));
+}
+
 void CredentialsManagement::changeEvent(QEvent *event)
 {
     if (event->type() == QEvent::LanguageChange)
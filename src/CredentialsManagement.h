@@ -78,6 +78,8 @@ private slots:
     void onSelectLoginTimerTimeOut();
     void updateFavMenu();
     void credentialDataChanged();
+    void updateWeakPasswordsReport();
+    void onTypedPasswordStrength(double entropy);
 
     void on_toolButtonFavFilter_clicked();
 
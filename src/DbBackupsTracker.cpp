@@ -3,6 +3,7 @@
 #include <QDebug>
 #include <QException>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -11,6 +12,7 @@
 #include <QApplication>
 #include <QDir>
 #include <QStandardPaths>
+#include <QRegularExpression>
 
 #include "DbBackupChangeNumbersComparator.h"
 
@@ -18,8 +20,13 @@ DbBackupsTracker::DbBackupsTracker(const QString settingsFilePath, QObject* pare
     QObject(parent), settingsFilePath(settingsFilePath)
 {
     loadTracks();
-    connect(&watcher, &QFileSystemWatcher::fileChanged,
+
+    watcherDebounceTimer.setSingleShot(true);
+    watcherDebounceTimer.setInterval(WATCHER_DEBOUNCE_MS);
+    connect(&watcherDebounceTimer, &QTimer::timeout,
             this, &DbBackupsTracker::checkDbBackupSynchronization);
+    connect(&watcher, &QFileSystemWatcher::fileChanged,
+            this, &DbBackupsTracker::onBackupFileChanged);
 }
 
 DbBackupsTracker::~DbBackupsTracker()
@@ -41,17 +48,112 @@ int DbBackupsTracker::getCredentialsDbChangeNumber() const
     return credentialsDbChangeNumber;
 }
 
-QString DbBackupsTracker::readFile(QString path) const
+DbBackupsTracker::BackupProbe DbBackupsTracker::probeBackupFile(const QString &path) const
 {
-    QString content;
+    BackupProbe probe;
+    QFileInfo info(path);
+    if (!info.exists())
+        return probe;
+
+    auto it = probeCache.constFind(path);
+    if (it != probeCache.constEnd() && it->size == info.size() && it->lastModified == info.lastModified())
+        return it.value();
+
     QFile f(path);
-    if (f.exists())
+    if (!f.open(QIODevice::ReadOnly))
+        return probe;
+
+    probe.size = info.size();
+    probe.lastModified = info.lastModified();
+
+    // Encrypted backups start with the change numbers, legacy ones end with them,
+    // only read the full file if they are not where expected
+    QByteArray head = f.read(PROBE_SIZE);
+    bool found = probeHeader(head, probe);
+    if (!found && probe.format == "none" && f.size() > PROBE_SIZE)
+    {
+        f.seek(f.size() - PROBE_SIZE);
+        found = probeTrailer(f.read(PROBE_SIZE), probe);
+    }
+    else if (!found && probe.format == "none")
+    {
+        found = probeTrailer(head, probe);
+    }
+
+    if (!found)
     {
-        f.open(QIODevice::ReadOnly);
-        content = f.readAll();
+        f.seek(0);
+        parseBackup(f.readAll(), probe);
+    }
+
+    probeCache.insert(path, probe);
+    return probe;
+}
+
+bool DbBackupsTracker::probeHeader(const QByteArray &head, BackupProbe &probe) const
+{
+    QString content = QString::fromUtf8(head).trimmed();
+    if (!content.startsWith('{'))
+        return false;
+
+    static const QRegularExpression encryptionRe("\"encryption\"\\s*:\\s*\"([^\"]*)\"");
+    QRegularExpressionMatch encryptionMatch = encryptionRe.match(content);
+    probe.format = encryptionMatch.hasMatch()? encryptionMatch.captured(1) : "SimpleCrypt";
+
+    static const QRegularExpression credentialsRe("\"credentialsDbChangeNumber\"\\s*:\\s*(-?\\d+)\\s*[,}]");
+    static const QRegularExpression dataRe("\"dataDbChangeNumber\"\\s*:\\s*(-?\\d+)\\s*[,}]");
+    QRegularExpressionMatch credentialsMatch = credentialsRe.match(content);
+    QRegularExpressionMatch dataMatch = dataRe.match(content);
+    if (!credentialsMatch.hasMatch() || !dataMatch.hasMatch())
+        return false;
+
+    probe.credentialsDbChangeNumber = credentialsMatch.captured(1).toInt();
+    probe.dataDbChangeNumber = dataMatch.captured(1).toInt();
+    return true;
+}
+
+bool DbBackupsTracker::probeTrailer(const QByteArray &tail, BackupProbe &probe) const
+{
+    // Legacy backup is an array ending with: ..., credentials cn, data cn, checksum ]
+    QByteArray content = tail.trimmed();
+    if (!content.endsWith(']'))
+        return false;
+
+    content.chop(1);
+    QList<QByteArray> values = content.split(',');
+    if (values.size() < 4)
+        return false;
+
+    bool credentialsOk = false, dataOk = false;
+    int credentialsCn = values.at(values.size() - 3).trimmed().toInt(&credentialsOk);
+    int dataCn = values.at(values.size() - 2).trimmed().toInt(&dataOk);
+    if (!credentialsOk || !dataOk)
+        return false;
+
+    probe.credentialsDbChangeNumber = credentialsCn;
+    probe.dataDbChangeNumber = dataCn;
+    return true;
+}
+
+void DbBackupsTracker::parseBackup(const QByteArray &content, BackupProbe &probe) const
+{
+    QJsonDocument d = QJsonDocument::fromJson(content);
+    if (isALegacyBackup(d))
+    {
+        probe.format = "none";
+        probe.credentialsDbChangeNumber = extractCredentialsDbChangeNumberLegacyBackup(d);
+        probe.dataDbChangeNumber = extractDataDbChangeNumberLegacyBackup(d);
+    }
+    else if (isAnEncryptedBackup(d))
+    {
+        probe.format = d.object().value("encryption").toString("SimpleCrypt");
+        probe.credentialsDbChangeNumber = extractCredentialsDbChangeNumberEncryptedBackup(d);
+        probe.dataDbChangeNumber = extractDataDbChangeNumberEncryptedBackup(d);
+    }
+    else
+    {
+        probe.format = "none";
     }
-    f.close();
-    return content;
 }
 
 int DbBackupsTracker::extractCredentialsDbChangeNumberEncryptedBackup(const QJsonDocument &d) const
@@ -73,18 +175,6 @@ int DbBackupsTracker::extractCredentialsDbChangeNumberLegacyBackup(const QJsonDo
     return -1;
 }
 
-int DbBackupsTracker::extractCredentialsDbChangeNumber(const QString &content) const
-{
-    int cn = -1;
-    QJsonDocument d = QJsonDocument::fromJson(content.toLocal8Bit());
-    if (isALegacyBackup(d))
-        cn = extractCredentialsDbChangeNumberLegacyBackup(d);
-    else if (isAnEncryptedBackup(d))
-        cn = extractCredentialsDbChangeNumberEncryptedBackup(d);
-
-    return cn;
-}
-
 int DbBackupsTracker::extractDataDbChangeNumberEncryptedBackup(const QJsonDocument &d) const
 {
     QJsonObject root = d.object();
@@ -114,21 +204,9 @@ int DbBackupsTracker::extractDataDbChangeNumberLegacyBackup(const QJsonDocument
     return -1;
 }
 
-int DbBackupsTracker::extractDataDbChangeNumber(const QString &content) const
-{
-    int cn = -1;
-    QJsonDocument d = QJsonDocument::fromJson(content.toLocal8Bit());
-    if (d.isObject())
-        cn = extractDataDbChangeNumberEncryptedBackup(d);
-    else if (d.isArray())
-        cn = extractDataDbChangeNumberLegacyBackup(d);
-    return cn;
-}
-
 int DbBackupsTracker::tryGetCredentialsDbBackupChangeNumber() const
 {
-    QString content = tryReadBackupFile();
-    return extractCredentialsDbChangeNumber(content);
+    return tryProbeBackupFile().credentialsDbChangeNumber;
 }
 
 int DbBackupsTracker::getDataDbChangeNumber() const
@@ -176,22 +254,12 @@ bool DbBackupsTracker::hasBackup() const
 
 QString DbBackupsTracker::getTrackedBackupFileFormat()
 {
-    QString content = tryReadBackupFile();
-    QJsonDocument d = QJsonDocument::fromJson(content.toLocal8Bit());
-
-    if (isALegacyBackup(d))
-        return "none";
-
-    if (isAnEncryptedBackup(d))
-        return "SimpleCrypt";
-
-    return "none";
+    return tryProbeBackupFile().format;
 }
 
 int DbBackupsTracker::tryGetDataDbBackupChangeNumber() const
 {
-    QString content = tryReadBackupFile();
-    return extractDataDbChangeNumber(content);
+    return tryProbeBackupFile().dataDbChangeNumber;
 }
 
 void DbBackupsTracker::watchPath(const QString path)
@@ -204,7 +272,7 @@ void DbBackupsTracker::watchPath(const QString path)
     watcher.addPath(path);
 }
 
-QString DbBackupsTracker::tryReadBackupFile() const
+DbBackupsTracker::BackupProbe DbBackupsTracker::tryProbeBackupFile() const
 {
     QString path = getTrackPath(cardId);
     if (path.isEmpty())
@@ -212,12 +280,8 @@ QString DbBackupsTracker::tryReadBackupFile() const
         DbBackupsTrackerNoBackupFileSet ex;
         ex.raise();
     }
-    else
-    {
-        return readFile(path);
-    }
 
-    return "";
+    return probeBackupFile(path);
 }
 
 void DbBackupsTracker::track(const QString path)
@@ -308,6 +372,12 @@ void DbBackupsTracker::checkDbBackupSynchronization()
     }
 }
 
+void DbBackupsTracker::onBackupFileChanged(const QString &path)
+{
+    probeCache.remove(path);
+    watcherDebounceTimer.start();
+}
+
 void DbBackupsTracker::refreshTracking()
 {
     if (tracks.contains(cardId))
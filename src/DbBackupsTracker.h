@@ -2,11 +2,14 @@
 #define DBBACKUPSTRACKER_H
 
 #include <QCryptographicHash>
+#include <QDateTime>
 #include <QException>
 #include <QFileSystemWatcher>
+#include <QHash>
 #include <QMap>
 #include <QObject>
 #include <QString>
+#include <QTimer>
 
 class DbBackupsTrackerNoCardIdSet : public QException
 {
@@ -53,7 +56,7 @@ public:
 
     /**
      * Guess the current tracked backup file format,
-     * currently suported: "none" and "SimpleCrypt"
+     * currently suported: "none", "SimpleCrypt" and "ChaCha20-Poly1305"
      * throws: DbBackupsTrackerNoBackupFileSet
      */
     QString getTrackedBackupFileFormat();
@@ -77,9 +80,23 @@ public slots:
 
 protected slots:
     void checkDbBackupSynchronization();
+    void onBackupFileChanged(const QString &path);
 
 private:
+    // Change numbers of a backup file, valid as long as size and mtime don't change
+    struct BackupProbe
+    {
+        qint64 size = -1;
+        QDateTime lastModified;
+        int credentialsDbChangeNumber = -1;
+        int dataDbChangeNumber = -1;
+        QString format = "none";
+    };
+
     QFileSystemWatcher watcher;
+    // Editors and exports write in several steps, wait for the last one
+    QTimer watcherDebounceTimer;
+    mutable QHash<QString, BackupProbe> probeCache;
     QMap<QString, QString> tracks;
     QString cardId;
     QString settingsFilePath;
@@ -93,11 +110,11 @@ private:
     int tryGetCredentialsDbBackupChangeNumber() const;
     int tryGetDataDbBackupChangeNumber() const;
     void watchPath(const QString path);
-    QString tryReadBackupFile() const;
-    QString readFile(QString path) const;
-
-    int extractCredentialsDbChangeNumber(const QString &content) const;
-    int extractDataDbChangeNumber(const QString &content) const;
+    BackupProbe tryProbeBackupFile() const;
+    BackupProbe probeBackupFile(const QString &path) const;
+    bool probeHeader(const QByteArray &head, BackupProbe &probe) const;
+    bool probeTrailer(const QByteArray &tail, BackupProbe &probe) const;
+    void parseBackup(const QByteArray &content, BackupProbe &probe) const;
 
     bool isALegacyBackup(const QJsonDocument &d) const;
     bool isAnEncryptedBackup(const QJsonDocument &d) const;
@@ -108,6 +125,9 @@ private:
     int extractDataDbChangeNumberLegacyBackup(const QJsonDocument &d) const;
     bool isDbBackupChangeNumberGreater(int backupCCN, int backupDCN) const;
     bool isDbBackupChangeNumberLower(int backupCCN, int backupDCN) const;
+
+    static const int WATCHER_DEBOUNCE_MS = 300;
+    static const int PROBE_SIZE = 4096;
 };
 
 #endif // DBBACKUPSTRACKER_H
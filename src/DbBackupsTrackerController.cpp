@@ -160,7 +160,7 @@ void DbBackupsTrackerController::askForExportBackup()
 
 void DbBackupsTrackerController::exportDbBackup()
 {
-    QString format = "SimpleCrypt";
+    QString format = "ChaCha20-Poly1305";
 
     window->wantExportDatabase();
 
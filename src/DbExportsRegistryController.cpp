@@ -169,7 +169,7 @@ void DbExportsRegistryController::exportDbBackup()
 {
     handleExportResultEnabled = true;
 
-    QString format = "SimpleCrypt";
+    QString format = "ChaCha20-Poly1305";
 
     if (window)
         window->wantExportDatabase();
@@ -0,0 +1,181 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#include "ExportFileGenerator.h"
+#include "Common.h"
+#include "SimpleCrypt/SimpleCrypt.h"
+#include "AeadCrypt/AeadCrypt.h"
+
+//Progress is reported every that many nodes
+#define EXPORT_PROGRESS_STEP    64
+
+ExportFileGenerator::ExportFileGenerator(const Snapshot &s, const QString &enc, QObject *parent):
+    QThread(parent),
+    snapshot(s),
+    encryption(enc)
+{
+    setObjectName("ExportFileGenerator");
+}
+
+void ExportFileGenerator::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QByteArray fileData = generate(snapshot, encryption, [this](int current, int total, const QString &msg)
+    {
+        emit progress(current, total, msg);
+    });
+
+    qDebug() << "Export file generated in" << timer.elapsed() << "ms," << fileData.size() << "bytes";
+    emit generated(fileData);
+}
+
+static QJsonArray nodesToJson(const QVector<ExportFileGenerator::Node> &nodes, bool withName, bool withPointed,
+                              int &current, int total, const ExportFileGenerator::ProgressCb &cbProgress)
+{
+    QJsonArray nodeQJsonArray;
+    for (const ExportFileGenerator::Node &n: nodes)
+    {
+        QJsonObject nodeObject;
+        nodeObject["address"] = QJsonValue(Common::bytesToJson(n.address));
+        if (withName)
+            nodeObject["name"] = QJsonValue(n.name);
+        nodeObject["data"] = QJsonValue(Common::bytesToJsonObjectArray(n.data));
+        if (withPointed)
+            nodeObject["pointed"] = QJsonValue(false);
+        nodeQJsonArray.append(QJsonValue(nodeObject));
+
+        if (++current % EXPORT_PROGRESS_STEP == 0)
+            cbProgress(current, total, "Generating Export File...");
+    }
+    return nodeQJsonArray;
+}
+
+QByteArray ExportFileGenerator::generate(const Snapshot &snapshot, const QString &encryption, const ProgressCb &cbProgress)
+{
+    //Nodes and the encryption step
+    const int total = snapshot.loginNodes.size() + snapshot.loginChildNodes.size() +
+                      snapshot.dataNodes.size() + snapshot.dataChildNodes.size() + 1;
+    int current = 0;
+
+    QJsonArray exportTopArray = QJsonArray();
+
+    /* CTR */
+    exportTopArray.append(QJsonValue(Common::bytesToJsonObjectArray(snapshot.ctrValue)));
+
+    /* CPZ/CTR packets */
+    QJsonArray cpzCtrQJsonArray = QJsonArray();
+    for (qint32 i = 0; i < snapshot.cpzCtrValue.size(); i++)
+    {
+        cpzCtrQJsonArray.append(QJsonValue(Common::bytesToJsonObjectArray(snapshot.cpzCtrValue[i])));
+    }
+    exportTopArray.append(QJsonValue(cpzCtrQJsonArray));
+
+    /* Starting parent */
+    exportTopArray.append(QJsonValue(Common::bytesToJson(snapshot.startNode)));
+
+    /* Data starting parent */
+    exportTopArray.append(QJsonValue(Common::bytesToJson(snapshot.startDataNode)));
+
+    /* Favorites */
+    QJsonArray favQJsonArray = QJsonArray();
+    for (qint32 i = 0; i < snapshot.favoritesAddrs.size(); i++)
+    {
+        favQJsonArray.append(QJsonValue(Common::bytesToJsonObjectArray(snapshot.favoritesAddrs[i])));
+    }
+    exportTopArray.append(QJsonValue(favQJsonArray));
+
+    /* Service nodes */
+    exportTopArray.append(QJsonValue(nodesToJson(snapshot.loginNodes, true, false, current, total, cbProgress)));
+
+    /* Child nodes */
+    exportTopArray.append(QJsonValue(nodesToJson(snapshot.loginChildNodes, true, true, current, total, cbProgress)));
+
+    /* Data nodes */
+    exportTopArray.append(QJsonValue(nodesToJson(snapshot.dataNodes, true, false, current, total, cbProgress)));
+
+    /* Data child nodes */
+    exportTopArray.append(QJsonValue(nodesToJson(snapshot.dataChildNodes, false, true, current, total, cbProgress)));
+
+    /* identifier */
+    exportTopArray.append(QJsonValue(QString("moolticute")));
+
+    /* bundle version */
+    exportTopArray.append(QJsonValue((qint64)1));
+
+    /* Credential change number */
+    exportTopArray.append(QJsonValue(snapshot.credentialsDbChangeNumber));
+
+    /* Data change number */
+    exportTopArray.append(QJsonValue(snapshot.dataDbChangeNumber));
+
+    /* Mooltipass serial */
+    exportTopArray.append(QJsonValue((qint64)snapshot.serialNumber));
+
+    /* Generate file payload */
+    QJsonDocument payloadDoc(exportTopArray);
+    auto payload = payloadDoc.toJson();
+
+    qDebug() << "requested encryption for exported DB:" << encryption;
+
+    if (encryption.isEmpty() || encryption == "none")
+    {
+        cbProgress(total, total, "Export File Generated!");
+        return payload;
+    }
+
+    cbProgress(current, total, "Encrypting Export File...");
+
+    /* Export file content */
+    QJsonObject exportTopObject;
+
+    if (encryption == "ChaCha20-Poly1305")
+    {
+        /* Key is derived from the whole CPZ, compression is block parallel */
+        AeadCrypt aeadCrypt(snapshot.cardCPZ);
+        aeadCrypt.setCompressionLevel(snapshot.compressionLevel);
+
+        exportTopObject.insert("encryption", "ChaCha20-Poly1305");
+        exportTopObject.insert("payload", aeadCrypt.encryptToString(payload));
+    }
+    else if (encryption == "SimpleCrypt")
+    {
+        SimpleCrypt simpleCrypt;
+        simpleCrypt.setKey(snapshot.simpleCryptKey);
+
+        exportTopObject.insert("encryption", "SimpleCrypt");
+        exportTopObject.insert("payload", simpleCrypt.encryptToString(payload));
+    }
+    else
+    {
+        // Fallback in case of an unknown encryption method where specified
+        qWarning() << "DB export: Unknown encryption " << encryption << "is asked, fallback to 'none'";
+        exportTopObject.insert("encryption", "none");
+        exportTopObject.insert("payload", QString(payload));
+    }
+
+    exportTopObject.insert("dataDbChangeNumber", QJsonValue(snapshot.dataDbChangeNumber));
+    exportTopObject.insert("credentialsDbChangeNumber", QJsonValue(snapshot.credentialsDbChangeNumber));
+
+    QJsonDocument fileContentDoc(exportTopObject);
+    payload = fileContentDoc.toJson();
+
+    cbProgress(total, total, "Export File Generated!");
+    return payload;
+}
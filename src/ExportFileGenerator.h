@@ -0,0 +1,82 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#ifndef EXPORTFILEGENERATOR_H
+#define EXPORTFILEGENERATOR_H
+
+#include <QtCore>
+#include <functional>
+
+/* Generates the database export file from a background thread.
+ * It works on a copy of the node lists taken once the flash is read, so
+ * the JSON serialisation, compression and encryption of a large database
+ * do not block the daemon event loop.
+ */
+class ExportFileGenerator: public QThread
+{
+    Q_OBJECT
+public:
+    struct Node
+    {
+        QByteArray address;
+        QString name;
+        QByteArray data;
+    };
+
+    //Everything the export file is made of, copied from MPDevice
+    struct Snapshot
+    {
+        QByteArray ctrValue;
+        QList<QByteArray> cpzCtrValue;
+        QByteArray startNode;
+        QByteArray startDataNode;
+        QList<QByteArray> favoritesAddrs;
+        QVector<Node> loginNodes;
+        QVector<Node> loginChildNodes;
+        QVector<Node> dataNodes;
+        QVector<Node> dataChildNodes;
+        quint8 credentialsDbChangeNumber = 0;
+        quint8 dataDbChangeNumber = 0;
+        quint32 serialNumber = 0;
+
+        //Encryption keys
+        QByteArray cardCPZ;
+        quint64 simpleCryptKey = 0;
+        int compressionLevel = 0;
+    };
+
+    using ProgressCb = std::function<void(int current, int total, const QString &msg)>;
+
+    ExportFileGenerator(const Snapshot &snapshot, const QString &encryption, QObject *parent = nullptr);
+
+    static QByteArray generate(const Snapshot &snapshot, const QString &encryption,
+                               const ProgressCb &cbProgress = [](int, int, const QString &) {});
+
+signals:
+    void progress(int current, int total, QString msg);
+    void generated(const QByteArray &fileData);
+
+protected:
+    virtual void run() override;
+
+private:
+    const Snapshot snapshot;
+    const QString encryption;
+};
+
+#endif // EXPORTFILEGENERATOR_H
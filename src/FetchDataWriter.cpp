@@ -0,0 +1,128 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#include "FetchDataWriter.h"
+
+FetchDataWriter::FetchDataWriter(const QString &filePath, int flushIntervalMs, QObject *parent):
+    QThread(parent),
+    file(filePath),
+    flushIntervalMs(qMax(10, flushIntervalMs))
+{
+    setObjectName("FetchDataWriter");
+    //Reserved capacity survives resize(0), the two buffers are reused
+    front.reserve(FLUSH_SIZE);
+}
+
+FetchDataWriter::~FetchDataWriter()
+{
+    finish();
+}
+
+bool FetchDataWriter::open()
+{
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCritical() << "Failed to open fetch data file" << file.fileName() << file.errorString();
+        return false;
+    }
+
+    start(QThread::LowPriority);
+    return true;
+}
+
+void FetchDataWriter::append(const QByteArray &data)
+{
+    received += data.size();
+
+    QMutexLocker locker(&mutex);
+    front.append(data);
+    if (front.size() >= FLUSH_SIZE)
+        wakeup.wakeOne();
+}
+
+void FetchDataWriter::append(const char *data, int size)
+{
+    received += size;
+
+    QMutexLocker locker(&mutex);
+    front.append(data, size);
+    if (front.size() >= FLUSH_SIZE)
+        wakeup.wakeOne();
+}
+
+void FetchDataWriter::finish()
+{
+    {
+        QMutexLocker locker(&mutex);
+        if (stopping)
+            return;
+        stopping = true;
+        wakeup.wakeOne();
+    }
+
+    if (isRunning())
+        wait();
+    file.close();
+}
+
+qint64 FetchDataWriter::bytesWritten() const
+{
+    QMutexLocker locker(&mutex);
+    return written;
+}
+
+bool FetchDataWriter::hasWriteError() const
+{
+    QMutexLocker locker(&mutex);
+    return writeError;
+}
+
+void FetchDataWriter::run()
+{
+    QByteArray back;
+    back.reserve(FLUSH_SIZE);
+    bool done = false;
+
+    while (!done)
+    {
+        {
+            QMutexLocker locker(&mutex);
+            if (!stopping && front.size() < FLUSH_SIZE)
+                wakeup.wait(&mutex, static_cast<unsigned long>(flushIntervalMs));
+
+            done = stopping;
+            back.swap(front);
+        }
+
+        if (back.isEmpty())
+            continue;
+
+        qint64 res = file.write(back);
+        bool ok = res == back.size() && file.flush();
+
+        QMutexLocker locker(&mutex);
+        if (!ok && !writeError)
+        {
+            writeError = true;
+            qCritical() << "Failed to write fetch data:" << file.errorString();
+        }
+        if (res > 0)
+            written += res;
+        back.resize(0);
+    }
+}
@@ -0,0 +1,69 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#ifndef FETCHDATAWRITER_H
+#define FETCHDATAWRITER_H
+
+#include <QtCore>
+
+/* Writes fetched debug data (accelerometer samples, random bytes...) to
+ * a file from a background thread. Data is appended to a front buffer
+ * from the device thread, the writer swaps it with its back buffer every
+ * flush interval (or earlier when it grows large) and writes it out, so
+ * a slow disk never delays the next request to the device.
+ */
+class FetchDataWriter: public QThread
+{
+    Q_OBJECT
+public:
+    //Front buffer size triggering an early flush
+    static const int FLUSH_SIZE = 256 * 1024;
+
+    FetchDataWriter(const QString &filePath, int flushIntervalMs, QObject *parent = nullptr);
+    virtual ~FetchDataWriter();
+
+    bool open();
+    void append(const QByteArray &data);
+    void append(const char *data, int size);
+
+    //Flush everything and stop the thread
+    void finish();
+
+    qint64 bytesReceived() const { return received; }
+    qint64 bytesWritten() const;
+    bool hasWriteError() const;
+
+protected:
+    virtual void run() override;
+
+private:
+    QFile file;
+    int flushIntervalMs;
+
+    mutable QMutex mutex;
+    QWaitCondition wakeup;
+    QByteArray front;
+    bool stopping = false;
+    bool writeError = false;
+    qint64 written = 0;
+
+    //Only touched from the caller thread
+    qint64 received = 0;
+};
+
+#endif // FETCHDATAWRITER_H
@@ -27,75 +27,243 @@ bool FilesCache::save(QList<QVariantMap> files)
     m_isFileCacheInSync = true;
     QFile file(m_filePath);
 
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate))
         return false;
 
     QJsonObject json;
     json.insert("db_change_number", m_dbChangeNumber);
 
+    m_files.clear();
     QJsonArray filesJson;
     for (QVariantMap file : files)
     {
         QJsonObject fileJson = QJsonDocument::fromVariant(file).object();
         filesJson.append(fileJson);
+        m_files.insert(file.value("name").toString(), file);
     }
 
     json.insert("files", filesJson);
     QJsonDocument doc(json);
 
     QTextStream out(&file);
-    out << m_simpleCrypt.encryptToString(doc.toJson());
+    out << m_aeadCrypt.encryptToString(doc.toJson()) << '\n';
+
+    m_loaded = true;
+    m_needsCompaction = false;
+    m_journalRecords = 0;
 
     return true;
 }
 
 QList<QVariantMap> FilesCache::load()
 {
-    if (!m_dbChangeNumberSet || m_cardCPZ.isEmpty())
+    if (!ensureLoaded())
     {
         qDebug() << "dbChangeNumberSet not set or null CPZ";
         return QList<QVariantMap>();
     }
-    else
+
+    return m_files.values();
+}
+
+bool FilesCache::ensureLoaded()
+{
+    if (!m_dbChangeNumberSet || m_cardCPZ.isEmpty())
+        return false;
+
+    if (!m_loaded)
     {
-        QList<QVariantMap> files;
+        readJournal();
+        m_loaded = true;
+    }
+
+    return true;
+}
+
+void FilesCache::readJournal()
+{
+    m_files.clear();
+    m_journalRecords = 0;
+    m_needsCompaction = false;
+
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        m_needsCompaction = true;
+        return;
+    }
+
+    QByteArray data = file.readAll();
 
-        QFile file(m_filePath);
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-            return files;
+    //Former format was a single blob without line ending
+    if (!data.endsWith('\n'))
+        m_needsCompaction = true;
 
+    QList<QByteArray> lines = data.split('\n');
+    while (!lines.isEmpty() && lines.last().isEmpty())
+        lines.removeLast();
 
-        QTextStream in(&file);
-        QString encryptedData = in.readAll();
-        QString rawJSon = m_simpleCrypt.decryptToString(encryptedData);
+    if (lines.isEmpty())
+    {
+        m_needsCompaction = true;
+        return;
+    }
+
+    bool ok = false;
+    QByteArray rawJSon = decryptLine(lines.takeFirst(), ok);
+    QJsonObject jsonRoot = QJsonDocument::fromJson(rawJSon).object();
 
-        QJsonObject jsonRoot = QJsonDocument::fromJson(rawJSon.toLocal8Bit()).object();
+    int cacheDbChangeNumber = jsonRoot.value("db_change_number").toInt();
+    QJsonArray filesJson = jsonRoot.value("files").toArray();
+    for (QJsonValue file : filesJson)
+    {
+        QVariantMap item = file.toVariant().toMap();
+        m_files.insert(item.value("name").toString(), item);
+    }
 
-        qint8 cacheDbChangeNumber = jsonRoot.value("db_change_number").toInt();
-        if (cacheDbChangeNumber != m_dbChangeNumber)
+    for (const QByteArray &line : lines)
+    {
+        QByteArray rawRecord = decryptLine(line, ok);
+        if (rawRecord.isEmpty() || !ok)
         {
-            qDebug() << "dbChangeNumber miss";
-            m_isFileCacheInSync = false;
+            //Truncated write, drop the tail and rewrite on next change
+            qWarning() << "Files cache journal corrupted, ignoring" << lines.size() - m_journalRecords << "records";
+            m_needsCompaction = true;
+            break;
         }
-        else
+
+        QJsonObject record = QJsonDocument::fromJson(rawRecord).object();
+        QString op = record.value("op").toString();
+        if (op == "set")
         {
-            qDebug() << "dbChangeNumber match";
-            m_isFileCacheInSync = true;
-            QJsonArray filesJson = jsonRoot.value("files").toArray();
-            for (QJsonValue file : filesJson)
-            {
-                QVariant v = file.toVariant();
-                files.append(v.toMap());
-            }
+            QVariantMap item = record.value("file").toVariant().toMap();
+            m_files.insert(item.value("name").toString(), item);
         }
+        else if (op == "remove")
+            m_files.remove(record.value("name").toString());
+        else if (op == "db_change_number")
+            cacheDbChangeNumber = record.value("value").toInt();
 
-        return files;
+        m_journalRecords++;
+    }
+
+    if (cacheDbChangeNumber != m_dbChangeNumber)
+    {
+        qDebug() << "dbChangeNumber miss";
+        m_isFileCacheInSync = false;
+        m_files.clear();
+        m_needsCompaction = true;
     }
+    else
+    {
+        qDebug() << "dbChangeNumber match";
+        m_isFileCacheInSync = true;
+    }
+}
+
+QByteArray FilesCache::decryptLine(const QByteArray &line, bool &ok)
+{
+    QString cipher = QString::fromLatin1(line);
+    if (AeadCrypt::isAeadString(cipher))
+    {
+        QByteArray raw = m_aeadCrypt.decryptToByteArray(cipher);
+        ok = m_aeadCrypt.lastError() == AeadCrypt::ErrorNoError;
+        return raw;
+    }
+
+    //Written by an older version, convert the whole file on next change
+    m_needsCompaction = true;
+    QByteArray raw = m_simpleCrypt.decryptToByteArray(cipher);
+    ok = m_simpleCrypt.lastError() == SimpleCrypt::ErrorNoError;
+    return raw;
+}
+
+bool FilesCache::appendRecord(const QJsonObject &record)
+{
+    if (!m_loaded || m_needsCompaction)
+        return false;
+
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+        return false;
+
+    QTextStream out(&file);
+    out << m_aeadCrypt.encryptToString(QJsonDocument(record).toJson(QJsonDocument::Compact)) << '\n';
+    m_journalRecords++;
+
+    return true;
+}
+
+bool FilesCache::compactIfNeeded()
+{
+    int maxRecords = m_files.size() > JOURNAL_MIN_RECORDS ? m_files.size() : JOURNAL_MIN_RECORDS;
+    if (m_journalRecords <= maxRecords)
+        return true;
+
+    qDebug() << "Compacting files cache journal," << m_journalRecords << "records";
+    return save(m_files.values());
+}
+
+void FilesCache::invalidate()
+{
+    m_files.clear();
+    m_loaded = false;
+    m_needsCompaction = false;
+    m_journalRecords = 0;
+}
+
+bool FilesCache::addFile(const QString &name, int size)
+{
+    if (!ensureLoaded() || m_files.contains(name))
+        return false;
+
+    QVariantMap item;
+    item.insert("name", name);
+    item.insert("size", size);
+    m_files.insert(name, item);
+
+    QJsonObject record {{ "op", "set" }, { "file", QJsonObject::fromVariantMap(item) }};
+    if (!appendRecord(record))
+        return save(m_files.values());
+
+    return compactIfNeeded();
 }
 
+bool FilesCache::updateFile(const QString &name, int size)
+{
+    if (!ensureLoaded())
+        return false;
+
+    auto it = m_files.find(name);
+    if (it == m_files.end())
+        return false;
+
+    int revision = it->value("revision").toInt();
+    it->insert("revision", revision + 1);
+    it->insert("size", size);
+
+    QJsonObject record {{ "op", "set" }, { "file", QJsonObject::fromVariantMap(*it) }};
+    if (!appendRecord(record))
+        return save(m_files.values());
+
+    return compactIfNeeded();
+}
+
+bool FilesCache::removeFile(const QString &name)
+{
+    if (!ensureLoaded() || m_files.remove(name) == 0)
+        return false;
+
+    QJsonObject record {{ "op", "remove" }, { "name", name }};
+    if (!appendRecord(record))
+        return save(m_files.values());
+
+    return compactIfNeeded();
+}
 
 bool FilesCache::erase()
 {
+    invalidate();
     QFile file(m_filePath);
     return file.remove();
 }
@@ -105,6 +273,7 @@ void FilesCache::resetState()
     m_dbChangeNumberSet = false;
     m_cardCPZ = QByteArray();
     m_isFileCacheInSync = true;
+    invalidate();
 }
 
 bool FilesCache::setDbChangeNumber(quint8 changeNumber)
@@ -112,12 +281,21 @@ bool FilesCache::setDbChangeNumber(quint8 changeNumber)
     if (m_dbChangeNumberSet && m_dbChangeNumber != changeNumber && !m_cardCPZ.isEmpty())
     {
         qDebug() << "dbChangeNumber updated, triggering file storage";
-        auto tempDb = load();
+        ensureLoaded();
         m_dbChangeNumber = changeNumber;
-        save(tempDb);
+
+        //Files are kept, only the change number is journaled
+        QJsonObject record {{ "op", "db_change_number" }, { "value", changeNumber }};
+        if (!appendRecord(record))
+            save(m_files.values());
+        else
+            compactIfNeeded();
         return false;
     }
 
+    if (!m_dbChangeNumberSet || m_dbChangeNumber != changeNumber)
+        invalidate();
+
     m_dbChangeNumber = changeNumber;
     m_dbChangeNumberSet = true;
 
@@ -144,6 +322,7 @@ bool FilesCache::setCardCPZ(QByteArray cardCPZ)
         return false;
 
     m_cardCPZ = cardCPZ;
+    invalidate();
 
     QString fileName = QCryptographicHash::hash(m_cardCPZ, QCryptographicHash::Sha256).toHex().toHex();
     fileName.truncate(30);
@@ -160,6 +339,7 @@ bool FilesCache::setCardCPZ(QByteArray cardCPZ)
 
     m_simpleCrypt.setKey(m_key);
     m_simpleCrypt.setIntegrityProtectionMode(SimpleCrypt::ProtectionHash);
+    m_aeadCrypt.setKeyMaterial(m_cardCPZ);
 
     if (m_dbChangeNumberSet)
         return true;
@@ -2,10 +2,21 @@
 #define FILESCACHE_H
 
 #include <QList>
+#include <QJsonObject>
+#include <QMap>
 #include <QVariantHash>
 #include <QObject>
 #include "SimpleCrypt/SimpleCrypt.h"
+#include "AeadCrypt/AeadCrypt.h"
 
+/* The cache file is a journal of AEAD encrypted lines (SimpleCrypt for
+ * caches written by older versions, they are rewritten on next change).
+ * First line is a snapshot of the whole file list (same content
+ * as the former single blob format), each following line is one
+ * change record appended when a file is added, updated or removed.
+ * The journal is compacted back into a snapshot once it grows larger
+ * than the file list, so a change costs one small append on disk.
+ */
 class FilesCache : public QObject
 {
     Q_OBJECT
@@ -22,19 +33,41 @@ public slots:
     QList<QVariantMap> load();
     bool erase();
 
+    //Return false if nothing was changed
+    bool addFile(const QString &name, int size);
+    bool updateFile(const QString &name, int size);
+    bool removeFile(const QString &name);
+
     void resetState();
     bool setCardCPZ(QByteArray cardCPZ);
     bool setDbChangeNumber(quint8 changeNumber);
     bool exist();
     bool isInSync() const;
 private:
+    bool ensureLoaded();
+    void readJournal();
+    bool appendRecord(const QJsonObject &record);
+    bool compactIfNeeded();
+    void invalidate();
+    QByteArray decryptLine(const QByteArray &line, bool &ok);
+
     QByteArray m_cardCPZ;
     QString m_filePath;
     qint64 m_key = 0;
     bool m_dbChangeNumberSet = false;
     quint8 m_dbChangeNumber = -1;
     SimpleCrypt m_simpleCrypt;
+    AeadCrypt m_aeadCrypt;
     bool m_isFileCacheInSync = true;
+
+    //In memory copy of the cache file, sorted by file name
+    QMap<QString, QVariantMap> m_files;
+    bool m_loaded = false;
+    //Disk content can't be appended to, next change rewrites it
+    bool m_needsCompaction = false;
+    int m_journalRecords = 0;
+
+    static const int JOURNAL_MIN_RECORDS = 64;
 };
 
 #endif // FILESCACHE_H
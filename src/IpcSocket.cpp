@@ -0,0 +1,210 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#include "IpcSocket.h"
+
+#include <QtEndian>
+#include <QJsonDocument>
+#include <QDebug>
+#include <QFileInfo>
+#include "Common.h"
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+#include <QCborValue>
+#include <QCborMap>
+#endif
+
+//Length (4 bytes) + frame type (1 byte)
+#define IPC_HEADER_SIZE         5
+//Larger frames are treated as a corrupted stream
+static const qint64 IPC_MAX_FRAME_SIZE = 128 * 1024 * 1024;
+
+IpcSocket::IpcSocket(QObject *parent):
+    QObject(parent),
+    socket(new QLocalSocket(this))
+{
+    setupSocket();
+}
+
+IpcSocket::IpcSocket(QLocalSocket *s, QObject *parent):
+    QObject(parent),
+    socket(s)
+{
+    socket->setParent(this);
+    hasConnected = true;
+    setupSocket();
+}
+
+IpcSocket::~IpcSocket()
+{
+}
+
+void IpcSocket::setupSocket()
+{
+    connect(socket, &QLocalSocket::connected, [this]()
+    {
+        hasConnected = true;
+        emit connected();
+    });
+    connect(socket, &QLocalSocket::disconnected, this, &IpcSocket::disconnected);
+    connect(socket, &QLocalSocket::readyRead, this, &IpcSocket::readFrames);
+    connect(socket, SIGNAL(error(QLocalSocket::LocalSocketError)),
+            this, SLOT(onError(QLocalSocket::LocalSocketError)));
+}
+
+void IpcSocket::connectToServer(const QString &name)
+{
+    hasConnected = false;
+    readBuffer.clear();
+    socket->connectToServer(name);
+}
+
+void IpcSocket::close()
+{
+    socket->abort();
+}
+
+bool IpcSocket::isConnected() const
+{
+    return socket->state() == QLocalSocket::ConnectedState;
+}
+
+void IpcSocket::sendHello(QJsonObject obj)
+{
+    obj["encoding"] = encodingName();
+    socket->write(encodeFrame(FrameHello, obj));
+}
+
+void IpcSocket::sendJson(const QJsonObject &obj)
+{
+    socket->write(encodeFrame(FrameJson, obj));
+}
+
+QString IpcSocket::daemonSocketName()
+{
+#ifdef Q_OS_LINUX
+    if (QFileInfo(MOOLTICUTE_DAEMON_SYSTEMD_SOCK).exists())
+        return QStringLiteral(MOOLTICUTE_DAEMON_SYSTEMD_SOCK);
+#endif
+    return QStringLiteral(MOOLTICUTE_DAEMON_IPC_SOCK);
+}
+
+QString IpcSocket::encodingName()
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    return QStringLiteral("cbor");
+#else
+    return QStringLiteral("qbjs");
+#endif
+}
+
+QByteArray IpcSocket::encodeFrame(FrameType type, const QJsonObject &obj)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    QByteArray payload = QCborValue(QCborMap::fromJsonObject(obj)).toCbor();
+#else
+    QByteArray payload = QJsonDocument(obj).toBinaryData();
+#endif
+
+    QByteArray frame(IPC_HEADER_SIZE, Qt::Uninitialized);
+    qToBigEndian<quint32>(static_cast<quint32>(payload.size() + 1), reinterpret_cast<uchar *>(frame.data()));
+    frame[4] = static_cast<char>(type);
+    frame.append(payload);
+    return frame;
+}
+
+bool IpcSocket::takeFrame(const QByteArray &buffer, int &pos, FrameType &type, QJsonObject &obj, bool &error)
+{
+    error = false;
+    if (buffer.size() - pos < IPC_HEADER_SIZE)
+        return false;
+
+    quint32 len = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(buffer.constData() + pos));
+    if (len < 1 || len > IPC_MAX_FRAME_SIZE)
+    {
+        error = true;
+        return false;
+    }
+    if (buffer.size() - pos < static_cast<int>(len) + 4)
+        return false;
+
+    type = static_cast<FrameType>(static_cast<quint8>(buffer.at(pos + 4)));
+    QByteArray payload = QByteArray::fromRawData(buffer.constData() + pos + IPC_HEADER_SIZE, static_cast<int>(len) - 1);
+    pos += static_cast<int>(len) + 4;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    QCborParserError err;
+    QCborValue value = QCborValue::fromCbor(payload, &err);
+    if (err.error != QCborError::NoError || !value.isMap())
+    {
+        error = true;
+        return false;
+    }
+    obj = value.toMap().toJsonObject();
+#else
+    //fromBinaryData validates and copies the data
+    QJsonDocument doc = QJsonDocument::fromBinaryData(payload);
+    if (!doc.isObject())
+    {
+        error = true;
+        return false;
+    }
+    obj = doc.object();
+#endif
+
+    return true;
+}
+
+void IpcSocket::readFrames()
+{
+    readBuffer.append(socket->readAll());
+
+    int pos = 0;
+    FrameType type;
+    QJsonObject obj;
+    bool error = false;
+    while (takeFrame(readBuffer, pos, type, obj, error))
+    {
+        //Unknown frame types are skipped, newer peers may send more of them
+        if (type == FrameHello)
+            emit helloReceived(obj);
+        else if (type == FrameJson)
+            emit jsonReceived(obj);
+    }
+
+    //Remove parsed frames at once instead of for every frame
+    readBuffer.remove(0, pos);
+
+    if (error)
+    {
+        qWarning() << "Invalid frame received on local socket, closing connection";
+        readBuffer.clear();
+        socket->abort();
+    }
+}
+
+void IpcSocket::onError(QLocalSocket::LocalSocketError err)
+{
+    Q_UNUSED(err)
+
+    //Errors of an established connection end up in disconnected()
+    if (!hasConnected)
+    {
+        qDebug() << "Local socket connection failed:" << socket->errorString();
+        emit connectionFailed();
+    }
+}
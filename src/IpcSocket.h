@@ -0,0 +1,82 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#ifndef IPCSOCKET_H
+#define IPCSOCKET_H
+
+#include <QObject>
+#include <QLocalSocket>
+#include <QJsonObject>
+
+/* Binary framed JSON messages over a local socket.
+ * Each frame is a 4 bytes big endian length, a type byte and the encoded
+ * message. Both ends first exchange a Hello frame telling the encoding they
+ * use, the connection is only used when both agree on it.
+ */
+class IpcSocket: public QObject
+{
+    Q_OBJECT
+public:
+    enum FrameType
+    {
+        FrameHello = 1,
+        FrameJson = 2,
+    };
+
+    //Client side, connects with connectToServer()
+    explicit IpcSocket(QObject *parent = nullptr);
+    //Server side, takes ownership of an accepted socket
+    explicit IpcSocket(QLocalSocket *socket, QObject *parent = nullptr);
+    virtual ~IpcSocket();
+
+    void connectToServer(const QString &name);
+    void close();
+    bool isConnected() const;
+
+    void sendHello(QJsonObject obj = QJsonObject());
+    void sendJson(const QJsonObject &obj);
+
+    //Local socket the daemon listens on, the systemd one if it exists
+    static QString daemonSocketName();
+    //Name of the encoding used for frames by this build
+    static QString encodingName();
+    static QByteArray encodeFrame(FrameType type, const QJsonObject &obj);
+    //Decodes the frame starting at pos and moves pos after it. Returns false
+    //if more data is needed, or with error set if the frame is invalid.
+    static bool takeFrame(const QByteArray &buffer, int &pos, FrameType &type, QJsonObject &obj, bool &error);
+
+signals:
+    void connected();
+    void disconnected();
+    void connectionFailed();
+    void helloReceived(const QJsonObject &obj);
+    void jsonReceived(const QJsonObject &obj);
+
+private slots:
+    void readFrames();
+    void onError(QLocalSocket::LocalSocketError err);
+
+private:
+    void setupSocket();
+
+    QLocalSocket *socket = nullptr;
+    bool hasConnected = false;
+    QByteArray readBuffer;
+};
+
+#endif // IPCSOCKET_H
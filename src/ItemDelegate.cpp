@@ -12,7 +12,8 @@
 #include "AppGui.h"
 
 ItemDelegate::ItemDelegate(QWidget* parent):
-    QStyledItemDelegate(parent)
+    QStyledItemDelegate(parent),
+    m_starColor(AppGui::qtAwesome()->defaultOption("color").value<QColor>())
 {
 }
 
@@ -54,39 +55,32 @@ void ItemDelegate::paintServiceItem(QPainter *painter, const QStyleOptionViewIte
 
 void ItemDelegate::paintFavorite(QPainter *painter, const QStyleOptionViewItem &option, int iFavorite) const
 {
-    QFont f = loginFont();
+    if (iFavorite == Common::FAV_NOT_SET)
+        return;
 
-    QIcon star = AppGui::qtAwesome()->icon(fa::star);
     QSize iconSz = QSize(option.rect.height(), option.rect.height());
     QPoint pos = option.rect.topLeft() + QPoint(0, -(option.rect.height()-iconSz.height())/2);
     QRect iconRect(pos, iconSz);
 
-    if (iFavorite != Common::FAV_NOT_SET)
-        star.paint(painter, iconRect);
+    // Glyphs are rendered once by QtAwesome and then reused for every row
+    painter->drawPixmap(iconRect, AppGui::qtAwesome()->pixmap(fa::star, m_starColor, iconSz,
+                                                               painter->device()->devicePixelRatioF()));
 
     // Fav number
-    f = favFont();
-    painter->setFont(f);
-    QString sFavNumber = QString::number(iFavorite + 1);
+    painter->setFont(favFont());
     QPen pen = painter->pen();
-    pen.setColor(QColor("white"));
+    pen.setColor(QColor(Qt::white));
     painter->setPen(pen);
-
-    if (iFavorite != Common::FAV_NOT_SET)
-        painter->drawText(iconRect, Qt::AlignCenter , sFavNumber);
+    painter->drawText(iconRect, Qt::AlignCenter, QString::number(iFavorite + 1));
 }
 
 void ItemDelegate::paintArrow(QPainter *painter, const QStyleOptionViewItem &option) const
 {
-    QIcon arrow = AppGui::qtAwesome()->icon(fa::arrowcircleright
-                                    , {{ "color", QColor("#0097a7") }
-                                    , { "color-selected", QColor("#0097a7") }
-                                    , { "color-active", QColor("#0097a7") }});
-
     QPoint arrowPos(option.rect.topLeft() + QPoint(option.rect.height()*1/2, 0));
     QSize arrowSz(QSize(option.rect.height(), option.rect.height()));
     QRect arrowRec(arrowPos, arrowSz);
-    arrow.paint(painter, arrowRec);
+    painter->drawPixmap(arrowRec, AppGui::qtAwesome()->pixmap(fa::arrowcircleright, QColor(0x00, 0x97, 0xa7), arrowSz,
+                                                              painter->device()->devicePixelRatioF()));
 }
 
 void ItemDelegate::paintLoginItem(QPainter *painter, const QStyleOptionViewItem &option,  const LoginItem *pLoginItem) const
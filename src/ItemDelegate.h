@@ -3,6 +3,7 @@
 
 // Qt
 #include <QStyledItemDelegate>
+#include <QColor>
 
 // Application
 class ServiceItem;
@@ -25,6 +26,8 @@ private:
     void paintArrow(QPainter *painter, const QStyleOptionViewItem &option) const;
     QFont loginFont() const;
     QFont favFont() const;
+
+    QColor m_starColor;
 };
 
 
@@ -0,0 +1,132 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#include "LogModel.h"
+
+LogModel::LogModel(int capacity, QObject *parent) :
+    QAbstractListModel(parent),
+    m_capacity(capacity)
+{
+    m_lines.resize(m_capacity);
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_count;
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_count)
+        return QVariant();
+
+    const LogLine &line = lineAt(index.row());
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        return line.text;
+    case Qt::ForegroundRole:
+        return line.color.isValid() ? QVariant(line.color) : QVariant();
+    case LevelRole:
+        return line.level;
+    default:
+        return QVariant();
+    }
+}
+
+void LogModel::appendLines(const QVector<LogLine> &lines)
+{
+    if (lines.isEmpty())
+        return;
+
+    //Lines that would be dropped right away are never inserted
+    const LogLine *src = lines.constData();
+    int count = lines.size();
+    if (count > m_capacity)
+    {
+        src += count - m_capacity;
+        count = m_capacity;
+    }
+
+    const int overflow = m_count + count - m_capacity;
+    if (overflow > 0)
+    {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        m_first = (m_first + overflow) % m_capacity;
+        m_count -= overflow;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), m_count, m_count + count - 1);
+    for (int i = 0; i < count; ++i)
+        m_lines[(m_first + m_count + i) % m_capacity] = src[i];
+    m_count += count;
+    endInsertRows();
+}
+
+void LogModel::clear()
+{
+    beginResetModel();
+    for (int i = 0; i < m_count; ++i)
+        m_lines[(m_first + i) % m_capacity] = LogLine();
+    m_first = 0;
+    m_count = 0;
+    endResetModel();
+}
+
+const LogLine &LogModel::lineAt(int row) const
+{
+    return m_lines.at((m_first + row) % m_capacity);
+}
+
+LogFilterModel::LogFilterModel(QObject *parent) :
+    QSortFilterProxyModel(parent)
+{
+    setDynamicSortFilter(true);
+}
+
+void LogFilterModel::setMinimumLevel(int level)
+{
+    if (m_minimumLevel == level)
+        return;
+    m_minimumLevel = level;
+    invalidateFilter();
+}
+
+void LogFilterModel::setSearchText(const QString &text)
+{
+    if (m_searchText == text)
+        return;
+    m_searchText = text;
+    invalidateFilter();
+}
+
+bool LogFilterModel::isFiltering() const
+{
+    return m_minimumLevel > LogLine::LevelDebug || !m_searchText.isEmpty();
+}
+
+bool LogFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    const QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
+    if (index.data(LogModel::LevelRole).toInt() < m_minimumLevel)
+        return false;
+
+    return m_searchText.isEmpty() ||
+           index.data(Qt::DisplayRole).toString().contains(m_searchText, Qt::CaseInsensitive);
+}
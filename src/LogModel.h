@@ -0,0 +1,98 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#ifndef LOGMODEL_H
+#define LOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QSortFilterProxyModel>
+#include <QColor>
+#include <QVector>
+
+struct LogLine
+{
+    enum Level
+    {
+        LevelDebug = 0,
+        LevelInfo,
+        LevelWarning,
+        LevelCritical,
+        LevelFatal,
+    };
+
+    QString text;
+    QColor color;
+    int level = LevelDebug;
+};
+Q_DECLARE_METATYPE(LogLine)
+
+/**
+ * @brief The LogModel class
+ * Log lines stored in a fixed size ring buffer, oldest lines are
+ * dropped once the capacity is reached. Lines are appended by batch
+ * so views only relayout once per batch.
+ */
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    enum LogRole
+    {
+        LevelRole = Qt::UserRole + 1,
+    };
+
+    explicit LogModel(int capacity, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void appendLines(const QVector<LogLine> &lines);
+    void clear();
+
+private:
+    const LogLine &lineAt(int row) const;
+
+    QVector<LogLine> m_lines;
+    int m_capacity;
+    int m_first = 0;
+    int m_count = 0;
+};
+
+/**
+ * @brief The LogFilterModel class
+ * Filters log lines on a minimum level and a search string
+ */
+class LogFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+public:
+    explicit LogFilterModel(QObject *parent = nullptr);
+
+    void setMinimumLevel(int level);
+    void setSearchText(const QString &text);
+    bool isFiltering() const;
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    int m_minimumLevel = LogLine::LevelDebug;
+    QString m_searchText;
+};
+
+#endif // LOGMODEL_H
@@ -0,0 +1,83 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#include "LogParser.h"
+
+LogParser::LogParser(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void LogParser::parse(const QByteArray &data)
+{
+    m_pending.append(data);
+    const int end = m_pending.lastIndexOf('\n');
+    if (end < 0)
+        return;
+
+    QString text = QString::fromUtf8(m_pending.constData(), end + 1);
+    m_pending.remove(0, end + 1);
+    text.replace(QLatin1String("\r\n"), QLatin1String("\n"));
+
+    //Parse the whole batch at once, formats are then split by line
+    QVector<LogLine> lines;
+    LogLine current;
+    for (const Utils::FormattedText &segment : m_escapeCodeHandler.parseText(Utils::FormattedText(text)))
+    {
+        int start = 0;
+        while (start <= segment.text.size())
+        {
+            int newline = segment.text.indexOf(QLatin1Char('\n'), start);
+            const int len = (newline < 0 ? segment.text.size() : newline) - start;
+            if (len > 0)
+            {
+                if (!current.color.isValid() && segment.format.hasProperty(QTextFormat::ForegroundBrush))
+                    current.color = segment.format.foreground().color();
+                current.text.append(segment.text.midRef(start, len));
+            }
+            if (newline < 0)
+                break;
+
+            current.level = levelFromText(current.text, m_lastLevel);
+            m_lastLevel = current.level;
+            lines.append(current);
+            current = LogLine();
+            start = newline + 1;
+        }
+    }
+
+    if (!lines.isEmpty())
+        emit linesParsed(lines);
+}
+
+int LogParser::levelFromText(const QString &text, int previousLevel)
+{
+    if (text.startsWith(QLatin1String("DEBUG:")))
+        return LogLine::LevelDebug;
+    if (text.startsWith(QLatin1String("INFO:")))
+        return LogLine::LevelInfo;
+    if (text.startsWith(QLatin1String("WARNING:")))
+        return LogLine::LevelWarning;
+    if (text.startsWith(QLatin1String("CRITICAL:")))
+        return LogLine::LevelCritical;
+    if (text.startsWith(QLatin1String("FATAL:")))
+        return LogLine::LevelFatal;
+
+    //Continuation of a multi line message
+    return previousLevel;
+}
@@ -0,0 +1,52 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#ifndef LOGPARSER_H
+#define LOGPARSER_H
+
+#include <QObject>
+#include "LogModel.h"
+#include "AnsiEscapeCodeHandler.h"
+
+/**
+ * @brief The LogParser class
+ * Splits raw daemon log data into lines and strips ANSI escape codes,
+ * meant to live in a worker thread. Incomplete trailing lines are kept
+ * until the rest of the line is received.
+ */
+class LogParser : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LogParser(QObject *parent = nullptr);
+
+public slots:
+    void parse(const QByteArray &data);
+
+signals:
+    void linesParsed(const QVector<LogLine> &lines);
+
+private:
+    static int levelFromText(const QString &text, int previousLevel);
+
+    Utils::AnsiEscapeCodeHandler m_escapeCodeHandler;
+    QByteArray m_pending;
+    int m_lastLevel = LogLine::LevelDebug;
+};
+
+#endif // LOGPARSER_H
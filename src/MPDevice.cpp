@@ -23,17 +23,35 @@
 #include "MessageProtocol/MessageProtocolBLE.h"
 #include "MPDeviceBleImpl.h"
 #include "BleCommon.h"
+#include "AeadCrypt/AeadCrypt.h"
 
 const QRegularExpression regVersion("v([0-9]+)\\.([0-9]+)(.*)");
 
+//Status polling, see scheduleNextStatusPoll()
+constexpr int STATUS_POLL_FIXED_MS = 500;
+constexpr int STATUS_POLL_MIN_MS = 200;
+//Idle polling never gets slower than the fixed poll, lock and card
+//removal must be noticed as fast as before
+constexpr int STATUS_POLL_MAX_MS = STATUS_POLL_FIXED_MS;
+//how long to keep polling fast after a status change or a command
+constexpr int STATUS_POLL_FAST_WINDOW_MS = 10000;
+
 MPDevice::MPDevice(QObject *parent):
     QObject(parent)
 {
     set_status(Common::UnknownStatus);
     set_memMgmtMode(false); //by default device is not in MMM
 
+    QSettings settings;
+    statusPollAdaptive = settings.value("settings/status_poll_adaptive", true).toBool();
+    statusPollMinMs = settings.value("settings/status_poll_min_ms", STATUS_POLL_MIN_MS).toInt();
+    statusPollMaxMs = settings.value("settings/status_poll_max_ms", STATUS_POLL_MAX_MS).toInt();
+    statusPollMinMs = qBound(50, statusPollMinMs, STATUS_POLL_MAX_MS);
+    statusPollMaxMs = qBound(statusPollMinMs, statusPollMaxMs, STATUS_POLL_MAX_MS);
+    statusPollLastActivity = QDateTime::currentMSecsSinceEpoch();
+
     statusTimer = new QTimer(this);
-    statusTimer->start(500);
+    statusTimer->start(statusPollAdaptive? statusPollMinMs : STATUS_POLL_FIXED_MS);
     connect(statusTimer, &QTimer::timeout, [this]()
     {
         //Do not interfer with any other operation by sending a MOOLTIPASS_STATUS command
@@ -46,60 +64,8 @@ MPDevice::MPDevice(QObject *parent):
                 return;
 
             /* Map status from received val */
-            Common::MPStatus s = pMesProt->getStatus(data);
-            Common::MPStatus prevStatus = get_status();
-
-            /* Trigger on status change */
-            if (s != prevStatus)
-            {
-                qDebug() << "received MPCmd::MOOLTIPASS_STATUS: " << static_cast<int>(s);
-
-                /* Update status */
-                set_status(s);
-
-                if (prevStatus == Common::UnknownStatus)
-                {
-                    QTimer::singleShot(10, [this]()
-                    {
-                        /* First start: load parameters */
-                        if (!isBLE())
-                        {
-                            loadParameters();
-                        }
-                        setCurrentDate();
-                    });
-                }
-
-                if ((s == Common::Unlocked) || (s == Common::UnkownSmartcad))
-                {
-                    QTimer::singleShot(20, [this]()
-                    {
-                        if (!isBLE())
-                        {
-                            getCurrentCardCPZ();
-                        }
-                    });
-                }
-                else
-                {
-                    filesCache.resetState();
-                }
-
-                if (s == Common::Unlocked)
-                {
-                    /* If v1.2 firmware, query user change number */
-                    QTimer::singleShot(50, [this]()
-                    {
-                        if (isFw12())
-                        {
-                            qInfo() << "Firmware above v1.2, requesting change numbers";
-                            getChangeNumbers();
-                        }
-                        else
-                            qInfo() << "Firmware below v1.2, do not request change numbers";
-                    });
-                }
-            }
+            bool changed = updateStatus(pMesProt->getStatus(data));
+            scheduleNextStatusPoll(changed);
         });
     });
 
@@ -115,6 +81,122 @@ MPDevice::~MPDevice()
     delete bleImpl;
 }
 
+bool MPDevice::updateStatus(Common::MPStatus s)
+{
+    Common::MPStatus prevStatus = get_status();
+
+    /* Trigger on status change */
+    if (s == prevStatus)
+        return false;
+
+    qDebug() << "received MPCmd::MOOLTIPASS_STATUS: " << static_cast<int>(s);
+
+    /* Update status */
+    set_status(s);
+
+    if (prevStatus == Common::UnknownStatus)
+    {
+        QTimer::singleShot(10, [this]()
+        {
+            /* First start: load parameters */
+            if (!isBLE())
+            {
+                loadParameters();
+            }
+            setCurrentDate();
+        });
+    }
+
+    if ((s == Common::Unlocked) || (s == Common::UnkownSmartcad))
+    {
+        QTimer::singleShot(20, [this]()
+        {
+            if (!isBLE())
+            {
+                getCurrentCardCPZ();
+            }
+        });
+    }
+    else
+    {
+        filesCache.resetState();
+    }
+
+    if (s == Common::Unlocked)
+    {
+        /* If v1.2 firmware, query user change number */
+        QTimer::singleShot(50, [this]()
+        {
+            if (isFw12())
+            {
+                qInfo() << "Firmware above v1.2, requesting change numbers";
+                getChangeNumbers();
+            }
+            else
+                qInfo() << "Firmware below v1.2, do not request change numbers";
+        });
+    }
+
+    return true;
+}
+
+void MPDevice::scheduleNextStatusPoll(bool statusChanged)
+{
+    if (!statusPollAdaptive)
+        return;
+
+    if (statusChanged)
+        statusPollLastActivity = QDateTime::currentMSecsSinceEpoch();
+
+    int interval;
+    if (get_status() == Common::LockedScreen ||
+        QDateTime::currentMSecsSinceEpoch() - statusPollLastActivity < STATUS_POLL_FAST_WINDOW_MS)
+    {
+        //Card/PIN events or recent user interaction, stay responsive
+        interval = statusPollMinMs;
+    }
+    else
+    {
+        //Idle and stable: back off exponentially, up to the fixed poll interval
+        interval = qMin(statusTimer->interval() * 2, statusPollMaxMs);
+    }
+
+    if (interval != statusTimer->interval())
+        statusTimer->setInterval(interval);
+}
+
+void MPDevice::statusPollActivity()
+{
+    statusPollLastActivity = QDateTime::currentMSecsSinceEpoch();
+
+    //Only restart when backed off, commands are sent at a high rate in MMM
+    if (statusPollAdaptive && statusTimer->isActive() &&
+        statusTimer->interval() > statusPollMinMs)
+        statusTimer->start(statusPollMinMs);
+}
+
+void MPDevice::setStatusPollPolicy(bool adaptive, int minMs, int maxMs)
+{
+    statusPollAdaptive = adaptive;
+    statusPollMinMs = qBound(50, minMs, STATUS_POLL_MAX_MS);
+    statusPollMaxMs = qBound(statusPollMinMs, maxMs, STATUS_POLL_MAX_MS);
+
+    QSettings settings;
+    settings.setValue("settings/status_poll_adaptive", statusPollAdaptive);
+    settings.setValue("settings/status_poll_min_ms", statusPollMinMs);
+    settings.setValue("settings/status_poll_max_ms", statusPollMaxMs);
+
+    qInfo() << "Status poll policy:" << (adaptive? "adaptive" : "fixed")
+            << statusPollMinMs << "-" << statusPollMaxMs << "ms";
+
+    if (statusTimer->isActive())
+        statusTimer->start(statusPollAdaptive? statusPollMinMs : STATUS_POLL_FIXED_MS);
+    else
+        statusTimer->setInterval(statusPollAdaptive? statusPollMinMs : STATUS_POLL_FIXED_MS);
+
+    emit statusPollPolicyChanged();
+}
+
 void MPDevice::setupMessageProtocol()
 {
     if (isBLE())
@@ -181,6 +263,9 @@ void MPDevice::sendData(MPCmd::Command c, const QByteArray &data, quint32 timeou
     cmd.retries_done = 0;
     cmd.sent_ts = QDateTime::currentMSecsSinceEpoch();
 
+    if (c != MPCmd::MOOLTIPASS_STATUS)
+        statusPollActivity();
+
     if (!isBLE())
     {
         cmd.timerTimeout = new QTimer(this);
@@ -297,6 +382,15 @@ void MPDevice::newDataRead(const QByteArray &data)
     // First if: Resend the command, if device ask for retrying
     // Second if: Special case: if command check was requested but the device returned a mooltipass status (user entering his PIN), resend packet
     const auto dataCommand = pMesProt->getCommand(data);
+
+    //The Mini answers with its status while the user is busy on the device
+    //(ie. entering his PIN), use it instead of waiting for the next poll
+    if (!isBLE() &&
+        dataCommand == MPCmd::MOOLTIPASS_STATUS &&
+        currentCommand != MPCmd::MOOLTIPASS_STATUS &&
+        updateStatus(pMesProt->getStatus(data)))
+        statusPollActivity();
+
     if ((dataCommand == MPCmd::PLEASE_RETRY) ||
         (currentCmd.checkReturn &&
         currentCommand != MPCmd::MOOLTIPASS_STATUS &&
@@ -363,17 +457,17 @@ void MPDevice::newDataRead(const QByteArray &data)
     }
 
 #ifdef DEV_DEBUG
-    QString resMsg = "Received answer: ";
     if (isBLE() && !bleImpl->isFirstPacket(data))
     {
-        resMsg += pMesProt->printCmd(pMesProt->getCommand(currentCmd.data[0]));
+        qCDebug(lcDevicePacket) << "Received answer: " << pMesProt->printCmd(pMesProt->getCommand(currentCmd.data[0]))
+                                << " Full packet:" << data.toHex();
     }
     else
     {
-        qDebug() << "Message payload length:" << pMesProt->getMessageSize(data);
-        resMsg += pMesProt->printCmd(dataCommand);
+        qCDebug(lcDevicePacket) << "Message payload length:" << pMesProt->getMessageSize(data);
+        qCDebug(lcDevicePacket) << "Received answer: " << pMesProt->printCmd(dataCommand)
+                                << " Full packet:" << data.toHex();
     }
-    qDebug() << resMsg << " Full packet:" << data.toHex();
 #endif
 
     /**
@@ -406,7 +500,8 @@ void MPDevice::newDataRead(const QByteArray &data)
                 constexpr int EXTRA_INFO_SIZE = 6;
                 int fullResponseSize = commandQueue.head().responseSize + EXTRA_INFO_SIZE;
                 QByteArray responseData = commandQueue.head().response;
-                responseData.append(pMesProt->getFullPayload(data).left(fullResponseSize - responseData.size()));
+                const PayloadView payload = pMesProt->getPayloadView(data);
+                responseData.append(payload.data, qBound(0, fullResponseSize - responseData.size(), payload.size));
                 dataReceived = responseData;
             }
         }
@@ -414,7 +509,8 @@ void MPDevice::newDataRead(const QByteArray &data)
         {
             if (!isFirst)
             {
-                commandQueue.head().response.append(pMesProt->getFullPayload(data));
+                const PayloadView payload = pMesProt->getPayloadView(data);
+                commandQueue.head().response.append(payload.data, payload.size);
             }
             commandQueue.head().checkReturn = false;
             return;
@@ -447,7 +543,7 @@ void MPDevice::sendDataDequeue()
 
 #ifdef DEV_DEBUG
     int i = 0;
-    qDebug() << "Platform send command: " << pMesProt->printCmd(currentCmd.data[0]);
+    qCDebug(lcDevicePacket) << "Platform send command: " << pMesProt->printCmd(currentCmd.data[0]);
 #endif
     // send data with platform code
     for (const auto &data : currentCmd.data)
@@ -462,7 +558,7 @@ void MPDevice::sendDataDequeue()
         }
         a += "]";
 
-        qDebug() << "Full packet#" << i++ << ": " << a;
+        qCDebug(lcDevicePacket) << "Full packet#" << i++ << ": " << a;
 #endif
 
         platformWrite(data);
@@ -522,72 +618,20 @@ void MPDevice::updateFilesCache()
 
 void MPDevice::addFileToCache(QString fileName, int size)
 {
-    QVariantMap item;
-    item.insert("name", fileName);
-    item.insert("size", size);
-
-    // Add file name at proper position
-    auto cache = filesCache.load();
-    for (qint32 i = 0; i < cache.length(); i++)
-    {
-        if (cache[i].value("name").toString().compare(fileName) == 0)
-        {
-            // the file is already in cache, this is just and update
-            return;
-        }
-
-
-        if (cache[i].value("name").toString().compare(fileName) > 0)
-        {
-            cache.insert(i, item);
-            filesCache.save(cache);
-            emit filesCacheChanged();
-            return;
-        }
-    }
-
-    cache.append(item);
-    filesCache.save(cache);
-    emit filesCacheChanged();
+    // The file may already be in cache, this is just and update
+    if (filesCache.addFile(fileName, size))
+        emit filesCacheChanged();
 }
 
 void MPDevice::updateFileInCache(QString fileName, int size)
 {
-    auto cache = filesCache.load();
-    bool updated = false;
-    for (int i = 0; i < cache.length() && !updated; i ++)
-    {
-        auto item = cache.at(i);
-        if (item.value("name").toString().compare(fileName) == 0)
-        {
-            int revision = item.value("revision").toInt();
-            item.insert("revision", revision  + 1);
-            item.insert("size", size);
-
-            cache.replace(i, item);
-            updated = true;
-        }
-    }
-
-    if (updated)
-    {
-        filesCache.save(cache);
+    if (filesCache.updateFile(fileName, size))
         emit filesCacheChanged();
-    }
 }
 
 void MPDevice::removeFileFromCache(QString fileName)
 {
-    auto cache = filesCache.load();
-    int i = 0;
-    for (; i < cache.length(); i++)
-        if (cache.at(i).value("name").toString().compare(fileName) == 0)
-            break;
-
-    if (i < cache.length())
-        cache.removeAt(i);
-
-    filesCache.save(cache);
+    filesCache.removeFile(fileName);
     emit filesCacheChanged();
 }
 
@@ -598,9 +642,14 @@ void MPDevice::loadParameters()
                           "Loading device parameters",
                           this);
 
+    //Fast start: read the serial number first and send the parameters cached
+    //for it right away, the reads below then refresh them in the background
+    QSettings settings;
+    const bool fastStart = settings.value("settings/params_fast_start", true).toBool();
+
     jobs->append(new MPCommandJob(this,
                                   MPCmd::VERSION,
-                                  [this](const QByteArray &data, bool &) -> bool
+                                  [this, jobs, fastStart](const QByteArray &data, bool &) -> bool
     {
         const auto flashSize = pMesProt->getFirstPayloadByte(data);
         qDebug() << "received MP version FLASH size: " << flashSize << "Mb";
@@ -622,6 +671,18 @@ void MPDevice::loadParameters()
             }
         }
 
+        if (fastStart && isFw12() && isMini())
+        {
+            jobs->prepend(new MPCommandJob(this,
+                                           MPCmd::GET_SERIAL,
+                                           [this](const QByteArray &data, bool &) -> bool
+            {
+                set_serialNumber(pMesProt->getSerialNumber(data));
+                loadParametersCache();
+                return true;
+            }));
+        }
+
         return true;
     }));
 
@@ -873,8 +934,15 @@ void MPDevice::loadParameters()
         //data is last result
         //all jobs finished success
         qInfo() << "Finished loading device options";
+        Common::markStartupPhase("device_params");
 
-        if (isFw12() && isMini())
+        if (isFw12() && isMini() && get_serialNumber() != 0)
+        {
+            //Already read for the fast start
+            readingParams = false;
+            saveParametersCache();
+        }
+        else if (isFw12() && isMini())
         {
             qInfo() << "Mini firmware above v1.2, requesting serial number";
 
@@ -898,6 +966,7 @@ void MPDevice::loadParameters()
                 //all jobs finished success
                 readingParams = false;
                 qInfo() << "Finished loading Mini serial number";
+                saveParametersCache();
             });
 
             connect(v12jobs, &AsyncJobs::failed, [this](AsyncJob *failedJob)
@@ -924,6 +993,47 @@ void MPDevice::loadParameters()
     runAndDequeueJobs();
 }
 
+//Parameters read by loadParameters(), by property name
+//hwVersion and flashMbSize are not cached, VERSION already read them
+//from the device when the cache is applied
+static const char * const CACHED_PARAMS[] = {
+    "keyboardLayout", "lockTimeoutEnabled", "lockTimeout",
+    "screensaver", "userRequestCancel", "userInteractionTimeout", "flashScreen",
+    "offlineMode", "tutorialEnabled", "screenBrightness", "knockEnabled",
+    "knockSensitivity", "randomStartingPin", "hashDisplay", "lockUnlockMode",
+    "keyAfterLoginSendEnable", "keyAfterLoginSend", "keyAfterPassSendEnable",
+    "keyAfterPassSend", "delayAfterKeyEntryEnable", "delayAfterKeyEntry",
+};
+
+void MPDevice::loadParametersCache()
+{
+    QSettings settings;
+    QVariantMap params = settings.value(QStringLiteral("params_cache/%1").arg(get_serialNumber())).toMap();
+    if (params.isEmpty())
+        return;
+
+    //Each property setter notifies the clients of its param
+    for (const char *name: CACHED_PARAMS)
+    {
+        if (params.contains(name))
+            setProperty(name, params.value(name));
+    }
+    Common::markStartupPhase("device_params_cached");
+}
+
+void MPDevice::saveParametersCache()
+{
+    if (get_serialNumber() == 0)
+        return;
+
+    QVariantMap params;
+    for (const char *name: CACHED_PARAMS)
+        params[name] = property(name);
+
+    QSettings settings;
+    settings.setValue(QStringLiteral("params_cache/%1").arg(get_serialNumber()), params);
+}
+
 void MPDevice::updateParam(MPParams::Param param, int val)
 {
     QMetaEnum m = QMetaEnum::fromType<MPParams::Param>();
@@ -1044,20 +1154,22 @@ void MPDevice::updateDelayAfterKeyEntry(int val)
     updateParam(MPParams::DELAY_AFTER_KEY_ENTRY_PARAM, val);
 }
 
-void MPDevice::updateKnockSensitivity(int s) // 0-very low, 1-low, 2-medium, 3-high
+static quint8 knockThreshold(int s)
 {
-    quint8 v;
     switch(s)
     {
-    case 0: v = KNOCKING_VERY_LOW; break;
-    case 1: v = KNOCKING_LOW; break;
-    case 2: v = KNOCKING_MEDIUM; break;
-    case 3: v = KNOCKING_HIGH; break;
+    case 0: return KNOCKING_VERY_LOW;
+    case 1: return KNOCKING_LOW;
+    case 2: return KNOCKING_MEDIUM;
+    case 3: return KNOCKING_HIGH;
     default:
-        v = KNOCKING_MEDIUM;
+        return KNOCKING_MEDIUM;
     }
+}
 
-    updateParam(MPParams::MINI_KNOCK_THRES_PARAM, v);
+void MPDevice::updateKnockSensitivity(int s) // 0-very low, 1-low, 2-medium, 3-high
+{
+    updateParam(MPParams::MINI_KNOCK_THRES_PARAM, knockThreshold(s));
 }
 
 void MPDevice::updateRandomStartingPin(bool en)
@@ -1075,6 +1187,112 @@ void MPDevice::updateLockUnlockMode(int val)
     updateParam(MPParams::LOCK_UNLOCK_FEATURE_PARAM, val);
 }
 
+//Writable parameters, by property name
+static const struct
+{
+    const char *property;
+    MPParams::Param param;
+} DEVICE_PARAMS[] = {
+    { "keyboardLayout", MPParams::KEYBOARD_LAYOUT_PARAM },
+    { "lockTimeoutEnabled", MPParams::LOCK_TIMEOUT_ENABLE_PARAM },
+    { "lockTimeout", MPParams::LOCK_TIMEOUT_PARAM },
+    { "screensaver", MPParams::SCREENSAVER_PARAM },
+    { "userRequestCancel", MPParams::USER_REQ_CANCEL_PARAM },
+    { "userInteractionTimeout", MPParams::USER_INTER_TIMEOUT_PARAM },
+    { "flashScreen", MPParams::FLASH_SCREEN_PARAM },
+    { "offlineMode", MPParams::OFFLINE_MODE_PARAM },
+    { "tutorialEnabled", MPParams::TUTORIAL_BOOL_PARAM },
+    { "screenBrightness", MPParams::MINI_OLED_CONTRAST_CURRENT_PARAM },
+    { "knockEnabled", MPParams::MINI_KNOCK_DETECT_ENABLE_PARAM },
+    { "knockSensitivity", MPParams::MINI_KNOCK_THRES_PARAM },
+    { "randomStartingPin", MPParams::RANDOM_INIT_PIN_PARAM },
+    { "hashDisplay", MPParams::HASH_DISPLAY_FEATURE_PARAM },
+    { "lockUnlockMode", MPParams::LOCK_UNLOCK_FEATURE_PARAM },
+    { "keyAfterLoginSendEnable", MPParams::KEY_AFTER_LOGIN_SEND_BOOL_PARAM },
+    { "keyAfterLoginSend", MPParams::KEY_AFTER_LOGIN_SEND_PARAM },
+    { "keyAfterPassSendEnable", MPParams::KEY_AFTER_PASS_SEND_BOOL_PARAM },
+    { "keyAfterPassSend", MPParams::KEY_AFTER_PASS_SEND_PARAM },
+    { "delayAfterKeyEntryEnable", MPParams::DELAY_AFTER_KEY_ENTRY_BOOL_PARAM },
+    { "delayAfterKeyEntry", MPParams::DELAY_AFTER_KEY_ENTRY_PARAM },
+};
+
+void MPDevice::updateParams(const QVariantMap &params, const MessageHandlerCb &cb)
+{
+    if (params.isEmpty())
+    {
+        cb(true, QString());
+        return;
+    }
+
+    AsyncJobs *jobs = new AsyncJobs("Updating device parameters", this);
+
+    //The values are compared when the queue starts, not when it is enqueued:
+    //a previous set or loadParameters() may still change them until then
+    CustomJob *diffJob = new CustomJob(jobs);
+    diffJob->setWork([this, jobs, diffJob, params]()
+    {
+        QVariantMap changed;
+
+        for (const auto &def: DEVICE_PARAMS)
+        {
+            if (!params.contains(def.property))
+                continue;
+
+            const QVariant current = property(def.property);
+            QVariant val = params.value(def.property);
+            if (current.type() == QVariant::Bool)
+                val = val.toBool();
+            else
+                val = qBound(0, val.toInt(), 0xFF);
+
+            if (val == current)
+                continue;
+            changed[def.property] = val;
+
+            quint8 deviceVal = static_cast<quint8>(val.toInt());
+            if (def.param == MPParams::MINI_KNOCK_THRES_PARAM)
+                deviceVal = knockThreshold(val.toInt());
+
+            QByteArray ba;
+            ba.append(static_cast<char>(def.param));
+            ba.append(static_cast<char>(deviceVal));
+            jobs->append(new MPCommandJob(this, MPCmd::SET_MOOLTIPASS_PARM, ba, pMesProt->getDefaultFuncDone()));
+        }
+
+        jobs->user_data = changed;
+        emit diffJob->done(QByteArray());
+    });
+    jobs->append(diffJob);
+
+    connect(jobs, &AsyncJobs::finished, [this, jobs, cb](const QByteArray &)
+    {
+        const QVariantMap changed = jobs->user_data.toMap();
+        if (changed.isEmpty())
+        {
+            cb(true, QString());
+            return;
+        }
+        qInfo() << changed.size() << "params updated with success";
+
+        //Only the params that really changed notify the clients
+        for (auto it = changed.constBegin();it != changed.constEnd();it++)
+            setProperty(qPrintable(it.key()), it.value());
+        saveParametersCache();
+        cb(true, QString());
+    });
+    connect(jobs, &AsyncJobs::failed, [this, cb](AsyncJob *)
+    {
+        qWarning() << "Failed to update params";
+
+        //Some params may have been written, read them all back
+        loadParameters();
+        cb(false, "Failed to update device parameters");
+    });
+
+    jobsQueue.enqueue(jobs);
+    runAndDequeueJobs();
+}
+
 void MPDevice::memMgmtModeReadFlash(AsyncJobs *jobs, bool fullScan,
                                     const MPDeviceProgressCb &cbProgress,bool getCreds,
                                     bool getData, bool getDataChilds)
@@ -1509,28 +1727,28 @@ void MPDevice::loadSingleNodeAndScan(AsyncJobs *jobs, const QByteArray &address,
                     {
                         case MPNode::NodeParent :
                         {
-                            qDebug() << address.toHex() << ": parent node loaded:" << pnode->getService();
+                            qCDebug(lcDeviceNode) << address.toHex() << ": parent node loaded:" << pnode->getService();
                             loginNodesClone.append(pnodeClone);
                             loginNodes.append(pnode);
                             break;
                         }
                         case MPNode::NodeChild :
                         {
-                            qDebug() << address.toHex() << ": child node loaded:" << pnode->getLogin();
+                            qCDebug(lcDeviceNode) << address.toHex() << ": child node loaded:" << pnode->getLogin();
                             loginChildNodesClone.append(pnodeClone);
                             loginChildNodes.append(pnode);
                             break;
                         }
                         case MPNode::NodeParentData :
                         {
-                            qDebug() << address.toHex() << ": data parent node loaded:" << pnode->getService() << "with start child addr:" << pnode->getStartChildAddress().toHex();
+                            qCDebug(lcDeviceNode) << address.toHex() << ": data parent node loaded:" << pnode->getService() << "with start child addr:" << pnode->getStartChildAddress().toHex();
                             dataNodesClone.append(pnodeClone);
                             dataNodes.append(pnode);
                             break;
                         }
                         case MPNode::NodeChildData :
                         {
-                            qDebug() << address.toHex() << ": data child node loaded";
+                            qCDebug(lcDeviceNode) << address.toHex() << ": data child node loaded";
                             dataChildNodesClone.append(pnodeClone);
                             dataChildNodes.append(pnode);
                             break;
@@ -1551,7 +1769,7 @@ void MPDevice::loadSingleNodeAndScan(AsyncJobs *jobs, const QByteArray &address,
 
 void MPDevice::loadLoginNode(AsyncJobs *jobs, const QByteArray &address, const MPDeviceProgressCb &cbProgress)
 {
-    qDebug() << "Loading cred parent node at address: " << address.toHex();
+    qCDebug(lcDeviceNode) << "Loading cred parent node at address: " << address.toHex();
 
     /* Create new parent node, append to list */
     MPNode *pnode = new MPNode(this, address);
@@ -1598,7 +1816,7 @@ void MPDevice::loadLoginNode(AsyncJobs *jobs, const QByteArray &address, const M
                 }
 
                 //Node is loaded
-                qDebug() << address.toHex() << ": parent node loaded:" << srv;
+                qCDebug(lcDeviceNode) << address.toHex() << ": parent node loaded:" << srv;
 
                 QVariantMap data = {
                     {"total", progressTotal},
@@ -1610,12 +1828,12 @@ void MPDevice::loadLoginNode(AsyncJobs *jobs, const QByteArray &address, const M
 
                 if (pnode->getStartChildAddress() != MPNode::EmptyAddress)
                 {
-                    qDebug() << srv << ": loading child nodes...";
+                    qCDebug(lcDeviceNode) << srv << ": loading child nodes...";
                     loadLoginChildNode(jobs, pnode, pnodeClone, pnode->getStartChildAddress());
                 }
                 else
                 {
-                    qDebug() << "Parent does not have childs.";
+                    qCDebug(lcDeviceNode) << "Parent does not have childs.";
                 }
 
                 //Load next parent
@@ -1632,7 +1850,7 @@ void MPDevice::loadLoginNode(AsyncJobs *jobs, const QByteArray &address, const M
 
 void MPDevice::loadLoginChildNode(AsyncJobs *jobs, MPNode *parent, MPNode *parentClone, const QByteArray &address)
 {
-    qDebug() << "Loading cred child node at address:" << address.toHex();
+    qCDebug(lcDeviceNode) << "Loading cred child node at address:" << address.toHex();
 
     /* Create empty child node and add it to the list */
     MPNode *cnode = new MPNode(this, address);
@@ -1669,7 +1887,7 @@ void MPDevice::loadLoginChildNode(AsyncJobs *jobs, MPNode *parent, MPNode *paren
             else
             {
                 //Node is loaded
-                qDebug() << address.toHex() << ": child node loaded:" << cnode->getLogin();
+                qCDebug(lcDeviceNode) << address.toHex() << ": child node loaded:" << cnode->getLogin();
 
                 //Load next child
                 if (cnode->getNextChildAddress() != MPNode::EmptyAddress)
@@ -1690,7 +1908,7 @@ void MPDevice::loadDataNode(AsyncJobs *jobs, const QByteArray &address, bool loa
     MPNode *pnodeClone = new MPNode(this, address);
     dataNodesClone.append(pnodeClone);
 
-    qDebug() << "Loading data parent node at address: " << address.toHex();
+    qCDebug(lcDeviceNode) << "Loading data parent node at address: " << address.toHex();
 
     jobs->append(new MPCommandJob(this, MPCmd::READ_FLASH_NODE,
                                   address,
@@ -1724,19 +1942,19 @@ void MPDevice::loadDataNode(AsyncJobs *jobs, const QByteArray &address, bool loa
             cbProgress(data);
 
             //Node is loaded
-            qDebug() << "Parent data node loaded: " << pnode->getService() << " at address " << pnode->getAddress().toHex() << " first child at " << pnode->getStartChildAddress().toHex();
+            qCDebug(lcDeviceNode) << "Parent data node loaded: " << pnode->getService() << " at address " << pnode->getAddress().toHex() << " first child at " << pnode->getStartChildAddress().toHex();
 
             //Load data child
             if (pnode->getStartChildAddress() != MPNode::EmptyAddress && load_childs)
             {
-                qDebug() << "Loading data child nodes...";
+                qCDebug(lcDeviceNode) << "Loading data child nodes...";
                 loadDataChildNode(jobs, pnode, pnodeClone, pnode->getStartChildAddress(), cbProgress, 0);
             }
             else
             {
                 if (pnode->getStartChildAddress() == MPNode::EmptyAddress)
                 {
-                    qDebug() << "Parent data node does not have childs.";
+                    qCDebug(lcDeviceNode) << "Parent data node does not have childs.";
                 }
             }
 
@@ -1760,7 +1978,7 @@ void MPDevice::loadDataChildNode(AsyncJobs *jobs, MPNode *parent, MPNode *parent
     parentClone->appendChildData(cnodeClone);
     dataChildNodesClone.append(cnodeClone);
 
-    qDebug() << "Loading data child node at address: " << address.toHex();
+    qCDebug(lcDeviceNode) << "Loading data child node at address: " << address.toHex();
 
     jobs->prepend(new MPCommandJob(this, MPCmd::READ_FLASH_NODE,
                                   address,
@@ -1786,7 +2004,7 @@ void MPDevice::loadDataChildNode(AsyncJobs *jobs, MPNode *parent, MPNode *parent
         else
         {
             //Node is loaded
-            qDebug() << "Child data node loaded";
+            qCDebug(lcDeviceNode) << "Child data node loaded";
 
             QVariantMap data = {
                 {"total", -1},
@@ -3525,7 +3743,7 @@ void MPDevice::addWriteNodePacketToJob(AsyncJobs *jobs, const QByteArray& addres
             }
         }));
 #ifdef DEV_DEBUG
-        qDebug() << "Write node packet #" << static_cast<quint8>(packet[2]) << " : " << packet.toHex();
+        qCDebug(lcDevicePacket) << "Write node packet #" << static_cast<quint8>(packet[2]) << " : " << packet.toHex();
 #endif
     }
 }
@@ -4935,21 +5153,23 @@ quint64 MPDevice::getUInt64EncryptionKey()
     return key;
 }
 
-QString MPDevice::encryptSimpleCrypt(const QByteArray &data)
+QByteArray MPDevice::decryptSimpleCrypt(const QString &payload)
 {
-    /* Encrypt payload */
     SimpleCrypt simpleCrypt;
     simpleCrypt.setKey(getUInt64EncryptionKey());
 
-    return simpleCrypt.encryptToString(data);
+    return simpleCrypt.decryptToByteArray(payload);
 }
 
-QByteArray MPDevice::decryptSimpleCrypt(const QString &payload)
+QByteArray MPDevice::decryptAead(const QString &payload)
 {
-    SimpleCrypt simpleCrypt;
-    simpleCrypt.setKey(getUInt64EncryptionKey());
+    AeadCrypt aeadCrypt(m_cardCPZ);
 
-    return simpleCrypt.decryptToByteArray(payload);
+    QByteArray data = aeadCrypt.decryptToByteArray(payload);
+    if (aeadCrypt.lastError() != AeadCrypt::ErrorNoError)
+        qWarning() << "Failed to decrypt payload, error" << aeadCrypt.lastError();
+
+    return data;
 }
 
 bool MPDevice::testCodeAgainstCleanDBChanges(AsyncJobs *jobs)
@@ -5112,129 +5332,41 @@ bool MPDevice::testCodeAgainstCleanDBChanges(AsyncJobs *jobs)
     return true;
 }
 
-QByteArray MPDevice::generateExportFileData(const QString &encryption)
+ExportFileGenerator::Snapshot MPDevice::exportSnapshot()
 {
-    QJsonArray exportTopArray = QJsonArray();
-
-    /* CTR */
-    exportTopArray.append(QJsonValue(Common::bytesToJsonObjectArray(ctrValue)));
-
-    /* CPZ/CTR packets */
-    QJsonArray cpzCtrQJsonArray = QJsonArray();
-    for (qint32 i = 0; i < cpzCtrValue.size(); i++)
-    {
-        cpzCtrQJsonArray.append(QJsonValue(Common::bytesToJsonObjectArray(cpzCtrValue[i])));
-    }
-    exportTopArray.append(QJsonValue(cpzCtrQJsonArray));
-
-    /* Starting parent */
-    exportTopArray.append(QJsonValue(Common::bytesToJson(startNode)));
-
-    /* Data starting parent */
-    exportTopArray.append(QJsonValue(Common::bytesToJson(startDataNode)));
-
-    /* Favorites */
-    QJsonArray favQJsonArray = QJsonArray();
-    for (qint32 i = 0; i < favoritesAddrs.size(); i++)
-    {
-        favQJsonArray.append(QJsonValue(Common::bytesToJsonObjectArray(favoritesAddrs[i])));
-    }
-    exportTopArray.append(QJsonValue(favQJsonArray));
-
-    /* Service nodes */
-    QJsonArray nodeQJsonArray = QJsonArray();
-    for (qint32 i = 0; i < loginNodes.size(); i++)
-    {
-        QJsonObject nodeObject = QJsonObject();
-        nodeObject["address"] = QJsonValue(Common::bytesToJson(loginNodes[i]->getAddress()));
-        nodeObject["name"] = QJsonValue(loginNodes[i]->getService());
-        nodeObject["data"] = QJsonValue(Common::bytesToJsonObjectArray(loginNodes[i]->getNodeData()));
-        nodeQJsonArray.append(QJsonValue(nodeObject));
-    }
-    exportTopArray.append(QJsonValue(nodeQJsonArray));
-
-    /* Child nodes */
-    nodeQJsonArray = QJsonArray();
-    for (qint32 i = 0; i < loginChildNodes.size(); i++)
-    {
-        QJsonObject nodeObject = QJsonObject();
-        nodeObject["address"] = QJsonValue(Common::bytesToJson(loginChildNodes[i]->getAddress()));
-        nodeObject["name"] = QJsonValue(loginChildNodes[i]->getLogin());
-        nodeObject["data"] = QJsonValue(Common::bytesToJsonObjectArray(loginChildNodes[i]->getNodeData()));
-        nodeObject["pointed"] = QJsonValue(false);
-        nodeQJsonArray.append(QJsonValue(nodeObject));
-    }
-    exportTopArray.append(QJsonValue(nodeQJsonArray));
-
-    /* Child nodes */
-    nodeQJsonArray = QJsonArray();
-    for (qint32 i = 0; i < dataNodes.size(); i++)
-    {
-        QJsonObject nodeObject = QJsonObject();
-        nodeObject["address"] = QJsonValue(Common::bytesToJson(dataNodes[i]->getAddress()));
-        nodeObject["name"] = QJsonValue(dataNodes[i]->getService());
-        nodeObject["data"] = QJsonValue(Common::bytesToJsonObjectArray(dataNodes[i]->getNodeData()));
-        nodeQJsonArray.append(QJsonValue(nodeObject));
-    }
-    exportTopArray.append(QJsonValue(nodeQJsonArray));
-
-    /* Child nodes */
-    nodeQJsonArray = QJsonArray();
-    for (qint32 i = 0; i < dataChildNodes.size(); i++)
-    {
-        QJsonObject nodeObject = QJsonObject();
-        nodeObject["address"] = QJsonValue(Common::bytesToJson(dataChildNodes[i]->getAddress()));
-        nodeObject["data"] = QJsonValue(Common::bytesToJsonObjectArray(dataChildNodes[i]->getNodeData()));
-        nodeObject["pointed"] = QJsonValue(false);
-        nodeQJsonArray.append(QJsonValue(nodeObject));
-    }
-    exportTopArray.append(QJsonValue(nodeQJsonArray));
-
-    /* identifier */
-    exportTopArray.append(QJsonValue(QString("moolticute")));
-
-    /* bundle version */
-    exportTopArray.append(QJsonValue((qint64)1));
-
-    /* Credential change number */
-    exportTopArray.append(QJsonValue((quint8)get_credentialsDbChangeNumber()));
-
-    /* Data change number */
-    exportTopArray.append(QJsonValue((quint8)get_dataDbChangeNumber()));
-
-    /* Mooltipass serial */
-    exportTopArray.append(QJsonValue((qint64)get_serialNumber()));
-
-    /* Generate file payload */
-    QJsonDocument payloadDoc(exportTopArray);
-    auto payload = payloadDoc.toJson();
-
-    qDebug() << "requested encryption for exported DB:" << encryption;
-
-    if (encryption.isEmpty() || encryption == "none")
-        return payload;
-
-    /* Export file content */
-    QJsonObject exportTopObject;
-
-    if (encryption == "SimpleCrypt") {
-        exportTopObject.insert("encryption", "SimpleCrypt");
-        exportTopObject.insert("payload", encryptSimpleCrypt(payload));
-    } else
-    {
-        // Fallback in case of an unknown encryption method where specified
-        qWarning() << "DB export: Unknown encryption " << encryption << "is asked, fallback to 'none'";
-        exportTopObject.insert("encryption", "none");
-        exportTopObject.insert("payload", QString(payload));
-    }
-
-    exportTopObject.insert("dataDbChangeNumber", QJsonValue((quint8)get_dataDbChangeNumber()));
-    exportTopObject.insert("credentialsDbChangeNumber", QJsonValue((quint8)get_credentialsDbChangeNumber()));
-
-    QJsonDocument fileContentDoc(exportTopObject);
-    payload = fileContentDoc.toJson();
-
-    return payload;
+    ExportFileGenerator::Snapshot snapshot;
+    snapshot.ctrValue = ctrValue;
+    snapshot.cpzCtrValue = cpzCtrValue;
+    snapshot.startNode = startNode;
+    snapshot.startDataNode = startDataNode;
+    snapshot.favoritesAddrs = favoritesAddrs;
+
+    /* Node data is implicitly shared, only names are decoded here */
+    snapshot.loginNodes.reserve(loginNodes.size());
+    for (MPNode *n: qAsConst(loginNodes))
+        snapshot.loginNodes.append({ n->getAddress(), n->getService(), n->getNodeData() });
+    snapshot.loginChildNodes.reserve(loginChildNodes.size());
+    for (MPNode *n: qAsConst(loginChildNodes))
+        snapshot.loginChildNodes.append({ n->getAddress(), n->getLogin(), n->getNodeData() });
+    snapshot.dataNodes.reserve(dataNodes.size());
+    for (MPNode *n: qAsConst(dataNodes))
+        snapshot.dataNodes.append({ n->getAddress(), n->getService(), n->getNodeData() });
+    snapshot.dataChildNodes.reserve(dataChildNodes.size());
+    for (MPNode *n: qAsConst(dataChildNodes))
+        snapshot.dataChildNodes.append({ n->getAddress(), QString(), n->getNodeData() });
+
+    snapshot.credentialsDbChangeNumber = get_credentialsDbChangeNumber();
+    snapshot.dataDbChangeNumber = get_dataDbChangeNumber();
+    snapshot.serialNumber = get_serialNumber();
+
+    snapshot.cardCPZ = m_cardCPZ;
+    snapshot.simpleCryptKey = getUInt64EncryptionKey();
+
+    /* Compression is block parallel, 0 disables it */
+    QSettings settings;
+    snapshot.compressionLevel = settings.value("settings/export_compression_level",
+                                               AeadCrypt::DEFAULT_COMPRESSION_LEVEL).toInt();
+    return snapshot;
 }
 
 bool MPDevice::readExportFile(const QByteArray &fileData, QString &errorString)
@@ -5280,10 +5412,11 @@ bool MPDevice::readExportFile(const QByteArray &fileData, QString &errorString)
         if ( importFile.contains("encryption") && importFile.contains("payload") )
         {
             auto encryptionMethod = importFile.value("encryption").toString();
-            if ( encryptionMethod == "SimpleCrypt")
+            if ( encryptionMethod == "SimpleCrypt" || encryptionMethod == "ChaCha20-Poly1305")
             {
                 QString payload = importFile.value("payload").toString();
-                auto decryptedData = decryptSimpleCrypt(payload);
+                auto decryptedData = encryptionMethod == "SimpleCrypt"?
+                            decryptSimpleCrypt(payload) : decryptAead(payload);
 
                 QJsonDocument decryptedDocument = QJsonDocument::fromJson(decryptedData);
                 if (decryptedDocument.isArray())
@@ -6400,14 +6533,14 @@ void MPDevice::loadFreeAddresses(AsyncJobs *jobs, const QByteArray &addressFrom,
                 {
                     freeAddresses.append(pMesProt->getPayloadBytes(data, 2 + i*2, 2));
 #ifdef DEV_DEBUG
-                    qDebug() << "Received free address " << pMesProt->getPayloadBytes(data, 2 + i*2, 2).toHex();
+                    qCDebug(lcDevicePacket) << "Received free address " << pMesProt->getPayloadBytes(data, 2 + i*2, 2).toHex();
 #endif
                 }
                 else
                 {
                     freeAddresses.append(pMesProt->getPayloadBytes(data,i*2, 2));
 #ifdef DEV_DEBUG
-                    qDebug() << "Received free address " << pMesProt->getPayloadBytes(data,i*2, 2).toHex();
+                    qCDebug(lcDevicePacket) << "Received free address " << pMesProt->getPayloadBytes(data,i*2, 2).toHex();
 #endif
                 }
             }
@@ -7177,22 +7310,39 @@ void MPDevice::exportDatabase(const QString &encryption, std::function<void(bool
                             cbProgress
                             , true, true, true);
 
-    connect(jobs, &AsyncJobs::finished, [this, cb, encryption](const QByteArray &)
+    connect(jobs, &AsyncJobs::finished, [this, cb, cbProgress, encryption](const QByteArray &)
     {
         qInfo() << "Memory management mode entered";
-        exitMemMgmtMode(false);
 
         /* Check DB just in case.... */
         if (!checkLoadedNodes(true, true, false))
         {
+            exitMemMgmtMode(false);
             qCritical() << "Corrupted DB";
             cb(false, "Couldn't create export file, please run integrity check", QByteArray());
+            return;
         }
-        else
+
+        /* Copy what the file is made of before the MMM data is released,
+         * the file itself is generated in the background */
+        ExportFileGenerator *generator = new ExportFileGenerator(exportSnapshot(), encryption);
+        exitMemMgmtMode(false);
+
+        connect(generator, &ExportFileGenerator::progress, this, [cbProgress](int current, int total, QString msg)
         {
-            /* Generate export file */
-            cb(true, "Export File Generated!", generateExportFileData(encryption));
-        }
+            QVariantMap data = {
+                {"total", total},
+                {"current", current},
+                {"msg", msg}
+            };
+            cbProgress(data);
+        });
+        connect(generator, &ExportFileGenerator::generated, this, [cb](const QByteArray &fileData)
+        {
+            cb(true, "Export File Generated!", fileData);
+        });
+        connect(generator, &QThread::finished, generator, &QObject::deleteLater);
+        generator->start(QThread::LowPriority);
     });
 
     connect(jobs, &AsyncJobs::failed, [cb](AsyncJob *failedJob)
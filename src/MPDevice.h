@@ -26,6 +26,7 @@
 #include "AsyncJobs.h"
 #include "MPNode.h"
 #include "FilesCache.h"
+#include "ExportFileGenerator.h"
 
 using MPCommandCb = std::function<void(bool success, const QByteArray &data, bool &done)>;
 using MPDeviceProgressCb = std::function<void(const QVariantMap &data)>;
@@ -157,6 +158,11 @@ public:
     void updateHashDisplay(bool);
     void updateLockUnlockMode(int);
 
+    //Applies a set of parameters, keyed by property name, in one job queue.
+    //Values equal to the current ones when the queue starts are not sent
+    //to the device.
+    void updateParams(const QVariantMap &params, const MessageHandlerCb &cb);
+
     void getUID(const QByteArray & key);
 
     //mem mgmt mode
@@ -266,6 +272,16 @@ public:
     void updateFileInCache(QString fileName, int size);
     void removeFileFromCache(QString fileName);
 
+    /* Status polling policy: adaptive polling backs off from minMs to maxMs
+     * while the device is idle, fixed polling always uses 500ms. Both bounds
+     * are capped at 500ms so lock and card removal are not noticed later.
+     * The policy is saved in the daemon settings.
+     */
+    void setStatusPollPolicy(bool adaptive, int minMs, int maxMs);
+    bool isStatusPollAdaptive() const { return statusPollAdaptive; }
+    int getStatusPollMinMs() const { return statusPollMinMs; }
+    int getStatusPollMaxMs() const { return statusPollMaxMs; }
+
 signals:
     /* Signal emited by platform code when new data comes from MP */
     /* A signal is used for platform code that uses a dedicated thread */
@@ -275,6 +291,7 @@ signals:
     void platformFailed();
     void filesCacheChanged();
     void dbChangeNumbersChanged(const int credentialsDbChangeNumber, const int dataDbChangeNumber);
+    void statusPollPolicyChanged();
 
 private slots:
     void newDataRead(const QByteArray &data);
@@ -342,7 +359,7 @@ private:
     bool deleteDataParentChilds(MPNode *parentNodePt);
     MPNode* addNewServiceToDB(const QString &service);
     bool addOrphanChildToDB(MPNode* childNodePt);
-    QByteArray generateExportFileData(const QString &encryption = "none");
+    ExportFileGenerator::Snapshot exportSnapshot();
     void cleanImportedVars(void);
     void cleanMMMVars(void);
 
@@ -357,8 +374,8 @@ private:
 
     // Crypto
     quint64 getUInt64EncryptionKey();
-    QString encryptSimpleCrypt(const QByteArray &data);
     QByteArray decryptSimpleCrypt(const QString &payload);
+    QByteArray decryptAead(const QString &payload);
 
     // Last page scanned
     quint16 lastFlashPageScanned = 0;
@@ -366,8 +383,20 @@ private:
     void updateParam(MPParams::Param param, bool en);
     void updateParam(MPParams::Param param, int val);
 
+    //Last known parameters, per serial number, used for a fast start
+    void loadParametersCache();
+    void saveParametersCache();
+
     //timer that asks status
     QTimer *statusTimer = nullptr;
+    bool statusPollAdaptive = true;
+    int statusPollMinMs = 0;
+    int statusPollMaxMs = 0;
+    qint64 statusPollLastActivity = 0;
+
+    bool updateStatus(Common::MPStatus s);
+    void scheduleNextStatusPoll(bool statusChanged);
+    void statusPollActivity();
 
     //local vars for performance diagnostics
     qint64 diagLastSecs;
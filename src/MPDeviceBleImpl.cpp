@@ -170,23 +170,47 @@ void MPDeviceBleImpl::uploadBundle(QString filePath, const MessageHandlerCb &cb,
     dequeueAndRun(jobs);
 }
 
-void MPDeviceBleImpl::fetchData(QString filePath, MPCmd::Command cmd)
+void MPDeviceBleImpl::fetchData(QString filePath, MPCmd::Command cmd, const FetchDataSettings &settings, const MPDeviceProgressCb &cbStats)
 {
+    if (fetchWriter)
+    {
+        qWarning() << "Fetch data already running";
+        return;
+    }
+
+    fetchWriter = new FetchDataWriter(filePath, settings.flushIntervalMs, this);
+    if (!fetchWriter->open())
+    {
+        delete fetchWriter;
+        fetchWriter = nullptr;
+        return;
+    }
+
     fetchState = Common::FetchState::STARTED;
+    fetchSettings = settings;
+    fetchStatsCb = cbStats;
+    fetchLastStatsMs = 0;
+    fetchLastStatsBytes = 0;
+    fetchTimer.start();
+
     auto *jobs = new AsyncJobs(QString("Fetch Data"), this);
 
     jobs->append(new MPCommandJob(mpDev, static_cast<quint8>(cmd),
-                    [this, filePath, cmd](const QByteArray &data, bool &) -> bool
+                    [this, cmd](const QByteArray &data, bool &) -> bool
                     {
-                        QFile *file = new QFile(filePath);
-                        if (file->open(QIODevice::WriteOnly))
-                        {
-                            file->write(bleProt->getFullPayload(data));
-                        }
-                        writeFetchData(file, cmd);
+                        const PayloadView payload = bleProt->getPayloadView(data);
+                        fetchWriter->append(payload.data, payload.size);
+                        writeFetchData(cmd);
                         return true;
                     }));
 
+    connect(jobs, &AsyncJobs::failed, this, [this](AsyncJob *)
+    {
+        qWarning() << "Fetch data failed to start";
+        if (fetchWriter)
+            finishFetchData();
+    });
+
     dequeueAndRun(jobs);
 }
 
@@ -387,80 +411,163 @@ void MPDeviceBleImpl::checkDataFlash(const QByteArray &data, QElapsedTimer *time
 
 void MPDeviceBleImpl::sendBundleToDevice(QString filePath, AsyncJobs *jobs, const MPDeviceProgressCb &cbProgress)
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly))
+    auto upload = std::make_shared<BundleUpload>();
+    upload->file.setFileName(filePath);
+    if (!upload->file.open(QIODevice::ReadOnly))
     {
         qCritical() << "Error opening bundle file: " << filePath;
         return;
     }
-    QByteArray blob = file.readAll();
-    const auto fileSize = blob.size();
-    qDebug() << "Bundle size: " << fileSize;
-    int byteCounter = BUNBLE_DATA_ADDRESS_SIZE;
-    int curAddress = 0;
-    QByteArray message;
-    message.fill(static_cast<char>(0), BUNBLE_DATA_ADDRESS_SIZE);
-    for (const auto byte : blob)
+
+    upload->size = upload->file.size();
+    upload->data = upload->file.map(0, upload->size);
+    if (!upload->data)
     {
-        message.append(byte);
-        ++byteCounter;
-        if ((BUNBLE_DATA_WRITE_SIZE + BUNBLE_DATA_ADDRESS_SIZE) == byteCounter)
-        {
-            jobs->append(new MPCommandJob(mpDev, MPCmd::CMD_DBG_DATAFLASH_WRITE_256B, message,
-                              [curAddress, cbProgress, fileSize](const QByteArray &data, bool &) -> bool
-                                  {
-                                      Q_UNUSED(data);
-                                      QVariantMap progress = QVariantMap {
-                                          {"total", fileSize},
-                                          {"current", curAddress},
-                                          {"msg", tr("Writing bundle data to device...") }
-                                      };
-                                      cbProgress(progress);
-#ifdef DEV_DEBUG
-                                      qDebug() << "Sending message to address #" << curAddress;
-#endif
-                                      return true;
-                                  }));
-            curAddress += BUNBLE_DATA_WRITE_SIZE;
-            message.clear();
-            quint32 qCurAddress = static_cast<quint32>(curAddress);
-            //Add write address to message (Big endian)
-            message.append(static_cast<char>((qCurAddress&0xFF)));
-            message.append(static_cast<char>(((qCurAddress&0xFF00)>>8)));
-            message.append(static_cast<char>(((qCurAddress&0xFF0000)>>16)));
-            message.append(static_cast<char>(((qCurAddress&0xFF000000)>>24)));
-            byteCounter = BUNBLE_DATA_ADDRESS_SIZE;
-        }
+        //Mapping is not available everywhere (empty file, some filesystems)
+        upload->fallback = upload->file.readAll();
+        upload->size = upload->fallback.size();
+        upload->data = reinterpret_cast<const uchar *>(upload->fallback.constData());
     }
+    //The last write holds the remaining bytes, it may be empty
+    upload->blockCount = upload->size / BUNBLE_DATA_WRITE_SIZE + 1;
+    upload->timer.start();
+
+    qDebug() << "Bundle size: " << upload->size << (upload->fallback.isEmpty()? "(mapped)" : "");
+
+    for (int i = 0;i < BUNDLE_WRITE_WINDOW && upload->nextBlock < upload->blockCount;i++)
+        appendBundleWriteJob(upload, jobs, cbProgress);
+}
+
+void MPDeviceBleImpl::appendBundleWriteJob(std::shared_ptr<BundleUpload> upload, AsyncJobs *jobs, const MPDeviceProgressCb &cbProgress)
+{
+    const qint64 offset = upload->nextBlock * BUNBLE_DATA_WRITE_SIZE;
+    const int len = static_cast<int>(qMin<qint64>(BUNBLE_DATA_WRITE_SIZE, upload->size - offset));
+    const bool last = ++upload->nextBlock == upload->blockCount;
+
+    QByteArray message(BUNBLE_DATA_ADDRESS_SIZE + len, Qt::Uninitialized);
+    //Add write address to message (little endian)
+    qToLittleEndian(static_cast<quint32>(offset), reinterpret_cast<uchar *>(message.data()));
+    memcpy(message.data() + BUNBLE_DATA_ADDRESS_SIZE, upload->data + offset, static_cast<size_t>(len));
+
     jobs->append(new MPCommandJob(mpDev, MPCmd::CMD_DBG_DATAFLASH_WRITE_256B, message,
-                  [](const QByteArray &data, bool &) -> bool
-                      {
-                          Q_UNUSED(data);
-                          qDebug() << "Sending bundle is DONE";
-                          return true;
-                      }));
-
-    jobs->append(new MPCommandJob(mpDev, MPCmd::CMD_DBG_REINDEX_BUNDLE, bleProt->getDefaultFuncDone()));
+                      [this, upload, jobs, cbProgress, offset, len, last](const QByteArray &, bool &) -> bool
+                          {
+#ifdef DEV_DEBUG
+                              qCDebug(lcDevicePacket) << "Sending message to address #" << offset;
+#endif
+                              reportBundleProgress(*upload, offset + len, last, cbProgress);
+
+                              if (last)
+                              {
+                                  qDebug() << "Sending bundle is DONE in" << upload->timer.elapsed() << "ms";
+                                  upload->release();
+                              }
+                              //Keep the window full, jobs are created as the previous ones complete
+                              else if (upload->nextBlock < upload->blockCount)
+                                  appendBundleWriteJob(upload, jobs, cbProgress);
+                              return true;
+                          }));
+
+    if (last)
+        jobs->append(new MPCommandJob(mpDev, MPCmd::CMD_DBG_REINDEX_BUNDLE, bleProt->getDefaultFuncDone()));
 }
 
-void MPDeviceBleImpl::writeFetchData(QFile *file, MPCmd::Command cmd)
+void MPDeviceBleImpl::reportBundleProgress(BundleUpload &upload, qint64 sent, bool last, const MPDeviceProgressCb &cbProgress)
 {
+    //Progress is forwarded to clients, don't flood them with one message per block
+    const qint64 elapsed = upload.timer.elapsed();
+    if (!last && elapsed - upload.lastProgressMs < BUNDLE_PROGRESS_INTERVAL_MS)
+        return;
+    upload.lastProgressMs = elapsed;
+
+    const qint64 bytesPerSec = elapsed > 0? sent * 1000 / elapsed : 0;
+    const qint64 etaSec = bytesPerSec > 0? (upload.size - sent) / bytesPerSec : 0;
+
+    QVariantMap progress = QVariantMap {
+        {"total", upload.size},
+        {"current", sent},
+        {"msg", "Writing bundle data to device (%1 B/s, %2 s left)..." },
+        {"msg_args", QVariantList({bytesPerSec, etaSec})}
+    };
+    cbProgress(progress);
+}
+
+void MPDeviceBleImpl::writeFetchData(MPCmd::Command cmd)
+{
+    const qint64 elapsed = fetchTimer.elapsed();
+    if (fetchSettings.maxDurationMs > 0 && elapsed >= fetchSettings.maxDurationMs)
+    {
+        qInfo() << "Fetch data duration limit reached";
+        fetchState = Common::FetchState::STOPPED;
+    }
+    if (fetchSettings.maxBytes > 0 && fetchWriter->bytesReceived() >= fetchSettings.maxBytes)
+    {
+        qInfo() << "Fetch data size limit reached";
+        fetchState = Common::FetchState::STOPPED;
+    }
+
+    if (Common::FetchState::STARTED != fetchState)
+    {
+        finishFetchData();
+        return;
+    }
+
+    if (elapsed - fetchLastStatsMs >= FETCH_STATS_INTERVAL_MS)
+        reportFetchStats(false);
+
+    //The response is queued to the writer thread, next request goes out right away
     mpDev->sendData(cmd,
-                    [this, file, cmd](bool, const QByteArray &data, bool &) -> bool
+                    [this, cmd](bool success, const QByteArray &data, bool &) -> bool
                     {
-                        file->write(bleProt->getFullPayload(data));
-                        if (Common::FetchState::STARTED == fetchState)
+                        if (success)
                         {
-                            writeFetchData(file, cmd);
+                            const PayloadView payload = bleProt->getPayloadView(data);
+                            fetchWriter->append(payload.data, payload.size);
                         }
                         else
                         {
-                            delete file;
+                            qWarning() << "Fetch data request failed, stopping";
+                            fetchState = Common::FetchState::STOPPED;
                         }
+                        writeFetchData(cmd);
                         return true;
     });
 }
 
+void MPDeviceBleImpl::reportFetchStats(bool finished)
+{
+    const qint64 elapsed = fetchTimer.elapsed();
+    const qint64 bytes = fetchWriter->bytesReceived();
+    const qint64 interval = elapsed - fetchLastStatsMs;
+    const qint64 bytesPerSec = interval > 0? (bytes - fetchLastStatsBytes) * 1000 / interval : 0;
+    fetchLastStatsMs = elapsed;
+    fetchLastStatsBytes = bytes;
+
+    if (!fetchStatsCb)
+        return;
+
+    QVariantMap stats = {
+        {"bytes", bytes},
+        {"bytes_written", fetchWriter->bytesWritten()},
+        {"bytes_per_sec", finished && elapsed > 0? bytes * 1000 / elapsed : bytesPerSec},
+        {"elapsed_ms", elapsed},
+        {"write_error", fetchWriter->hasWriteError()},
+        {"finished", finished}
+    };
+    fetchStatsCb(stats);
+}
+
+void MPDeviceBleImpl::finishFetchData()
+{
+    fetchWriter->finish();
+    qInfo() << "Fetch data done:" << fetchWriter->bytesWritten() << "bytes in" << fetchTimer.elapsed() << "ms";
+    reportFetchStats(true);
+
+    delete fetchWriter;
+    fetchWriter = nullptr;
+    fetchStatsCb = nullptr;
+}
+
 void MPDeviceBleImpl::dequeueAndRun(AsyncJobs *jobs)
 {
     mpDev->jobsQueue.enqueue(jobs);
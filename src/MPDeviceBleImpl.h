@@ -3,9 +3,45 @@
 
 #include "MPDevice.h"
 #include "BleCommon.h"
+#include "FetchDataWriter.h"
+#include <memory>
 
 class MessageProtocolBLE;
 
+/**
+ * @brief State of a bundle upload, the file is mapped
+ * and write jobs are created as the upload progresses
+ */
+struct BundleUpload
+{
+    QFile file;
+    const uchar *data = nullptr;
+    QByteArray fallback;
+    qint64 size = 0;
+    qint64 blockCount = 0;
+    qint64 nextBlock = 0;
+    QElapsedTimer timer;
+    qint64 lastProgressMs = 0;
+
+    void release()
+    {
+        data = nullptr;
+        fallback.clear();
+        file.close();
+    }
+};
+
+/**
+ * @brief Limits and flush policy of a fetch_data capture,
+ * 0 means unlimited
+ */
+struct FetchDataSettings
+{
+    int flushIntervalMs = 500;
+    qint64 maxDurationMs = 0;
+    qint64 maxBytes = 0;
+};
+
 /**
  * @brief The MPDeviceBleImpl class
  * Implementations of only BLE related commands
@@ -30,8 +66,9 @@ public:
 
     void flashMCU(QString type, const MessageHandlerCb &cb);
     void uploadBundle(QString filePath, const MessageHandlerCb &cb, const MPDeviceProgressCb &cbProgress);
-    void fetchData(QString filePath, MPCmd::Command cmd);
+    void fetchData(QString filePath, MPCmd::Command cmd, const FetchDataSettings &settings, const MPDeviceProgressCb &cbStats);
     inline void stopFetchData() { fetchState = Common::FetchState::STOPPED; }
+    inline bool isFetchingData() const { return nullptr != fetchWriter; }
 
     void sendResetFlipBit();
     void flipMessageBit(QByteArray &msg);
@@ -55,7 +92,11 @@ public:
 private:
     void checkDataFlash(const QByteArray &data, QElapsedTimer *timer, AsyncJobs *jobs, QString filePath, const MPDeviceProgressCb &cbProgress);
     void sendBundleToDevice(QString filePath, AsyncJobs *jobs, const MPDeviceProgressCb &cbProgress);
-    void writeFetchData(QFile *file, MPCmd::Command cmd);
+    void appendBundleWriteJob(std::shared_ptr<BundleUpload> upload, AsyncJobs *jobs, const MPDeviceProgressCb &cbProgress);
+    void reportBundleProgress(BundleUpload &upload, qint64 sent, bool last, const MPDeviceProgressCb &cbProgress);
+    void writeFetchData(MPCmd::Command cmd);
+    void reportFetchStats(bool finished);
+    void finishFetchData();
 
     QByteArray createStoreCredMessage(const BleCredential &cred);
     QByteArray createGetCredMessage(QString service, QString login);
@@ -67,9 +108,19 @@ private:
     MessageProtocolBLE *bleProt;
     MPDevice *mpDev;
     Common::FetchState fetchState = Common::FetchState::STOPPED;
+    FetchDataWriter *fetchWriter = nullptr;
+    FetchDataSettings fetchSettings;
+    MPDeviceProgressCb fetchStatsCb;
+    QElapsedTimer fetchTimer;
+    qint64 fetchLastStatsMs = 0;
+    qint64 fetchLastStatsBytes = 0;
 
     static constexpr int BUNBLE_DATA_WRITE_SIZE = 256;
     static constexpr int BUNBLE_DATA_ADDRESS_SIZE = 4;
+    //Write jobs created ahead of the one being sent
+    static constexpr int BUNDLE_WRITE_WINDOW = 16;
+    static constexpr int BUNDLE_PROGRESS_INTERVAL_MS = 250;
+    static constexpr int FETCH_STATS_INTERVAL_MS = 1000;
 };
 
 #endif // MPDEVICEBLEIMPL_H
@@ -28,8 +28,10 @@
 #include <fcntl.h>
 #include <string.h>
 #include <unistd.h>
+#include <errno.h>
 
 int MPDevice_linux::INVALID_VALUE = -1;
+QHash<QString, MPDevice_linux::CachedCheck> MPDevice_linux::checkCache;
 
 MPDevice_linux::MPDevice_linux(QObject *parent, const MPPlatformDef &platformDef):
     MPDevice(parent),
@@ -41,25 +43,48 @@ MPDevice_linux::MPDevice_linux(QObject *parent, const MPPlatformDef &platformDef
     }
     setupMessageProtocol();
 
+    openTimer.start();
+    openDevice(0);
+}
+
+void MPDevice_linux::openDevice(int attempt)
+{
     devfd = open(devPath.toLocal8Bit(), O_RDWR);
     if (devfd < 0)
     {
-        qWarning() << "Error opening usb device: " << strerror(errno);
-    }
-    else
-    {
-        grabbed = ioctl(devfd, EVIOCGRAB, ExclusiveAccess::GRAB);
-        if (INVALID_VALUE == grabbed)
+        //The node can be briefly unavailable right after plug-in,
+        //retry with a short backoff instead of waiting a fixed delay
+        if ((errno == EACCES || errno == ENOENT || errno == EBUSY) &&
+            attempt < OPEN_RETRY_COUNT)
         {
-            qWarning() << "Exclusive device grab wasn't successful: " << strerror(errno);
+            QTimer::singleShot(OPEN_RETRY_FIRST_MS << attempt, this, [this, attempt]()
+            {
+                openDevice(attempt + 1);
+            });
+            return;
         }
-        sockNotifRead = new QSocketNotifier(devfd, QSocketNotifier::Read);
-        sockNotifRead->setEnabled(true);
-        connect(sockNotifRead, &QSocketNotifier::activated, this, &MPDevice_linux::readyRead);
 
-        sockNotifWrite = new QSocketNotifier(devfd, QSocketNotifier::Write);
-        sockNotifWrite->setEnabled(true);
+        qWarning() << "Error opening usb device: " << strerror(errno);
+        return;
+    }
+
+    qInfo() << "Device" << devPath << "opened in" << openTimer.elapsed() << "ms";
+
+    grabbed = ioctl(devfd, EVIOCGRAB, ExclusiveAccess::GRAB);
+    if (INVALID_VALUE == grabbed)
+    {
+        qWarning() << "Exclusive device grab wasn't successful: " << strerror(errno);
     }
+    sockNotifRead = new QSocketNotifier(devfd, QSocketNotifier::Read);
+    sockNotifRead->setEnabled(true);
+    connect(sockNotifRead, &QSocketNotifier::activated, this, &MPDevice_linux::readyRead);
+
+    sockNotifWrite = new QSocketNotifier(devfd, QSocketNotifier::Write);
+    sockNotifWrite->setEnabled(true);
+
+    //Send what was queued while the device was not opened yet
+    while (!sendBuffer.isEmpty())
+        writeNextPacket();
 }
 
 MPDevice_linux::~MPDevice_linux()
@@ -72,7 +97,7 @@ MPDevice_linux::~MPDevice_linux()
     delete sockNotifRead;
     delete sockNotifWrite;
 
-    if (devfd > 0)
+    if (devfd >= 0)
     {
         ::close(devfd);
     }
@@ -99,6 +124,11 @@ void MPDevice_linux::readyRead(int fd)
     }
     else
     {
+        if (!firstAnswerLogged)
+        {
+            qInfo() << "First answer from device" << devPath << openTimer.elapsed() << "ms after detection";
+            firstAnswerLogged = true;
+        }
         emit platformDataRead(recvData);
         failToWriteLogged = false;
     }
@@ -117,32 +147,40 @@ int MPDevice_linux::getDescriptorSize(const char *devpath)
 {
     int descSize = 0;
     auto fd = open(devpath, O_RDONLY);
-    if (fd != INVALID_VALUE)
+    if (fd == INVALID_VALUE)
+        return INVALID_VALUE;
+
+    int res = ioctl(fd, HIDIOCGRDESCSIZE, &descSize);
+    if (res == INVALID_VALUE)
     {
-        int res = ioctl(fd, HIDIOCGRDESCSIZE, &descSize);
-        if (res == INVALID_VALUE)
-        {
-            qDebug() << "Getting descriptor size failed.";
-        }
-        close(fd);
+        qDebug() << "Getting descriptor size failed.";
     }
+    close(fd);
     return descSize;
 }
 
-bool MPDevice_linux::checkDevice(struct udev_device *raw_dev, bool &isBLE)
+MPDevice_linux::CheckResult MPDevice_linux::checkDevice(struct udev_device *raw_dev, bool &isBLE)
 {
     int bus_type = 0;
     unsigned short dev_vid = 0;
     unsigned short dev_pid = 0;
 
+    const QString syspath = QString::fromUtf8(udev_device_get_syspath(raw_dev));
+    auto it = checkCache.constFind(syspath);
+    if (it != checkCache.constEnd())
+    {
+        isBLE = it->isBLE;
+        return it->isMooltipass? CheckResult::Mooltipass : CheckResult::NotMooltipass;
+    }
+
     const char *dev_path = udev_device_get_devnode(raw_dev);
 
     struct udev_device *hid_dev = udev_device_get_parent_with_subsystem_devtype(raw_dev, "hid", nullptr);
 
     if (!hid_dev)
     {
-        udev_device_unref(raw_dev);
-        return false;
+        checkCache[syspath] = CachedCheck();
+        return CheckResult::NotMooltipass;
     }
 
     QString uevent = QString::fromUtf8(udev_device_get_sysattr_value(hid_dev, "uevent"));
@@ -164,16 +202,29 @@ bool MPDevice_linux::checkDevice(struct udev_device *raw_dev, bool &isBLE)
 
     bool isMini = dev_vid == MOOLTIPASS_VENDORID && dev_pid == MOOLTIPASS_PRODUCTID;
     bool isBle = dev_vid == MOOLTIPASS_BLE_VENDORID && dev_pid == MOOLTIPASS_BLE_PRODUCTID;
-    if (bus_type == BUS_USB &&
-        (isMini || isBle) &&
-        getDescriptorSize(dev_path) == MOOLTIPASS_USBHID_DESC_SIZE)
+    if (bus_type != BUS_USB || !(isMini || isBle))
     {
-        isBLE = isBle;
-        return true;
+        //Cheap check, no need to open the node for other devices
+        checkCache[syspath] = CachedCheck();
+        return CheckResult::NotMooltipass;
     }
 
-    udev_device_unref(raw_dev);
-    return false;
+    int descSize = getDescriptorSize(dev_path);
+    if (descSize == INVALID_VALUE)
+        return CheckResult::NotReady; //not cached, check again later
+
+    CachedCheck check;
+    check.isMooltipass = descSize == MOOLTIPASS_USBHID_DESC_SIZE;
+    check.isBLE = isBle;
+    checkCache[syspath] = check;
+
+    isBLE = isBle;
+    return check.isMooltipass? CheckResult::Mooltipass : CheckResult::NotMooltipass;
+}
+
+void MPDevice_linux::forgetDevice(const QString &syspath)
+{
+    checkCache.remove(syspath);
 }
 
 void MPDevice_linux::writeNextPacket()
@@ -183,6 +234,11 @@ void MPDevice_linux::writeNextPacket()
         return; //nothing to write anymore
     }
 
+    if (devfd < 0)
+    {
+        return; //not opened yet, keep the data queued
+    }
+
     QByteArray ba = sendBuffer.dequeue();
     /**
       * Adding a plus 0x00 byte before the message
@@ -206,11 +262,11 @@ QList<MPPlatformDef> MPDevice_linux::enumerateDevices()
 {
     QList<MPPlatformDef> devlist;
 
-    struct udev *udev;
     struct udev_enumerate *enumerate;
     struct udev_list_entry *devices, *dev;
 
-    udev = udev_new();
+    //Reuse the monitor udev context instead of creating one for each scan
+    struct udev *udev = UsbMonitor_linux::Instance()->getUdev();
     if (!udev)
     {
         qWarning() << "Can't create udev object";
@@ -227,8 +283,11 @@ QList<MPPlatformDef> MPDevice_linux::enumerateDevices()
     {
         const char *sysfs_path = udev_list_entry_get_name(dev);
         struct udev_device *raw_dev = udev_device_new_from_syspath(udev, sysfs_path);
-        bool isBLE;
-        if (checkDevice(raw_dev, isBLE))
+        if (!raw_dev)
+            continue;
+
+        bool isBLE = false;
+        if (checkDevice(raw_dev, isBLE) == CheckResult::Mooltipass)
         {
             const char *dev_path = udev_device_get_devnode(raw_dev);
             MPPlatformDef def;
@@ -239,10 +298,10 @@ QList<MPPlatformDef> MPDevice_linux::enumerateDevices()
 
             qDebug() << "Found mooltipass: " << def.path;
         }
+        udev_device_unref(raw_dev);
     }
 
     udev_enumerate_unref(enumerate);
-    udev_unref(udev);
 
     return devlist;
 }
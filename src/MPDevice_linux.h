@@ -49,17 +49,26 @@ public:
     MPDevice_linux(QObject *parent, const MPPlatformDef &platformDef);
     virtual ~MPDevice_linux();
 
+    enum class CheckResult
+    {
+        NotMooltipass,
+        Mooltipass,
+        NotReady, //hidraw node can't be opened yet, check again later
+    };
+
     //Static function for enumerating devices on platform
     static QList<MPPlatformDef> enumerateDevices();
     static int getDescriptorSize(const char* devpath);
     /**
      * @brief checkDevice
-     * Checking if the device is a mooltipass device
-     * @param path to the device
+     * Checking if the device is a mooltipass device.
+     * Results are cached per sysfs path until forgetDevice() is called.
+     * @param raw_dev udev device, not unrefed by this function
      * @param isBLE out param, true if device is a ble
-     * @return true, if the device is mini/ble
+     * @return Mooltipass, if the device is mini/ble
      */
-    static bool checkDevice(struct udev_device *raw_dev, bool &isBLE);
+    static CheckResult checkDevice(struct udev_device *raw_dev, bool &isBLE);
+    static void forgetDevice(const QString &syspath);
     static int INVALID_VALUE;
 
 private slots:
@@ -70,8 +79,10 @@ private:
     virtual void platformRead();
     virtual void platformWrite(const QByteArray &data);
 
+    void openDevice(int attempt);
+
     QString devPath;
-    int devfd = 0; //device fd
+    int devfd = INVALID_VALUE; //device fd
     QSocketNotifier *sockNotifRead = nullptr;
     QSocketNotifier *sockNotifWrite = nullptr;
 
@@ -80,6 +91,20 @@ private:
     //Bufferize the data sent by sending 64bytes packet at a time
     QQueue<QByteArray> sendBuffer;
     bool failToWriteLogged = false;
+
+    //time from device creation to first answer, for startup diagnostics
+    QElapsedTimer openTimer;
+    bool firstAnswerLogged = false;
+
+    static const int OPEN_RETRY_COUNT = 6;
+    static const int OPEN_RETRY_FIRST_MS = 10;
+
+    struct CachedCheck
+    {
+        bool isMooltipass = false;
+        bool isBLE = false;
+    };
+    static QHash<QString, CachedCheck> checkCache;
 };
 
 #endif // MPDEVICE_LINUX_H
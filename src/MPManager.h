@@ -47,6 +47,10 @@ public:
     MPDevice* getDevice(int at);
     int getDeviceCount() { return devices.count(); }
 
+    //Device ids are used by the websocket API to route requests
+    QString getDeviceId(MPDevice *device) const { return devices.key(device); }
+    MPDevice* getDeviceById(const QString &id) const { return devices.value(id, nullptr); }
+
 signals:
     void mpConnected(MPDevice *device);
     void mpDisconnected(MPDevice *device);
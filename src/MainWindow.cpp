@@ -928,7 +928,8 @@ void MainWindow::on_pushButtonSettingsSave_clicked()
             o["knock_sensitivity"] = ui->comboBoxKnock->currentData().toInt();
     }
 
-    wsClient->sendJsonData({{ "msg", "param_set" }, { "data", o }});
+    if (!o.isEmpty())
+        wsClient->sendJsonData({{ "msg", "set_params" }, { "data", o }});
 }
 
 void MainWindow::onFilesAndSSHTabsShortcutActivated()
@@ -1297,7 +1298,7 @@ void MainWindow::on_pushButtonExportFile_clicked()
     if (ui->checkBoxExport->isChecked())
         wsClient->exportDbFile("none");
     else
-        wsClient->exportDbFile("SimpleCrypt");
+        wsClient->exportDbFile("ChaCha20-Poly1305");
 
     // one-time connection, must be disconected immediately in the slot
     connect(wsClient, &WSClient::dbExported, this, &MainWindow::dbExported);
@@ -0,0 +1,106 @@
+#ifndef COMMANDMAP_H
+#define COMMANDMAP_H
+
+#include "../MooltipassCmds.h"
+
+/*!
+ * \brief The CommandMap class
+ * Bidirectional mapping between generic commands and device
+ * command ids, built once from a constant table of entries.
+ * Both directions are plain array lookups, nothing is allocated
+ * when a packet is encoded or decoded.
+ */
+class CommandMap
+{
+public:
+    struct Entry
+    {
+        MPCmd::Command cmd;
+        quint16 id;
+    };
+
+    template<size_t N>
+    explicit CommandMap(const Entry (&entries)[N])
+    {
+        static_assert(N < REVERSE_SLOTS / 2, "Command table too large for the reverse lookup");
+        for (int i = 0; i < MPCmd::COMMAND_COUNT; ++i)
+            m_mapped[i] = false;
+        for (int i = 0; i < REVERSE_SLOTS; ++i)
+            m_reverse[i].cmd = EMPTY_SLOT;
+
+        for (const Entry &e : entries)
+        {
+            Q_ASSERT(e.cmd < MPCmd::COMMAND_COUNT);
+            m_ids[e.cmd] = e.id;
+            m_mapped[e.cmd] = true;
+            insertReverse(e);
+        }
+    }
+
+    bool contains(MPCmd::Command cmd) const
+    {
+        return cmd < MPCmd::COMMAND_COUNT && m_mapped[cmd];
+    }
+
+    /*!
+     * \brief deviceId
+     * \return device command id of \a cmd, 0 if not mapped
+     */
+    quint16 deviceId(MPCmd::Command cmd) const
+    {
+        return contains(cmd) ? m_ids[cmd] : 0;
+    }
+
+    /*!
+     * \brief command
+     * \return generic command of the device command \a id,
+     * the lowest one when several commands share an id
+     */
+    MPCmd::Command command(quint16 id, MPCmd::Command defaultCmd) const
+    {
+        for (int slot = hash(id); m_reverse[slot].cmd != EMPTY_SLOT; slot = (slot + 1) & (REVERSE_SLOTS - 1))
+        {
+            if (m_reverse[slot].id == id)
+                return MPCmd::Command(m_reverse[slot].cmd);
+        }
+        return defaultCmd;
+    }
+
+private:
+    static int hash(quint16 id)
+    {
+        return (id ^ (id >> 8)) & (REVERSE_SLOTS - 1);
+    }
+
+    void insertReverse(const Entry &e)
+    {
+        int slot = hash(e.id);
+        while (m_reverse[slot].cmd != EMPTY_SLOT)
+        {
+            if (m_reverse[slot].id == e.id)
+            {
+                if (e.cmd < m_reverse[slot].cmd)
+                    m_reverse[slot].cmd = e.cmd;
+                return;
+            }
+            slot = (slot + 1) & (REVERSE_SLOTS - 1);
+        }
+        m_reverse[slot].id = e.id;
+        m_reverse[slot].cmd = e.cmd;
+    }
+
+    struct ReverseSlot
+    {
+        quint16 id;
+        quint16 cmd;
+    };
+
+    static constexpr int REVERSE_SLOTS = 256;
+    static constexpr quint16 EMPTY_SLOT = 0xFFFF;
+
+    quint16 m_ids[MPCmd::COMMAND_COUNT];
+    bool m_mapped[MPCmd::COMMAND_COUNT];
+    ReverseSlot m_reverse[REVERSE_SLOTS];
+};
+
+#endif // COMMANDMAP_H
@@ -4,8 +4,43 @@
 #include "../MooltipassCmds.h"
 #include "../Common.h"
 #include "../AsyncJobs.h"
+#include "CommandMap.h"
 
 #include <QByteArray>
+#include <QDebug>
+
+/*!
+ * \brief The PayloadView struct
+ * Non owning view on the payload of a received packet,
+ * only valid as long as the packet it was taken from.
+ */
+struct PayloadView
+{
+    const char *data = nullptr;
+    int size = 0;
+
+    quint8 at(int i) const { return static_cast<quint8>(data[i]); }
+    QByteArray toByteArray() const { return QByteArray(data, size); }
+};
+
+/*!
+ * \brief The PrintableCommand struct
+ * Command name and device id, only formatted when streamed to QDebug
+ */
+struct PrintableCommand
+{
+    MPCmd::Command cmd;
+    quint16 deviceId;
+};
+
+inline QDebug operator<<(QDebug dbg, const PrintableCommand &c)
+{
+    QDebugStateSaver saver(dbg);
+    char id[8];
+    qsnprintf(id, sizeof(id), "0x%04x", c.deviceId);
+    dbg.nospace() << QMetaEnum::fromType<MPCmd::Command>().valueToKey(c.cmd) << " (" << id << ")";
+    return dbg;
+}
 
 class IMessageProtocol
 {
@@ -39,6 +74,12 @@ public:
      * \return the entire packet payload as QByteArray from \a data
      */
     virtual QByteArray getFullPayload(const QByteArray &data) = 0;
+    /*!
+     * \brief getPayloadView
+     * \param data
+     * \return the same bytes as getFullPayload without copying them
+     */
+    virtual PayloadView getPayloadView(const QByteArray &data) = 0;
     /*!
      * \brief getPayloadByteAt
      * \param data
@@ -93,13 +134,12 @@ public:
      */
     quint16 getDeviceMappedCommandId(const MPCmd::Command &cmd)
     {
-        const auto commandIter = m_commandMapping.find(cmd);
-        if (commandIter == m_commandMapping.end())
+        if (!m_commandMapping->contains(cmd))
         {
             qCritical() << MPCmd::printCmd(cmd) << " is not implemented for " << getDeviceName();
-            return m_commandMapping[MPCmd::PING];
+            return m_commandMapping->deviceId(MPCmd::PING);
         }
-        return commandIter.value();
+        return m_commandMapping->deviceId(cmd);
     }
 
     /**
@@ -109,19 +149,15 @@ public:
      */
     MPCmd::Command getGeneralCommandId(const quint16 cmd)
     {
-        return MPCmd::Command(m_commandMapping.key(cmd, MPCmd::PING));
+        return m_commandMapping->command(cmd, MPCmd::PING);
     }
 
-    QString printCmd(const MPCmd::Command &cmd)
+    PrintableCommand printCmd(const MPCmd::Command &cmd)
     {
-        const auto commandId = m_commandMapping[cmd];
-        QMetaEnum m = QMetaEnum::fromType<MPCmd::Command>();
-        return QString("%1 (%2)")
-                .arg(m.valueToKey(cmd))
-                .arg(MPCmd::toHexString(commandId));
+        return PrintableCommand{cmd, m_commandMapping->deviceId(cmd)};
     }
 
-    QString printCmd(const QByteArray &data)
+    PrintableCommand printCmd(const QByteArray &data)
     {
         MPCmd::Command cmd = getCommand(data);
         return printCmd(cmd);
@@ -140,7 +176,7 @@ public:
         return littleEndian;
     }
 
-    QMap<quint16,quint16> m_commandMapping;
+    const CommandMap *m_commandMapping = nullptr;
 };
 
 
@@ -1,5 +1,102 @@
 #include "MessageProtocolBLE.h"
 
+//TODO fill commandId mapping, when they are implemented for BLE
+static constexpr CommandMap::Entry BLE_COMMANDS[] = {
+    {MPCmd::EXPORT_FLASH_START    , 0x8A},
+    {MPCmd::EXPORT_FLASH          , 0x8B},
+    {MPCmd::EXPORT_FLASH_END      , 0x8C},
+    {MPCmd::IMPORT_FLASH_BEGIN    , 0x8D},
+    {MPCmd::IMPORT_FLASH          , 0x8E},
+    {MPCmd::IMPORT_FLASH_END      , 0x8F},
+    {MPCmd::EXPORT_EEPROM_START   , 0x90},
+    {MPCmd::EXPORT_EEPROM         , 0x91},
+    {MPCmd::EXPORT_EEPROM_END     , 0x92},
+    {MPCmd::IMPORT_EEPROM_BEGIN   , 0x93},
+    {MPCmd::IMPORT_EEPROM         , 0x94},
+    {MPCmd::IMPORT_EEPROM_END     , 0x95},
+    {MPCmd::ERASE_EEPROM          , 0x96},
+    {MPCmd::ERASE_FLASH           , 0x97},
+    {MPCmd::ERASE_SMC             , 0x98},
+    {MPCmd::DRAW_BITMAP           , 0x99},
+    {MPCmd::SET_FONT              , 0x9A},
+    {MPCmd::USB_KEYBOARD_PRESS    , 0x9B},
+    {MPCmd::STACK_FREE            , 0x9C},
+    {MPCmd::CLONE_SMARTCARD       , 0x9D},
+    {MPCmd::DEBUG                 , 0xA0},
+    {MPCmd::PING                  , 0x0001},
+    {MPCmd::VERSION               , 0xA2},
+    {MPCmd::CONTEXT               , 0xA3},
+    {MPCmd::GET_LOGIN             , 0xA4},
+    {MPCmd::GET_PASSWORD          , 0xA5},
+    {MPCmd::SET_LOGIN             , 0xA6},
+    {MPCmd::SET_PASSWORD          , 0xA7},
+    {MPCmd::CHECK_PASSWORD        , 0xA8},
+    {MPCmd::ADD_CONTEXT           , 0xA9},
+    {MPCmd::SET_BOOTLOADER_PWD    , 0xAA},
+    {MPCmd::JUMP_TO_BOOTLOADER    , 0xAB},
+    {MPCmd::GET_RANDOM_NUMBER     , 0x0008},
+    {MPCmd::START_MEMORYMGMT      , 0xAD},
+    {MPCmd::IMPORT_MEDIA_START    , 0xAE},
+    {MPCmd::IMPORT_MEDIA          , 0xAF},
+    {MPCmd::IMPORT_MEDIA_END      , 0xB0},
+    {MPCmd::SET_MOOLTIPASS_PARM   , 0xB1},
+    {MPCmd::GET_MOOLTIPASS_PARM   , 0xB2},
+    {MPCmd::RESET_CARD            , 0xB3},
+    {MPCmd::READ_CARD_LOGIN       , 0xB4},
+    {MPCmd::READ_CARD_PASS        , 0xB5},
+    {MPCmd::SET_CARD_LOGIN        , 0xB6},
+    {MPCmd::SET_CARD_PASS         , 0xB7},
+    {MPCmd::ADD_UNKNOWN_CARD      , 0xB8},
+    {MPCmd::MOOLTIPASS_STATUS     , 0x0001},
+    {MPCmd::FUNCTIONAL_TEST_RES   , 0xBA},
+    {MPCmd::SET_DATE              , 0x0004},
+    {MPCmd::SET_UID               , 0xBC},
+    {MPCmd::GET_UID               , 0xBD},
+    {MPCmd::SET_DATA_SERVICE      , 0xBE},
+    {MPCmd::ADD_DATA_SERVICE      , 0xBF},
+    {MPCmd::WRITE_32B_IN_DN       , 0xC0},
+    {MPCmd::READ_32B_IN_DN        , 0xC1},
+    {MPCmd::GET_CUR_CARD_CPZ      , 0xC2},
+    {MPCmd::CANCEL_USER_REQUEST   , 0xC3},
+    {MPCmd::PLEASE_RETRY          , 0x0002},
+    {MPCmd::READ_FLASH_NODE       , 0xC5},
+    {MPCmd::WRITE_FLASH_NODE      , 0xC6},
+    {MPCmd::GET_FAVORITE          , 0xC7},
+    {MPCmd::SET_FAVORITE          , 0xC8},
+    {MPCmd::GET_STARTING_PARENT   , 0xC9},
+    {MPCmd::SET_STARTING_PARENT   , 0xCA},
+    {MPCmd::GET_CTRVALUE          , 0xCB},
+    {MPCmd::SET_CTRVALUE          , 0xCC},
+    {MPCmd::ADD_CARD_CPZ_CTR      , 0xCD},
+    {MPCmd::GET_CARD_CPZ_CTR      , 0xCE},
+    {MPCmd::CARD_CPZ_CTR_PACKET   , 0xCF},
+    {MPCmd::GET_30_FREE_SLOTS     , 0xD0},
+    {MPCmd::GET_DN_START_PARENT   , 0xD1},
+    {MPCmd::SET_DN_START_PARENT   , 0xD2},
+    {MPCmd::END_MEMORYMGMT        , 0x0001},
+    {MPCmd::SET_USER_CHANGE_NB    , 0xD4},
+    {MPCmd::GET_DESCRIPTION       , 0xD5},
+    {MPCmd::GET_USER_CHANGE_NB    , 0xD6},
+    {MPCmd::SET_DESCRIPTION       , 0xD8},
+    {MPCmd::LOCK_DEVICE           , 0xD9},
+    {MPCmd::GET_SERIAL            , 0xDA},
+    {MPCmd::CMD_DBG_MESSAGE       , 0x8000},
+    {MPCmd::GET_PLAT_INFO         , 0x0003},
+    {MPCmd::STORE_CREDENTIAL      , 0x0006},
+    {MPCmd::GET_CREDENTIAL        , 0x0007},
+    {MPCmd::CMD_DBG_OPEN_DISP_BUFFER    , 0x8001},
+    {MPCmd::CMD_DBG_SEND_TO_DISP_BUFFER , 0x8002},
+    {MPCmd::CMD_DBG_CLOSE_DISP_BUFFER   , 0x8003},
+    {MPCmd::CMD_DBG_ERASE_DATA_FLASH    , 0x8004},
+    {MPCmd::CMD_DBG_IS_DATA_FLASH_READY , 0x8005},
+    {MPCmd::CMD_DBG_DATAFLASH_WRITE_256B, 0x8006},
+    {MPCmd::CMD_DBG_REBOOT_TO_BOOTLOADER, 0x8007},
+    {MPCmd::CMD_DBG_GET_ACC_32_SAMPLES  , 0x8008},
+    {MPCmd::CMD_DBG_FLASH_AUX_MCU       , 0x8009},
+    {MPCmd::CMD_DBG_GET_PLAT_INFO       , 0x800A},
+    {MPCmd::CMD_DBG_REINDEX_BUNDLE      , 0x800B},
+};
+
 MessageProtocolBLE::MessageProtocolBLE()
 {
     fillCommandMapping();
@@ -7,36 +104,52 @@ MessageProtocolBLE::MessageProtocolBLE()
 
 QVector<QByteArray> MessageProtocolBLE::createPackets(const QByteArray &data, MPCmd::Command c)
 {
-    QByteArray messagePayload;
-    const auto bleCommandIter = m_commandMapping.find(c);
-    if (bleCommandIter == m_commandMapping.end())
+    if (!m_commandMapping->contains(c))
     {
         qCritical() << MPCmd::printCmd(c) << " is not implemented for BLE";
         return QVector<QByteArray>();
     }
-    const quint16 bleCommandId = bleCommandIter.value();
-    messagePayload.append(static_cast<char>(bleCommandId&0xFF));
-    messagePayload.append(static_cast<char>((bleCommandId&0xFF00)>>8));
+    const quint16 bleCommandId = m_commandMapping->deviceId(c);
     const int dataSize = data.size();
-    messagePayload.append(static_cast<char>(dataSize&0xFF));
-    messagePayload.append(static_cast<char>((dataSize&0xFF00)>>8));
-    messagePayload.append(data);
+    const char messageHeader[MESSAGE_HEADER_SIZE] = {
+        static_cast<char>(bleCommandId&0xFF),
+        static_cast<char>((bleCommandId&0xFF00)>>8),
+        static_cast<char>(dataSize&0xFF),
+        static_cast<char>((dataSize&0xFF00)>>8)
+    };
+
+    //Each packet is allocated once at its final size and filled in place,
+    //from the message header first and then straight from data
+    const int messageSize = MESSAGE_HEADER_SIZE + dataSize;
+    const int packetNum = ((messageSize + HID_PACKET_DATA_PAYLOAD - 1) / HID_PACKET_DATA_PAYLOAD) - 1;
     QVector<QByteArray> packets;
-    int remainingBytes = messagePayload.size();
-    const int packetNum = ((remainingBytes + HID_PACKET_DATA_PAYLOAD - 1) / HID_PACKET_DATA_PAYLOAD) - 1;
-    int curPacketId = 0;
+    packets.reserve(packetNum + 1);
     int curByteIndex = 0;
-    while (curPacketId <= packetNum)
+    for (int curPacketId = 0; curPacketId <= packetNum; ++curPacketId)
     {
-        QByteArray packet;
-        int payloadLength = remainingBytes < HID_PACKET_DATA_PAYLOAD ? remainingBytes : HID_PACKET_DATA_PAYLOAD;
-        packet.append(static_cast<char>(m_flipBit|m_ackFlag|payloadLength));
-        packet.append(static_cast<char>((curPacketId << 4)|packetNum));
-        packet.append(messagePayload.mid(curByteIndex, payloadLength));
+        const int remainingBytes = messageSize - curByteIndex;
+        const int payloadLength = remainingBytes < HID_PACKET_DATA_PAYLOAD ? remainingBytes : HID_PACKET_DATA_PAYLOAD;
+        QByteArray packet(PACKET_HEADER_SIZE + payloadLength, Qt::Uninitialized);
+        char *out = packet.data();
+        out[0] = static_cast<char>(m_flipBit|m_ackFlag|payloadLength);
+        out[1] = static_cast<char>((curPacketId << 4)|packetNum);
+        out += PACKET_HEADER_SIZE;
+
+        int toCopy = payloadLength;
+        if (curByteIndex < MESSAGE_HEADER_SIZE)
+        {
+            const int headerBytes = qMin(toCopy, MESSAGE_HEADER_SIZE - curByteIndex);
+            memcpy(out, messageHeader + curByteIndex, static_cast<size_t>(headerBytes));
+            out += headerBytes;
+            toCopy -= headerBytes;
+        }
+        if (toCopy > 0)
+        {
+            const int dataIndex = curByteIndex + payloadLength - toCopy - MESSAGE_HEADER_SIZE;
+            memcpy(out, data.constData() + dataIndex, static_cast<size_t>(toCopy));
+        }
 
-        remainingBytes -= payloadLength;
         curByteIndex += payloadLength;
-        ++curPacketId;
         packets.append(packet);
     }
     flipBit();
@@ -57,7 +170,7 @@ quint16 MessageProtocolBLE::getMessageSize(const QByteArray &data)
 MPCmd::Command MessageProtocolBLE::getCommand(const QByteArray &data)
 {
    const quint16 bleCommandId = toIntFromLittleEndian(static_cast<quint8>(data[CMD_LOWER_BYTE]), static_cast<quint8>(data[CMD_UPPER_BYTE]));
-   return MPCmd::Command(m_commandMapping.key(bleCommandId));
+   return m_commandMapping->command(bleCommandId, MPCmd::EXPORT_FLASH_START);
 }
 
 quint8 MessageProtocolBLE::getFirstPayloadByte(const QByteArray &data)
@@ -72,12 +185,24 @@ quint8 MessageProtocolBLE::getPayloadByteAt(const QByteArray &data, int at)
 
 QByteArray MessageProtocolBLE::getFullPayload(const QByteArray &data)
 {
-    int startingPos = getStartingPayloadPosition(data);
-    if (FIRST_PAYLOAD_BYTE_PACKET == startingPos)
+    return getPayloadView(data).toByteArray();
+}
+
+PayloadView MessageProtocolBLE::getPayloadView(const QByteArray &data)
+{
+    PayloadView view;
+    const int startingPos = getStartingPayloadPosition(data);
+    int size = data.size() - startingPos;
+    if (FIRST_PAYLOAD_BYTE_MESSAGE == startingPos)
     {
-        return data.mid(startingPos);
+        size = qMin(size, static_cast<int>(getMessageSize(data)));
     }
-    return data.mid(startingPos, getMessageSize(data));
+    if (size > 0)
+    {
+        view.data = data.constData() + startingPos;
+        view.size = size;
+    }
+    return view;
 }
 
 QByteArray MessageProtocolBLE::getPayloadBytes(const QByteArray &data, int fromPayload, int to)
@@ -171,102 +296,8 @@ void MessageProtocolBLE::flipBit()
 
 void MessageProtocolBLE::fillCommandMapping()
 {
-    //TODO fill commandId mapping, when they are implemented for BLE
-    m_commandMapping = {
-        {MPCmd::EXPORT_FLASH_START    , 0x8A},
-        {MPCmd::EXPORT_FLASH          , 0x8B},
-        {MPCmd::EXPORT_FLASH_END      , 0x8C},
-        {MPCmd::IMPORT_FLASH_BEGIN    , 0x8D},
-        {MPCmd::IMPORT_FLASH          , 0x8E},
-        {MPCmd::IMPORT_FLASH_END      , 0x8F},
-        {MPCmd::EXPORT_EEPROM_START   , 0x90},
-        {MPCmd::EXPORT_EEPROM         , 0x91},
-        {MPCmd::EXPORT_EEPROM_END     , 0x92},
-        {MPCmd::IMPORT_EEPROM_BEGIN   , 0x93},
-        {MPCmd::IMPORT_EEPROM         , 0x94},
-        {MPCmd::IMPORT_EEPROM_END     , 0x95},
-        {MPCmd::ERASE_EEPROM          , 0x96},
-        {MPCmd::ERASE_FLASH           , 0x97},
-        {MPCmd::ERASE_SMC             , 0x98},
-        {MPCmd::DRAW_BITMAP           , 0x99},
-        {MPCmd::SET_FONT              , 0x9A},
-        {MPCmd::USB_KEYBOARD_PRESS    , 0x9B},
-        {MPCmd::STACK_FREE            , 0x9C},
-        {MPCmd::CLONE_SMARTCARD       , 0x9D},
-        {MPCmd::DEBUG                 , 0xA0},
-        {MPCmd::PING                  , 0x0001},
-        {MPCmd::VERSION               , 0xA2},
-        {MPCmd::CONTEXT               , 0xA3},
-        {MPCmd::GET_LOGIN             , 0xA4},
-        {MPCmd::GET_PASSWORD          , 0xA5},
-        {MPCmd::SET_LOGIN             , 0xA6},
-        {MPCmd::SET_PASSWORD          , 0xA7},
-        {MPCmd::CHECK_PASSWORD        , 0xA8},
-        {MPCmd::ADD_CONTEXT           , 0xA9},
-        {MPCmd::SET_BOOTLOADER_PWD    , 0xAA},
-        {MPCmd::JUMP_TO_BOOTLOADER    , 0xAB},
-        {MPCmd::GET_RANDOM_NUMBER     , 0x0008},
-        {MPCmd::START_MEMORYMGMT      , 0xAD},
-        {MPCmd::IMPORT_MEDIA_START    , 0xAE},
-        {MPCmd::IMPORT_MEDIA          , 0xAF},
-        {MPCmd::IMPORT_MEDIA_END      , 0xB0},
-        {MPCmd::SET_MOOLTIPASS_PARM   , 0xB1},
-        {MPCmd::GET_MOOLTIPASS_PARM   , 0xB2},
-        {MPCmd::RESET_CARD            , 0xB3},
-        {MPCmd::READ_CARD_LOGIN       , 0xB4},
-        {MPCmd::READ_CARD_PASS        , 0xB5},
-        {MPCmd::SET_CARD_LOGIN        , 0xB6},
-        {MPCmd::SET_CARD_PASS         , 0xB7},
-        {MPCmd::ADD_UNKNOWN_CARD      , 0xB8},
-        {MPCmd::MOOLTIPASS_STATUS     , 0x0001},
-        {MPCmd::FUNCTIONAL_TEST_RES   , 0xBA},
-        {MPCmd::SET_DATE              , 0x0004},
-        {MPCmd::SET_UID               , 0xBC},
-        {MPCmd::GET_UID               , 0xBD},
-        {MPCmd::SET_DATA_SERVICE      , 0xBE},
-        {MPCmd::ADD_DATA_SERVICE      , 0xBF},
-        {MPCmd::WRITE_32B_IN_DN       , 0xC0},
-        {MPCmd::READ_32B_IN_DN        , 0xC1},
-        {MPCmd::GET_CUR_CARD_CPZ      , 0xC2},
-        {MPCmd::CANCEL_USER_REQUEST   , 0xC3},
-        {MPCmd::PLEASE_RETRY          , 0x0002},
-        {MPCmd::READ_FLASH_NODE       , 0xC5},
-        {MPCmd::WRITE_FLASH_NODE      , 0xC6},
-        {MPCmd::GET_FAVORITE          , 0xC7},
-        {MPCmd::SET_FAVORITE          , 0xC8},
-        {MPCmd::GET_STARTING_PARENT   , 0xC9},
-        {MPCmd::SET_STARTING_PARENT   , 0xCA},
-        {MPCmd::GET_CTRVALUE          , 0xCB},
-        {MPCmd::SET_CTRVALUE          , 0xCC},
-        {MPCmd::ADD_CARD_CPZ_CTR      , 0xCD},
-        {MPCmd::GET_CARD_CPZ_CTR      , 0xCE},
-        {MPCmd::CARD_CPZ_CTR_PACKET   , 0xCF},
-        {MPCmd::GET_30_FREE_SLOTS     , 0xD0},
-        {MPCmd::GET_DN_START_PARENT   , 0xD1},
-        {MPCmd::SET_DN_START_PARENT   , 0xD2},
-        {MPCmd::END_MEMORYMGMT        , 0x0001},
-        {MPCmd::SET_USER_CHANGE_NB    , 0xD4},
-        {MPCmd::GET_DESCRIPTION       , 0xD5},
-        {MPCmd::GET_USER_CHANGE_NB    , 0xD6},
-        {MPCmd::SET_DESCRIPTION       , 0xD8},
-        {MPCmd::LOCK_DEVICE           , 0xD9},
-        {MPCmd::GET_SERIAL            , 0xDA},
-        {MPCmd::CMD_DBG_MESSAGE       , 0x8000},
-        {MPCmd::GET_PLAT_INFO         , 0x0003},
-        {MPCmd::STORE_CREDENTIAL      , 0x0006},
-        {MPCmd::GET_CREDENTIAL        , 0x0007},
-        {MPCmd::CMD_DBG_OPEN_DISP_BUFFER    , 0x8001},
-        {MPCmd::CMD_DBG_SEND_TO_DISP_BUFFER , 0x8002},
-        {MPCmd::CMD_DBG_CLOSE_DISP_BUFFER   , 0x8003},
-        {MPCmd::CMD_DBG_ERASE_DATA_FLASH    , 0x8004},
-        {MPCmd::CMD_DBG_IS_DATA_FLASH_READY , 0x8005},
-        {MPCmd::CMD_DBG_DATAFLASH_WRITE_256B, 0x8006},
-        {MPCmd::CMD_DBG_REBOOT_TO_BOOTLOADER, 0x8007},
-        {MPCmd::CMD_DBG_GET_ACC_32_SAMPLES  , 0x8008},
-        {MPCmd::CMD_DBG_FLASH_AUX_MCU       , 0x8009},
-        {MPCmd::CMD_DBG_GET_PLAT_INFO       , 0x800A},
-        {MPCmd::CMD_DBG_REINDEX_BUNDLE      , 0x800B},
-    };
+    static const CommandMap commandMap(BLE_COMMANDS);
+    m_commandMapping = &commandMap;
 }
 
 int MessageProtocolBLE::getStartingPayloadPosition(const QByteArray &data) const
@@ -17,6 +17,7 @@ public:
     virtual quint8 getFirstPayloadByte(const QByteArray &data) override;
     virtual quint8 getPayloadByteAt(const QByteArray &data, int at) override;
     virtual QByteArray getFullPayload(const QByteArray &data) override;
+    virtual PayloadView getPayloadView(const QByteArray &data) override;
     virtual QByteArray getPayloadBytes(const QByteArray &data, int fromPayload, int to) override;
 
     virtual quint32 getSerialNumber(const QByteArray &data) override;
@@ -43,6 +44,8 @@ private:
     static constexpr quint8 MESSAGE_FLIP_BIT = 0x80;
     static constexpr quint8 ACK_FLAG_BIT = 0x40;
     static constexpr int HID_PACKET_DATA_PAYLOAD = 62;
+    static constexpr int PACKET_HEADER_SIZE = 2;
+    static constexpr int MESSAGE_HEADER_SIZE = 4;
     static constexpr quint8 CMD_LOWER_BYTE = 2;
     static constexpr quint8 CMD_UPPER_BYTE = 3;
     static constexpr quint8 PAYLOAD_LEN_LOWER_BYTE = 4;
@@ -17,6 +17,7 @@ public:
     virtual quint8 getFirstPayloadByte(const QByteArray &data) override;
     virtual quint8 getPayloadByteAt(const QByteArray &data, int at) override;
     virtual QByteArray getFullPayload(const QByteArray &data) override;
+    virtual PayloadView getPayloadView(const QByteArray &data) override;
     virtual QByteArray getPayloadBytes(const QByteArray &data, int fromPayload, int to) override;
 
     virtual quint32 getSerialNumber(const QByteArray &data) override;
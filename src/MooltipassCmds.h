@@ -144,6 +144,9 @@ public:
         };
         Q_ENUM(Command)
 
+    //Number of generic commands, keep in sync with the last Command
+    static constexpr int COMMAND_COUNT = CMD_DBG_REINDEX_BUNDLE + 1;
+
     static Command from(char c);
     static bool isUserRequired(Command c);
     static QString toHexString(Command c);
@@ -28,11 +28,11 @@
 #include <QComboBox>
 #include <array>
 #include "QtAwesome.h"
-#include "zxcvbn.h"
 #include <QDebug>
 
 #include "PasswordProfilesModel.h"
 #include "AppGui.h"
+#include "PasswordStrengthScorer.h"
 
 #define PROGRESS_STYLE \
     "QProgressBar {" \
@@ -84,6 +84,30 @@ void PasswordLineEdit::setPasswordProfilesModel(PasswordProfilesModel *passwordP
         m_passwordOptionsPopup->setPasswordProfilesModel(passwordProfilesModel);
 }
 
+void PasswordLineEdit::setStrengthScoringEnabled(bool enabled)
+{
+    if (m_strengthScoring == enabled)
+        return;
+
+    m_strengthScoring = enabled;
+    if (enabled)
+    {
+        connect(this, &QLineEdit::textChanged, this, &PasswordLineEdit::scoreText);
+        scoreText(text());
+    }
+    else
+        disconnect(this, &QLineEdit::textChanged, this, &PasswordLineEdit::scoreText);
+}
+
+void PasswordLineEdit::scoreText(const QString &text)
+{
+    //Keystrokes are debounced by the scorer, only the last one is computed
+    AppGui::passwordStrengthScorer()->score(this, text, [this](double entropy)
+    {
+        Q_EMIT strengthChanged(entropy);
+    });
+}
+
 void PasswordLineEdit::showPasswordOptions()
 {
     if (!m_passwordOptionsPopup)
@@ -325,7 +349,14 @@ void PasswordOptionsPopup::generatePassword()
     //Done
     m_passwordLabel->setText(result);
 
-    double entropy = ZxcvbnMatch(result, 0, 0);
+    AppGui::passwordStrengthScorer()->score(this, result, [this](double entropy)
+    {
+        updateStrength(entropy);
+    });
+}
+
+void PasswordOptionsPopup::updateStrength(double entropy)
+{
     m_entropy->setText(tr("Entropy: %1 bit").arg(QString::number(entropy, 'f', 2)));
     if (entropy > m_strengthBar->maximum())
         entropy = m_strengthBar->maximum();
@@ -333,25 +364,24 @@ void PasswordOptionsPopup::generatePassword()
     m_strengthBar->setValue(entropy);
 
     QString style = QStringLiteral(PROGRESS_STYLE);
-    if (entropy < 35)
+    switch (PasswordStrengthScorer::levelForEntropy(entropy))
     {
+    case PasswordStrengthScorer::StrengthPoor:
         m_strengthBar->setStyleSheet(style.arg("#c0392b"));
         m_quality->setText(tr("Password Quality: %1").arg(tr("Poor")));
-    }
-    else if (entropy >= 35 && entropy < 55)
-    {
+        break;
+    case PasswordStrengthScorer::StrengthWeak:
         m_strengthBar->setStyleSheet(style.arg("#f39c1f"));
         m_quality->setText(tr("Password Quality: %1").arg(tr("Weak")));
-    }
-    else if (entropy >= 55 && entropy < 100)
-    {
+        break;
+    case PasswordStrengthScorer::StrengthGood:
         m_strengthBar->setStyleSheet(style.arg("#11d116"));
         m_quality->setText(tr("Password Quality: %1").arg(tr("Good")));
-    }
-    else
-    {
+        break;
+    case PasswordStrengthScorer::StrengthExcellent:
         m_strengthBar->setStyleSheet(style.arg("#27ae60"));
         m_quality->setText(tr("Password Quality: %1").arg(tr("Excellent")));
+        break;
     }
 }
 
@@ -46,6 +46,7 @@ Q_SIGNALS:
 
 private Q_SLOTS:
     void generatePassword();
+    void updateStrength(double entropy);
     std::vector<char> generateCustomPasswordPool();
     void updatePasswordLength(int);
     void emitPassword();
@@ -76,6 +77,12 @@ public:
     PasswordLineEdit(QWidget* parent = nullptr);
     void setPasswordProfilesModel(PasswordProfilesModel *passwordProfilesModel);
 
+    //Score typed password in background and report it with strengthChanged
+    void setStrengthScoringEnabled(bool enabled);
+
+Q_SIGNALS:
+    void strengthChanged(double entropy);
+
 protected:
     QAction *m_showPassword, *m_hidePassword;
     void setPasswordVisible(bool visible);
@@ -84,7 +91,9 @@ private:
     QAction *m_generateRandom;
     PasswordProfilesModel *m_passwordProfilesModel;
     PasswordOptionsPopup *m_passwordOptionsPopup;
+    bool m_strengthScoring = false;
     void showPasswordOptions();
+    void scoreText(const QString &text);
 };
 
 class LockedPasswordLineEdit : public PasswordLineEdit
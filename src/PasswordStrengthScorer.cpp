@@ -0,0 +1,191 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#include "PasswordStrengthScorer.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include "zxcvbn.h"
+
+void PasswordStrengthWorker::score(quint64 requestId, const QString &password)
+{
+    emit scored(requestId, ZxcvbnMatch(password.toUtf8().constData(), nullptr, nullptr));
+}
+
+void PasswordStrengthWorker::scoreBatch(quint64 requestId, const QHash<QString, QString> &passwords)
+{
+    QHash<QString, double> entropies;
+    for (auto it = passwords.constBegin(); it != passwords.constEnd(); ++it)
+        entropies[it.key()] = ZxcvbnMatch(it.value().toUtf8().constData(), nullptr, nullptr);
+
+    emit batchScored(requestId, entropies);
+}
+
+PasswordStrengthScorer::PasswordStrengthScorer(QObject *parent) :
+    QObject(parent),
+    m_worker(new PasswordStrengthWorker)
+{
+    qRegisterMetaType<QHash<QString, QString>>();
+    qRegisterMetaType<QHash<QString, double>>();
+
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(this, &PasswordStrengthScorer::requestScore, m_worker, &PasswordStrengthWorker::score);
+    connect(this, &PasswordStrengthScorer::requestScoreBatch, m_worker, &PasswordStrengthWorker::scoreBatch);
+    connect(m_worker, &PasswordStrengthWorker::scored, this, &PasswordStrengthScorer::onScored);
+    connect(m_worker, &PasswordStrengthWorker::batchScored, this, &PasswordStrengthScorer::onBatchScored);
+
+    m_debounceTimer.setSingleShot(true);
+    m_debounceTimer.setInterval(DEFAULT_DEBOUNCE_MS);
+    connect(&m_debounceTimer, &QTimer::timeout, this, &PasswordStrengthScorer::flushPending);
+
+    m_thread.setObjectName("PasswordStrengthScorer");
+    m_thread.start(QThread::LowPriority);
+}
+
+PasswordStrengthScorer::~PasswordStrengthScorer()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+void PasswordStrengthScorer::score(QObject *context, const QString &password, StrengthCb cb)
+{
+    //Older requests of this context, waiting or already sent to the worker,
+    //would overwrite this result
+    quint64 generation = m_nextRequestId++;
+    m_latestGeneration[context] = generation;
+
+    auto it = m_cache.constFind(cacheKey(password));
+    if (it != m_cache.constEnd())
+    {
+        m_debounced.remove(context);
+        cb(it.value());
+        return;
+    }
+
+    m_debounced[context] = { context, password, std::move(cb), generation };
+    m_debounceTimer.start();
+}
+
+void PasswordStrengthScorer::scoreBatch(QObject *context, const QHash<QString, QString> &passwords, StrengthBatchCb cb)
+{
+    PendingBatch batch { context, {}, {}, std::move(cb) };
+    QHash<QString, QString> toScore;
+
+    for (auto it = passwords.constBegin(); it != passwords.constEnd(); ++it)
+    {
+        const QByteArray key = cacheKey(it.value());
+        auto c = m_cache.constFind(key);
+        if (c != m_cache.constEnd())
+        {
+            batch.cached[it.key()] = c.value();
+        }
+        else
+        {
+            toScore[it.key()] = it.value();
+            batch.keys[it.key()] = key;
+        }
+    }
+
+    if (toScore.isEmpty())
+    {
+        batch.cb(batch.cached);
+        return;
+    }
+
+    quint64 requestId = m_nextRequestId++;
+    m_inFlightBatches[requestId] = batch;
+    emit requestScoreBatch(requestId, toScore);
+}
+
+void PasswordStrengthScorer::setDebounceInterval(int ms)
+{
+    m_debounceTimer.setInterval(ms);
+}
+
+void PasswordStrengthScorer::clearCache()
+{
+    m_cache.clear();
+}
+
+PasswordStrengthScorer::StrengthLevel PasswordStrengthScorer::levelForEntropy(double entropy)
+{
+    if (entropy < 35)
+        return StrengthPoor;
+    if (entropy < 55)
+        return StrengthWeak;
+    if (entropy < 100)
+        return StrengthGood;
+    return StrengthExcellent;
+}
+
+void PasswordStrengthScorer::flushPending()
+{
+    for (const PendingRequest &req: qAsConst(m_debounced))
+    {
+        if (!req.context)
+            continue;
+
+        quint64 requestId = m_nextRequestId++;
+        m_inFlight[requestId] = req;
+        emit requestScore(requestId, req.password);
+    }
+    m_debounced.clear();
+}
+
+void PasswordStrengthScorer::onScored(quint64 requestId, double entropy)
+{
+    PendingRequest req = m_inFlight.take(requestId);
+    cacheEntropy(cacheKey(req.password), entropy);
+
+    //A newer request for this context was made, it was either answered
+    //from the cache or its result will come later
+    if (!req.context || m_latestGeneration.value(req.context) != req.generation)
+        return;
+
+    m_latestGeneration.remove(req.context);
+    req.cb(entropy);
+}
+
+void PasswordStrengthScorer::onBatchScored(quint64 requestId, const QHash<QString, double> &entropies)
+{
+    PendingBatch batch = m_inFlightBatches.take(requestId);
+    for (auto it = entropies.constBegin(); it != entropies.constEnd(); ++it)
+        cacheEntropy(batch.keys.value(it.key()), it.value());
+
+    if (!batch.context)
+        return;
+
+    QHash<QString, double> result = batch.cached;
+    for (auto it = entropies.constBegin(); it != entropies.constEnd(); ++it)
+        result[it.key()] = it.value();
+
+    batch.cb(result);
+}
+
+QByteArray PasswordStrengthScorer::cacheKey(const QString &password)
+{
+    return QCryptographicHash::hash(password.toUtf8(), QCryptographicHash::Sha256);
+}
+
+void PasswordStrengthScorer::cacheEntropy(const QByteArray &key, double entropy)
+{
+    if (m_cache.size() >= MAX_CACHE_SIZE)
+        m_cache.clear();
+    m_cache[key] = entropy;
+}
@@ -0,0 +1,128 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#ifndef PASSWORDSTRENGTHSCORER_H
+#define PASSWORDSTRENGTHSCORER_H
+
+#include <QObject>
+#include <QHash>
+#include <QPointer>
+#include <QThread>
+#include <QTimer>
+#include <functional>
+
+typedef std::function<void(double entropy)> StrengthCb;
+typedef std::function<void(const QHash<QString, double> &entropies)> StrengthBatchCb;
+
+/* Lives on the scorer thread, the only place where zxcvbn is called */
+class PasswordStrengthWorker : public QObject
+{
+    Q_OBJECT
+public slots:
+    void score(quint64 requestId, const QString &password);
+    void scoreBatch(quint64 requestId, const QHash<QString, QString> &passwords);
+
+signals:
+    void scored(quint64 requestId, double entropy);
+    void batchScored(quint64 requestId, const QHash<QString, double> &entropies);
+};
+
+class PasswordStrengthScorer : public QObject
+{
+    Q_OBJECT
+public:
+    enum StrengthLevel
+    {
+        StrengthPoor,
+        StrengthWeak,
+        StrengthGood,
+        StrengthExcellent,
+    };
+
+    explicit PasswordStrengthScorer(QObject *parent = nullptr);
+    ~PasswordStrengthScorer();
+
+    /* Score password on the worker thread. Requests coming from the same
+     * context within the debounce interval are collapsed into the last one,
+     * cb is not called if context is destroyed in the meantime.
+     */
+    void score(QObject *context, const QString &password, StrengthCb cb);
+
+    /* Score a whole set of passwords (ie. all credentials of the card) in
+     * one go, keys are kept as is in the result. cb is called right away
+     * when all passwords are already cached.
+     */
+    void scoreBatch(QObject *context, const QHash<QString, QString> &passwords, StrengthBatchCb cb);
+
+    void setDebounceInterval(int ms);
+    void clearCache();
+
+    static StrengthLevel levelForEntropy(double entropy);
+    static bool isWeak(double entropy) { return levelForEntropy(entropy) <= StrengthWeak; }
+
+signals:
+    void requestScore(quint64 requestId, const QString &password);
+    void requestScoreBatch(quint64 requestId, const QHash<QString, QString> &passwords);
+
+private slots:
+    void flushPending();
+    void onScored(quint64 requestId, double entropy);
+    void onBatchScored(quint64 requestId, const QHash<QString, double> &entropies);
+
+private:
+    struct PendingRequest
+    {
+        QPointer<QObject> context;
+        QString password;
+        StrengthCb cb;
+        quint64 generation;
+    };
+
+    struct PendingBatch
+    {
+        QPointer<QObject> context;
+        QHash<QString, double> cached;
+        //Cache keys of the passwords sent to the worker
+        QHash<QString, QByteArray> keys;
+        StrengthBatchCb cb;
+    };
+
+    static QByteArray cacheKey(const QString &password);
+    void cacheEntropy(const QByteArray &key, double entropy);
+
+    QThread m_thread;
+    PasswordStrengthWorker *m_worker = nullptr;
+    QTimer m_debounceTimer;
+
+    quint64 m_nextRequestId = 1;
+    //Last score() call of each context, only its result is delivered
+    QHash<QObject *, quint64> m_latestGeneration;
+    //Waiting for the debounce timer, one per context
+    QHash<QObject *, PendingRequest> m_debounced;
+    //Sent to the worker, waiting for the result
+    QHash<quint64, PendingRequest> m_inFlight;
+    QHash<quint64, PendingBatch> m_inFlightBatches;
+
+    //Hashed password -> entropy, passwords are never kept in clear
+    QHash<QByteArray, double> m_cache;
+
+    static const int DEFAULT_DEBOUNCE_MS = 150;
+    static const int MAX_CACHE_SIZE = 4096;
+};
+
+#endif // PASSWORDSTRENGTHSCORER_H
@@ -946,6 +946,7 @@ void QtAwesome::addNamedCodepoint( const QString& name, int codePoint)
 void QtAwesome::setDefaultOption(const QString& name, const QVariant& value)
 {
     defaultOptions_.insert( name, value );
+    pixmapCache_.clear();
 }
 
 
@@ -1024,6 +1025,48 @@ QIcon QtAwesome::icon(QtAwesomeIconPainter* painter, const QVariantMap& optionMa
     return QIcon( engine );
 }
 
+/// Returns the glyph of the given code-point rendered with a single color
+/// The pixmap is rendered once and then kept in a cache keyed on the glyph, color, size, mode and device pixel ratio,
+/// use it instead of icon() for things painted very often like item view rows
+/// <code>
+///     painter->drawPixmap( rect, awesome->pixmap( fa::star, Qt::yellow, rect.size(), painter->device()->devicePixelRatioF() ) );
+/// </code>
+QPixmap QtAwesome::pixmap( int character, const QColor& color, const QSize& size, qreal devicePixelRatio, QIcon::Mode mode )
+{
+    const PixmapKey key = { character, color.rgba(), size.width(), size.height(), qRound(devicePixelRatio * 100), static_cast<int>(mode) };
+    auto it = pixmapCache_.constFind( key );
+    if( it != pixmapCache_.constEnd() ) {
+        return it.value();
+    }
+
+    QVariantMap optionMap = defaultOptions_;
+    optionMap.insert( "text", QString( QChar(static_cast<int>(character)) ) );
+    optionMap.insert( "color", color );
+    optionMap.insert( "color-disabled", color );
+    optionMap.insert( "color-active", color );
+    optionMap.insert( "color-selected", color );
+
+    QPixmap pm( size * devicePixelRatio );
+    pm.setDevicePixelRatio( devicePixelRatio );
+    pm.fill( Qt::transparent );
+    {
+        QPainter p( &pm );
+        fontIconPainter_->paint( this, &p, QRect( QPoint(0,0), size ), mode, QIcon::Off, optionMap );
+    }
+
+    if( pixmapCache_.size() >= MAX_CACHED_PIXMAPS ) {
+        pixmapCache_.clear();
+    }
+    pixmapCache_.insert( key, pm );
+    return pm;
+}
+
+/// Drops all the glyphs rendered by pixmap()
+void QtAwesome::clearPixmapCache()
+{
+    pixmapCache_.clear();
+}
+
 /// Adds a named icon-painter to the QtAwesome icon map
 /// As the name applies the ownership is passed over to QtAwesome
 ///
@@ -15,6 +15,7 @@
 #include <QIcon>
 #include <QIconEngine>
 #include <QPainter>
+#include <QPixmap>
 #include <QRect>
 #include <QVariantMap>
 
@@ -777,6 +778,9 @@ public:
     QIcon icon( const QString& name, const QVariantMap& options = QVariantMap() );
     QIcon icon(QtAwesomeIconPainter* painter, const QVariantMap& optionMap = QVariantMap() );
 
+    QPixmap pixmap( int character, const QColor& color, const QSize& size, qreal devicePixelRatio = 1.0, QIcon::Mode mode = QIcon::Normal );
+    void clearPixmapCache();
+
     void give( const QString& name, QtAwesomeIconPainter* painter );
 
     QFont font( int size );
@@ -791,6 +795,33 @@ private:
     QHash<QString, QtAwesomeIconPainter*> painterMap_;     ///< A map of custom painters
     QVariantMap defaultOptions_;                           ///< The default icon options
     QtAwesomeIconPainter* fontIconPainter_;                ///< A special painter fo painting codepoints
+
+    /// Key of a rendered glyph in the pixmap cache
+    struct PixmapKey
+    {
+        int character;
+        QRgb color;
+        int width;
+        int height;
+        int dprPercent;
+        int mode;
+
+        bool operator==( const PixmapKey& other ) const
+        {
+            return character == other.character && color == other.color
+                    && width == other.width && height == other.height
+                    && dprPercent == other.dprPercent && mode == other.mode;
+        }
+
+        friend uint qHash( const PixmapKey& key, uint seed = 0 )
+        {
+            return ::qHash( key.character, seed ) ^ ::qHash( key.color, seed )
+                    ^ ::qHash( (key.width << 16) ^ key.height, seed ) ^ ::qHash( (key.dprPercent << 4) ^ key.mode, seed );
+        }
+    };
+
+    QHash<PixmapKey, QPixmap> pixmapCache_;                ///< Rendered glyphs, cleared when full or when default options change
+    static const int MAX_CACHED_PIXMAPS = 512;
 };
 
 
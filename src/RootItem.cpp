@@ -20,13 +20,72 @@ ServiceItem *RootItem::addService(const QString &sServiceName)
 
 ServiceItem *RootItem::findServiceByName(const QString &sServiceName)
 {
-    foreach (TreeItem *pItem, m_vChilds)
+    return m_hServices.value(serviceKey(sServiceName), nullptr);
+}
+
+void RootItem::addChild(TreeItem *pItem)
+{
+    TreeItem::addChild(pItem);
+    indexService(dynamic_cast<ServiceItem *>(pItem));
+}
+
+bool RootItem::removeOne(TreeItem *pItem)
+{
+    if (!TreeItem::removeOne(pItem))
+        return false;
+
+    unindexService(pItem, pItem->name());
+    return true;
+}
+
+void RootItem::clear()
+{
+    m_hServices.clear();
+    TreeItem::clear();
+}
+
+void RootItem::childRenamed(TreeItem *pChild, const QString &sOldName)
+{
+    unindexService(pChild, sOldName);
+    indexService(dynamic_cast<ServiceItem *>(pChild));
+}
+
+QString RootItem::serviceKey(const QString &sServiceName)
+{
+    // Services are matched case insensitively
+    return sServiceName.toCaseFolded();
+}
+
+void RootItem::indexService(ServiceItem *pServiceItem)
+{
+    if (pServiceItem == nullptr)
+        return;
+
+    // Keep the first service in case of duplicates, like a linear search would
+    QString sKey = serviceKey(pServiceItem->name());
+    if (!m_hServices.contains(sKey))
+        m_hServices.insert(sKey, pServiceItem);
+}
+
+void RootItem::unindexService(TreeItem *pItem, const QString &sServiceName)
+{
+    QString sKey = serviceKey(sServiceName);
+    auto it = m_hServices.find(sKey);
+    if (it == m_hServices.end() || it.value() != pItem)
+        return;
+
+    m_hServices.erase(it);
+
+    // Another service with the same name may now be the first one
+    foreach (TreeItem *pChild, m_vChilds)
     {
-        ServiceItem *pServiceItem = dynamic_cast<ServiceItem *>(pItem);
-        if ((pServiceItem != nullptr) && (pServiceItem->name().compare(sServiceName, Qt::CaseInsensitive) == 0))
-            return pServiceItem;
+        ServiceItem *pServiceItem = dynamic_cast<ServiceItem *>(pChild);
+        if ((pServiceItem != nullptr) && (pServiceItem != pItem) && (serviceKey(pServiceItem->name()) == sKey))
+        {
+            m_hServices.insert(sKey, pServiceItem);
+            break;
+        }
     }
-    return nullptr;
 }
 
 void RootItem::setItemsStatus(const Status &eStatus)
@@ -40,26 +99,6 @@ void RootItem::setItemsStatus(const Status &eStatus)
     }
 }
 
-void RootItem::removeUnusedItems()
-{
-    foreach (TreeItem *pItem, m_vChilds) {
-        QVector<TreeItem *> vChilds = pItem->childs();
-        foreach (TreeItem *pChild, vChilds)
-        {
-            if (pChild->status() == UNUSED)
-            {
-                if (pItem->removeOne(pChild))
-                    delete pChild;
-            }
-        }
-        if (pItem->status() == UNUSED)
-        {
-            if (removeOne(pItem))
-                delete pItem;
-        }
-    }
-}
-
 TreeItem::TreeType RootItem::treeType() const
 {
     return Root;
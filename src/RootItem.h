@@ -1,6 +1,9 @@
 #ifndef ROOTITEM_H
 #define ROOTITEM_H
 
+// Qt
+#include <QHash>
+
 // Application
 #include "TreeItem.h"
 class ServiceItem;
@@ -14,9 +17,22 @@ public:
     ServiceItem *addService(const QString &sServiceName);
     ServiceItem *findServiceByName(const QString &sServiceName);
     void setItemsStatus(const Status &eStatus);
-    void removeUnusedItems();
 
+    virtual void addChild(TreeItem *pItem) Q_DECL_OVERRIDE;
+    virtual bool removeOne(TreeItem *pItem) Q_DECL_OVERRIDE;
+    virtual void clear() Q_DECL_OVERRIDE;
     virtual TreeType treeType()  const Q_DECL_OVERRIDE;
+
+protected:
+    virtual void childRenamed(TreeItem *pChild, const QString &sOldName) Q_DECL_OVERRIDE;
+
+private:
+    static QString serviceKey(const QString &sServiceName);
+    void indexService(ServiceItem *pServiceItem);
+    void unindexService(TreeItem *pItem, const QString &sServiceName);
+
+    // Case folded service name -> first service with that name
+    QHash<QString, ServiceItem *> m_hServices;
 };
 
 #endif // ROOTITEM_H
@@ -4,7 +4,9 @@
 
 ServiceItem::ServiceItem(const QString &sServiceName):
     TreeItem(sServiceName),
-    m_bIsExpanded(false)
+    m_bIsExpanded(false),
+    m_bLoginsFetched(false),
+    m_bLoginsCacheValid(false)
 {
 }
 
@@ -21,13 +23,64 @@ LoginItem *ServiceItem::addLogin(const QString &sLoginName)
 
 LoginItem *ServiceItem::findLoginByName(const QString &sLoginName)
 {
-    foreach (TreeItem *pItem, m_vChilds)
+    return m_hLogins.value(sLoginName, nullptr);
+}
+
+void ServiceItem::addChild(TreeItem *pItem)
+{
+    TreeItem::addChild(pItem);
+    m_bLoginsCacheValid = false;
+    indexLogin(dynamic_cast<LoginItem *>(pItem));
+}
+
+bool ServiceItem::removeOne(TreeItem *pItem)
+{
+    if (!TreeItem::removeOne(pItem))
+        return false;
+
+    m_bLoginsCacheValid = false;
+    unindexLogin(pItem, pItem->name());
+    return true;
+}
+
+void ServiceItem::clear()
+{
+    m_hLogins.clear();
+    m_bLoginsCacheValid = false;
+    TreeItem::clear();
+}
+
+void ServiceItem::childRenamed(TreeItem *pChild, const QString &sOldName)
+{
+    m_bLoginsCacheValid = false;
+    unindexLogin(pChild, sOldName);
+    indexLogin(dynamic_cast<LoginItem *>(pChild));
+}
+
+void ServiceItem::indexLogin(LoginItem *pLoginItem)
+{
+    if ((pLoginItem != nullptr) && !m_hLogins.contains(pLoginItem->name()))
+        m_hLogins.insert(pLoginItem->name(), pLoginItem);
+}
+
+void ServiceItem::unindexLogin(TreeItem *pItem, const QString &sLoginName)
+{
+    auto it = m_hLogins.find(sLoginName);
+    if (it == m_hLogins.end() || it.value() != pItem)
+        return;
+
+    m_hLogins.erase(it);
+
+    // Another login with the same name may now be the first one
+    foreach (TreeItem *pChild, m_vChilds)
     {
-        LoginItem *pLoginItem = dynamic_cast<LoginItem *>(pItem);
-        if ((pLoginItem != nullptr) && (pLoginItem->name().compare(sLoginName, Qt::CaseSensitive) == 0))
-            return pLoginItem;
+        LoginItem *pLoginItem = dynamic_cast<LoginItem *>(pChild);
+        if ((pLoginItem != nullptr) && (pLoginItem != pItem) && (pLoginItem->name() == sLoginName))
+        {
+            m_hLogins.insert(sLoginName, pLoginItem);
+            break;
+        }
     }
-    return nullptr;
 }
 
 bool ServiceItem::isExpanded() const
@@ -40,7 +93,27 @@ void ServiceItem::setExpanded(bool bExpanded)
     m_bIsExpanded = bExpanded;
 }
 
+bool ServiceItem::loginsFetched() const
+{
+    return m_bLoginsFetched;
+}
+
+void ServiceItem::setLoginsFetched(bool bFetched)
+{
+    m_bLoginsFetched = bFetched;
+}
+
 QString ServiceItem::logins() const
+{
+    if (!m_bLoginsCacheValid)
+    {
+        m_sLoginsCache = buildLogins();
+        m_bLoginsCacheValid = true;
+    }
+    return m_sLoginsCache;
+}
+
+QString ServiceItem::buildLogins() const
 {
     QString sLogins = "";
     int nLogins = childCount();
@@ -90,7 +163,7 @@ QString ServiceItem::logins() const
 
 QDate ServiceItem::bestUpdateDate(Qt::SortOrder order) const
 {
-    QDate bestDate = m_dUpdatedDate;
+    QDate bestDate = updatedDate();
     if (m_vChilds.length() > 0)
     {
         bestDate = m_vChilds[0]->updatedDate();
@@ -1,6 +1,9 @@
 #ifndef SERVICEITEM_H
 #define SERVICEITEM_H
 
+// Qt
+#include <QHash>
+
 // Application
 #include "TreeItem.h"
 class LoginItem;
@@ -15,12 +18,32 @@ public:
     LoginItem *findLoginByName(const QString &sLoginName);
     bool isExpanded() const;
     void setExpanded(bool bExpanded);
+    bool loginsFetched() const;
+    void setLoginsFetched(bool bFetched);
     QString logins() const;
 
+    virtual void addChild(TreeItem *pItem) Q_DECL_OVERRIDE;
+    virtual bool removeOne(TreeItem *pItem) Q_DECL_OVERRIDE;
+    virtual void clear() Q_DECL_OVERRIDE;
     virtual QDate bestUpdateDate(Qt::SortOrder order) const Q_DECL_OVERRIDE;
     virtual TreeType treeType()  const Q_DECL_OVERRIDE;
+
+protected:
+    virtual void childRenamed(TreeItem *pChild, const QString &sOldName) Q_DECL_OVERRIDE;
+
 private:
+    QString buildLogins() const;
+    void indexLogin(LoginItem *pLoginItem);
+    void unindexLogin(TreeItem *pItem, const QString &sLoginName);
+
     bool m_bIsExpanded;
+    // Login rows are only exposed to views once the service got expanded
+    bool m_bLoginsFetched;
+    // Text painted for every row, rebuilt only when logins change
+    mutable QString m_sLoginsCache;
+    mutable bool m_bLoginsCacheValid;
+    // Login name (case sensitive) -> first login with that name
+    QHash<QString, LoginItem *> m_hLogins;
 };
 
 #endif // SERVICEITEM_H
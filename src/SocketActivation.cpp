@@ -0,0 +1,103 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#include "SocketActivation.h"
+
+#include <QDebug>
+
+//Set once the sockets passed by systemd are known, even after they are taken
+static bool activated = false;
+
+#ifdef Q_OS_LINUX
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+
+//First passed descriptor, see sd_listen_fds(3)
+#define SD_LISTEN_FDS_START     3
+
+static QList<qintptr> listenFds()
+{
+    QList<qintptr> fds;
+
+    bool ok = false;
+    qint64 pid = qgetenv("LISTEN_PID").toLongLong(&ok);
+    int count = qgetenv("LISTEN_FDS").toInt();
+
+    //Do not pass the sockets to child processes
+    unsetenv("LISTEN_PID");
+    unsetenv("LISTEN_FDS");
+    unsetenv("LISTEN_FDNAMES");
+
+    if (!ok || pid != getpid())
+        return fds;
+
+    for (int fd = SD_LISTEN_FDS_START; fd < SD_LISTEN_FDS_START + count; fd++)
+    {
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+        fds.append(fd);
+    }
+
+    activated = !fds.isEmpty();
+    qInfo() << "Socket activation: got" << fds.size() << "listening sockets";
+    return fds;
+}
+
+static int socketFamily(qintptr fd)
+{
+    struct sockaddr_storage addr;
+    socklen_t len = sizeof(addr);
+    if (getsockname(static_cast<int>(fd), reinterpret_cast<struct sockaddr *>(&addr), &len) < 0)
+        return -1;
+    return addr.ss_family;
+}
+#endif
+
+QList<qintptr> &SocketActivation::sockets()
+{
+#ifdef Q_OS_LINUX
+    static QList<qintptr> fds = listenFds();
+#else
+    static QList<qintptr> fds;
+#endif
+    return fds;
+}
+
+bool SocketActivation::isActivated()
+{
+    sockets();
+    return activated;
+}
+
+qintptr SocketActivation::takeSocket(Family family)
+{
+#ifdef Q_OS_LINUX
+    QList<qintptr> &fds = sockets();
+    for (int i = 0;i < fds.size();i++)
+    {
+        int f = socketFamily(fds.at(i));
+        if ((family == Local && f == AF_UNIX) ||
+            (family == Tcp && (f == AF_INET || f == AF_INET6)))
+            return fds.takeAt(i);
+    }
+#else
+    Q_UNUSED(family)
+#endif
+    return -1;
+}
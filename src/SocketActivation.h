@@ -0,0 +1,48 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#ifndef SOCKETACTIVATION_H
+#define SOCKETACTIVATION_H
+
+#include <QtGlobal>
+#include <QList>
+
+/* Sockets passed by systemd socket activation (LISTEN_FDS protocol).
+ * Sockets are matched on their address family, so a single socket unit
+ * can provide both the local socket and the websocket port.
+ */
+class SocketActivation
+{
+public:
+    enum Family
+    {
+        Local,
+        Tcp,
+    };
+
+    //Returns a listening socket of that family and removes it from the
+    //list, or -1 if the daemon was not started with one
+    static qintptr takeSocket(Family family);
+    //True if the daemon was started by systemd with listening sockets
+    static bool isActivated();
+
+private:
+    static QList<qintptr> &sockets();
+};
+
+#endif // SOCKETACTIVATION_H
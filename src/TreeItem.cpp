@@ -11,6 +11,8 @@ TreeItem::TreeItem(const QString &sName, const QDate &dCreatedDate, const QDate
     m_sName(sName),
     m_dUpdatedDate(dCreatedDate),
     m_dAccessedDate(dUpdatedDate),
+    m_bUpdatedDateParsed(true),
+    m_bAccessedDateParsed(true),
     m_sDescription(sDescription)
 {
 }
@@ -27,7 +29,13 @@ const QString &TreeItem::name() const
 
 void TreeItem::setName(const QString &sName)
 {
+    if (sName == m_sName)
+        return;
+
+    QString sOldName = m_sName;
     m_sName = sName;
+    if (m_pParentItem)
+        m_pParentItem->childRenamed(this, sOldName);
 }
 
 TreeItem *TreeItem::child(int iIndex)
@@ -72,27 +80,59 @@ void TreeItem::setStatus(const Status &eStatus)
 
 const QDate &TreeItem::updatedDate() const
 {
+    if (!m_bUpdatedDateParsed)
+    {
+        m_dUpdatedDate = QDate::fromString(m_sUpdatedDateIso, Qt::ISODate);
+        m_bUpdatedDateParsed = true;
+    }
     return m_dUpdatedDate;
 }
 
 QDate TreeItem::bestUpdateDate(Qt::SortOrder) const
 {
-    return m_dUpdatedDate;
+    return updatedDate();
 }
 
 void TreeItem::setUpdatedDate(const QDate &dDate)
 {
     m_dUpdatedDate = dDate;
+    m_sUpdatedDateIso.clear();
+    m_bUpdatedDateParsed = true;
+}
+
+bool TreeItem::setUpdatedDate(const QString &sIsoDate)
+{
+    // Returns true if the date differs from the previous ISO date
+    bool bChanged = sIsoDate != m_sUpdatedDateIso;
+    m_sUpdatedDateIso = sIsoDate;
+    m_bUpdatedDateParsed = false;
+    return bChanged;
 }
 
 const QDate &TreeItem::accessedDate() const
 {
+    if (!m_bAccessedDateParsed)
+    {
+        m_dAccessedDate = QDate::fromString(m_sAccessedDateIso, Qt::ISODate);
+        m_bAccessedDateParsed = true;
+    }
     return m_dAccessedDate;
 }
 
 void TreeItem::setAccessedDate(const QDate &dDate)
 {
     m_dAccessedDate = dDate;
+    m_sAccessedDateIso.clear();
+    m_bAccessedDateParsed = true;
+}
+
+bool TreeItem::setAccessedDate(const QString &sIsoDate)
+{
+    // Returns true if the date differs from the previous ISO date
+    bool bChanged = sIsoDate != m_sAccessedDateIso;
+    m_sAccessedDateIso = sIsoDate;
+    m_bAccessedDateParsed = false;
+    return bChanged;
 }
 
 const QString &TreeItem::description() const
@@ -146,6 +186,12 @@ void TreeItem::clear()
     m_vChilds.clear();
 }
 
+void TreeItem::childRenamed(TreeItem *pChild, const QString &sOldName)
+{
+    Q_UNUSED(pChild);
+    Q_UNUSED(sOldName);
+}
+
 TreeItem::TreeType TreeItem::treeType() const
 {
     return Base;
@@ -23,8 +23,10 @@ public:
     const QDate &updatedDate() const;
     virtual QDate bestUpdateDate(Qt::SortOrder order) const;
     void setUpdatedDate(const QDate &dDate);
+    bool setUpdatedDate(const QString &sIsoDate);
     const QDate &accessedDate() const;
     void setAccessedDate(const QDate &dDate);
+    bool setAccessedDate(const QString &sIsoDate);
     const QString &description() const;
     void setDescription(const QString &sDescription);
     TreeItem *child(int iIndex);
@@ -34,9 +36,9 @@ public:
     TreeItem *parentItem();
     int row() const;
     virtual QVariant data(int iColumn) const;
-    void addChild(TreeItem *pItem);
-    bool removeOne(TreeItem *pItem);
-    void clear();
+    virtual void addChild(TreeItem *pItem);
+    virtual bool removeOne(TreeItem *pItem);
+    virtual void clear();
     virtual TreeType treeType()  const;
 
 protected:
@@ -45,13 +47,21 @@ protected:
                       const QDate &dUpdatedDate = QDate::currentDate(),
                       const QString &setDescription = "");
 
+    // Called on the parent when a child name changes, so lookup indices can follow
+    virtual void childRenamed(TreeItem *pChild, const QString &sOldName);
+
 protected:
     QVector<TreeItem *> m_vChilds;
     TreeItem *m_pParentItem;
     Status m_eStatus;
     QString m_sName;
-    QDate m_dUpdatedDate;
-    QDate m_dAccessedDate;
+    // Dates coming from the daemon are kept as ISO strings and parsed on first read
+    mutable QDate m_dUpdatedDate;
+    mutable QDate m_dAccessedDate;
+    QString m_sUpdatedDateIso;
+    QString m_sAccessedDateIso;
+    mutable bool m_bUpdatedDateParsed;
+    mutable bool m_bAccessedDateParsed;
     QString m_sDescription;
 };
 
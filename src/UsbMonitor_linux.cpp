@@ -26,7 +26,7 @@ QString UsbMonitor_linux::REMOVE_ACTION = "remove";
 
 UsbMonitor_linux::UsbMonitor_linux()
 {
-    struct udev* udev = udev_new();
+    udev = udev_new();
     mon = udev_monitor_new_from_netlink(udev, "udev");
 
     //Filter hidraw devices
@@ -43,49 +43,70 @@ UsbMonitor_linux::UsbMonitor_linux()
 UsbMonitor_linux::~UsbMonitor_linux()
 {
     delete sockMonitor;
+    udev_monitor_unref(mon);
+    udev_unref(udev);
 }
 
 void UsbMonitor_linux::monitorUSB(int fd)
 {
     Q_UNUSED(fd);
     const auto dev = udev_monitor_receive_device(mon);
-    const char *dev_path = udev_device_get_devnode(dev);
-    bool unrefed = false;
-    if (dev)
+    if (!dev)
     {
-        QString node(udev_device_get_devnode(dev));
-        QString action(udev_device_get_action(dev));
-        qDebug() << "Node: " << node;
-        qDebug() << "Action: " << action;
-        if (ADD_ACTION == action && node.contains("hidraw"))
-        {
-            /**
-              * Need to add a delay, because without
-              * it the device haven't detected yet
-              * during usb enumeration.
-              */
-            bool isBLE;
-            if (MPDevice_linux::checkDevice(dev, isBLE))
-            {
-                QTimer::singleShot(100, [this, dev_path, isBLE]()
-                {
-                    emit usbDeviceAdded(QString::fromUtf8(dev_path), isBLE);
-                });
-            }
-            unrefed = true;
-        }
-        else if (REMOVE_ACTION == action && node.contains("hidraw"))
+        printf("No Device from receive_device(). An error occured.\n");
+        return;
+    }
+
+    QString node = QString::fromUtf8(udev_device_get_devnode(dev));
+    QString syspath = QString::fromUtf8(udev_device_get_syspath(dev));
+    QString action = QString::fromUtf8(udev_device_get_action(dev));
+    udev_device_unref(dev);
+
+    qDebug() << "Node: " << node;
+    qDebug() << "Action: " << action;
+    if (!node.contains("hidraw"))
+        return;
+
+    if (ADD_ACTION == action)
+    {
+        checkAddedDevice(syspath, 0);
+    }
+    else if (REMOVE_ACTION == action)
+    {
+        //hidraw numbers are reused, forget what we knew about this one
+        MPDevice_linux::forgetDevice(syspath);
+        emit usbDeviceRemoved(node);
+    }
+}
+
+void UsbMonitor_linux::checkAddedDevice(const QString &syspath, int attempt)
+{
+    struct udev_device *raw_dev = udev_device_new_from_syspath(udev, syspath.toUtf8().constData());
+    if (!raw_dev)
+        return; //already gone
+
+    QString node = QString::fromUtf8(udev_device_get_devnode(raw_dev));
+    bool isBLE = false;
+    auto res = MPDevice_linux::checkDevice(raw_dev, isBLE);
+    udev_device_unref(raw_dev);
+
+    if (res == MPDevice_linux::CheckResult::Mooltipass)
+    {
+        emit usbDeviceAdded(node, isBLE);
+    }
+    else if (res == MPDevice_linux::CheckResult::NotReady)
+    {
+        if (attempt >= CHECK_RETRY_COUNT)
         {
-            emit usbDeviceRemoved(QString::fromUtf8(dev_path));
+            qWarning() << "Device" << node << "is still not accessible, giving up";
+            return;
         }
-        //If it has not been unrefed in checkDevice
-        if (!unrefed)
+
+        int delay = CHECK_RETRY_FIRST_MS << attempt;
+        qDebug() << "Device" << node << "not ready, retrying in" << delay << "ms";
+        QTimer::singleShot(delay, this, [this, syspath, attempt]()
         {
-            udev_device_unref(dev);
-        }
-    }
-    else
-    {
-        printf("No Device from receive_device(). An error occured.\n");
+            checkAddedDevice(syspath, attempt + 1);
+        });
     }
 }
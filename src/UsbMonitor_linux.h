@@ -34,6 +34,9 @@ public:
     }
     ~UsbMonitor_linux();
 
+    //udev context shared with device enumeration
+    struct udev *getUdev() const { return udev; }
+
 public slots:
     void monitorUSB(int fd);
 signals:
@@ -43,9 +46,17 @@ signals:
 private:
     UsbMonitor_linux();
 
+    void checkAddedDevice(const QString &syspath, int attempt);
+
     QSocketNotifier *sockMonitor = nullptr;
+    struct udev *udev = nullptr;
     struct udev_monitor* mon;
 
+    //The hidraw node may not be accessible yet when the add event is
+    //received (udev rules not applied), retry with a short backoff
+    static const int CHECK_RETRY_COUNT = 6;
+    static const int CHECK_RETRY_FIRST_MS = 10;
+
     static QString ADD_ACTION;
     static QString REMOVE_ACTION;
 };
@@ -18,6 +18,8 @@
  ******************************************************************************/
 #include "WSClient.h"
 #include "SystemNotifications/SystemNotification.h"
+#include "IpcSocket.h"
+#include "WsCompression.h"
 
 #define WS_URI                      "ws://localhost"
 #define QUERY_RANDOM_NUMBER_TIME    10 * 60 * 1000 //10 min
@@ -36,6 +38,7 @@ WSClient::WSClient(QObject *parent):
 
 WSClient::~WSClient()
 {
+    delete ipcSocket;
     if (wsocket)
     {
         if (wsocket->state() == QAbstractSocket::ConnectedState)
@@ -46,6 +49,64 @@ WSClient::~WSClient()
 }
 
 void WSClient::openWebsocket()
+{
+    //Try the local socket first, the websocket is opened if the daemon
+    //does not provide it
+    openIpcSocket();
+}
+
+void WSClient::openIpcSocket()
+{
+    if (!ipcSocket)
+    {
+        ipcSocket = new IpcSocket();
+        connect(ipcSocket, &IpcSocket::helloReceived, this, &WSClient::onIpcHello);
+        connect(ipcSocket, &IpcSocket::jsonReceived, this, &WSClient::onIpcMessageReceived);
+        connect(ipcSocket, &IpcSocket::connectionFailed, this, &WSClient::onIpcFailed);
+        connect(ipcSocket, &IpcSocket::disconnected, [=]()
+        {
+            //Closed during the handshake, the daemon refused us
+            if (ipcReady)
+                onWsDisconnected();
+            else
+                onIpcFailed();
+        });
+    }
+
+    ipcReady = false;
+    ipcSocket->connectToServer(IpcSocket::daemonSocketName());
+}
+
+void WSClient::onIpcFailed()
+{
+    if (ipcSocket)
+    {
+        ipcSocket->disconnect(this);
+        ipcSocket->deleteLater();
+        ipcSocket = nullptr;
+    }
+    ipcReady = false;
+    openWsSocket();
+}
+
+void WSClient::onIpcHello(const QJsonObject &obj)
+{
+    if (obj["encoding"].toString() != IpcSocket::encodingName())
+    {
+        qDebug() << "Daemon local socket uses encoding" << obj["encoding"].toString() << ", using websocket";
+        onIpcFailed();
+        return;
+    }
+
+    ipcSocket->sendHello({{ "client", "gui" }});
+    ipcReady = true;
+
+    qDebug() << "Local socket connected to daemon" << obj["daemon_pid"].toString();
+    queryRandomNumbers();
+    emit wsConnected();
+}
+
+void WSClient::openWsSocket()
 {
     if (!wsocket)
     {
@@ -56,12 +117,24 @@ void WSClient::openWebsocket()
                 this, SLOT(onWsError()));
     }
 
-    QString url = QString("%1:%2").arg(WS_URI).arg(MOOLTICUTE_DAEMON_PORT);
+    //Large messages (memory management data, exports) come compressed
+    QUrl url(QString("%1:%2").arg(WS_URI).arg(MOOLTICUTE_DAEMON_PORT));
+    QUrlQuery query;
+    query.addQueryItem(WsCompression::queryItem(), WsCompression::algorithm());
+    url.setQuery(query);
     wsocket->open(url);
 }
 
 void WSClient::closeWebsocket()
 {
+    if (ipcSocket)
+    {
+        ipcSocket->disconnect(this);
+        ipcSocket->deleteLater();
+        ipcSocket = nullptr;
+    }
+    ipcReady = false;
+
     if (wsocket)
     {
         wsocket->deleteLater();
@@ -74,6 +147,12 @@ void WSClient::sendJsonData(const QJsonObject &data)
     if (!isConnected())
         return;
 
+    if (isIpcConnected())
+    {
+        ipcSocket->sendJson(data);
+        return;
+    }
+
     QJsonDocument jdoc(data);
     // qDebug().noquote() << jdoc.toJson();
     wsocket->sendTextMessage(jdoc.toJson());
@@ -83,16 +162,25 @@ void WSClient::onWsConnected()
 {
     qDebug() << "Websocket connected";
     connect(wsocket, &QWebSocket::textMessageReceived, this, &WSClient::onTextMessageReceived);
+    connect(wsocket, &QWebSocket::binaryMessageReceived, this, &WSClient::onBinaryMessageReceived);
     queryRandomNumbers();
     emit wsConnected();
 }
 
 bool WSClient::isConnected() const
 {
+    if (isIpcConnected())
+        return true;
+
     return wsocket &&
             wsocket->state() == QAbstractSocket::ConnectedState;
 }
 
+bool WSClient::isIpcConnected() const
+{
+    return ipcSocket && ipcReady && ipcSocket->isConnected();
+}
+
 bool WSClient::isDeviceConnected() const
 {
     return get_connected();
@@ -139,9 +227,36 @@ void WSClient::onTextMessageReceived(const QString &message)
         qWarning() << "JSON parse error " << err.errorString();
         return;
     }
-    QJsonObject rootobj = jdoc.object();
     qDebug().noquote() << "New message: " << Common::maskLog(message);
+    processMessage(jdoc.object());
+}
+
+void WSClient::onBinaryMessageReceived(const QByteArray &frame)
+{
+    QByteArray message;
+    if (!WsCompression::uncompress(frame, message))
+    {
+        qWarning() << "Invalid compressed message of" << frame.size() << "bytes";
+        return;
+    }
+
+    onTextMessageReceived(QString::fromUtf8(message));
+}
+
+void WSClient::onIpcMessageReceived(const QJsonObject &rootobj)
+{
+    //Messages are not text anymore, only build one when it is logged
+    if (QLoggingCategory::defaultCategory()->isDebugEnabled())
+    {
+        QString message = QJsonDocument(rootobj).toJson(QJsonDocument::Compact);
+        qDebug().noquote() << "New message: " << Common::maskLog(message);
+    }
+
+    processMessage(rootobj);
+}
 
+void WSClient::processMessage(QJsonObject rootobj)
+{
     if (rootobj["msg"] == "mp_connected")
     {
         set_connected(true);
@@ -208,6 +323,7 @@ void WSClient::onTextMessageReceived(const QString &message)
         {
             QString service;
             bool abortRequest = false;
+            QString message = QJsonDocument(rootobj).toJson(QJsonDocument::Compact);
             abortRequest = !SystemNotification::instance().displayDomainSelectionNotification(domain, subdomain, service, message);
             if (abortRequest)
             {
@@ -233,6 +349,7 @@ void WSClient::onTextMessageReceived(const QString &message)
         {
             QString loginName;
             bool abortRequest = false;
+            QString message = QJsonDocument(rootobj).toJson(QJsonDocument::Compact);
             abortRequest = !SystemNotification::instance().displayLoginRequestNotification(o["service"].toString(), loginName, message);
             if (abortRequest)
             {
@@ -437,6 +554,13 @@ void WSClient::onTextMessageReceived(const QString &message)
         QJsonObject o = rootobj["data"].toObject();
         emit displayUploadBundleResult(o["success"].toBool());
     }
+    else if (rootobj["msg"] == "fetch_data_stats")
+    {
+        QJsonObject o = rootobj["data"].toObject();
+        emit fetchDataStats(static_cast<qint64>(o["bytes"].toDouble()),
+                            static_cast<qint64>(o["bytes_per_sec"].toDouble()),
+                            o["finished"].toBool());
+    }
     else if (rootobj["msg"] == "send_hibp")
     {
         QJsonObject o = rootobj["data"].toObject();
@@ -25,6 +25,8 @@
 #include "Common.h"
 #include "QtHelper.h"
 
+class IpcSocket;
+
 class WSClient: public QObject
 {
     Q_OBJECT
@@ -86,6 +88,8 @@ public:
     bool isMPBLE() const;
 
     bool isConnected() const;
+    //Connected to the daemon through the local socket
+    bool isIpcConnected() const;
 
     bool isDeviceConnected() const;
 
@@ -149,6 +153,7 @@ signals:
     void displayStatusWarning();
     void displayDebugPlatInfo(int auxMajor, int auxMinor, int mainMajor, int mainMinor);
     void displayUploadBundleResult(bool success);
+    void fetchDataStats(qint64 bytes, qint64 bytesPerSec, bool finished);
     void deleteDataNodesFinished();
 
 public slots:
@@ -162,11 +167,21 @@ private slots:
     void onWsDisconnected();
     void onWsError();
     void onTextMessageReceived(const QString &message);
+    void onBinaryMessageReceived(const QByteArray &frame);
+    void onIpcHello(const QJsonObject &obj);
+    void onIpcMessageReceived(const QJsonObject &rootobj);
+    void onIpcFailed();
 
 private:
     void udateParameters(const QJsonObject &data);
+    void openIpcSocket();
+    void openWsSocket();
+    void processMessage(QJsonObject rootobj);
 
     QWebSocket *wsocket = nullptr;
+    //Preferred transport, wsocket is only used when the daemon has no local socket
+    IpcSocket *ipcSocket = nullptr;
+    bool ipcReady = false;
 
     QJsonObject memData;
     QJsonArray filesCache;
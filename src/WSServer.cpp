@@ -19,6 +19,8 @@
 #include "WSServer.h"
 #include "WSServerCon.h"
 #include "AppDaemon.h"
+#include "version.h"
+#include "SocketActivation.h"
 
 WSServer::WSServer()
 {
@@ -30,7 +32,17 @@ bool WSServer::initialize()
                                     QWebSocketServer::NonSecureMode,
                                     this);
 
-    if (wsServer->listen(AppDaemon::getListenAddress(), MOOLTICUTE_DAEMON_PORT))
+    bool wsListening;
+    qintptr wsFd = SocketActivation::takeSocket(SocketActivation::Tcp);
+    if (wsFd >= 0)
+    {
+        //The listen address comes from the socket unit in that case
+        wsListening = wsServer->setSocketDescriptor(static_cast<int>(wsFd));
+    }
+    else
+        wsListening = wsServer->listen(AppDaemon::getListenAddress(), MOOLTICUTE_DAEMON_PORT);
+
+    if (wsListening)
     {
         qDebug() << "Moolticute daemon websocket server listening on port " << MOOLTICUTE_DAEMON_PORT;
         connect(wsServer, &QWebSocketServer::newConnection, this, &WSServer::onNewConnection);
@@ -41,11 +53,33 @@ bool WSServer::initialize()
         return false;
     }
 
+    //The GUI connects here first and only uses the websocket as a fallback,
+    //a failure is not fatal
+    ipcServer = new QLocalServer(this);
+    ipcServer->setSocketOptions(QLocalServer::UserAccessOption);
+    bool ipcListening;
+    qintptr ipcFd = SocketActivation::takeSocket(SocketActivation::Local);
+    if (ipcFd >= 0)
+    {
+        //Started by systemd, the socket already exists and accepted
+        //connections are waiting in its backlog
+        ipcListening = ipcServer->listen(ipcFd);
+    }
+    else
+    {
+        QLocalServer::removeServer(MOOLTICUTE_DAEMON_IPC_SOCK);
+        ipcListening = ipcServer->listen(MOOLTICUTE_DAEMON_IPC_SOCK);
+    }
+    if (ipcListening)
+        connect(ipcServer, &QLocalServer::newConnection, this, &WSServer::onNewIpcConnection);
+    else
+        qWarning() << "Failed to listen on local socket" << MOOLTICUTE_DAEMON_IPC_SOCK << ipcServer->errorString();
+
     connect(MPManager::Instance(), SIGNAL(mpConnected(MPDevice*)), this, SLOT(mpAdded(MPDevice*)));
     connect(MPManager::Instance(), SIGNAL(mpDisconnected(MPDevice*)), this, SLOT(mpRemoved(MPDevice*)));
 
-    if (MPManager::Instance()->getDeviceCount() > 0)
-        mpAdded(MPManager::Instance()->getDevice(0));
+    for (int i = 0;i < MPManager::Instance()->getDeviceCount();i++)
+        mpAdded(MPManager::Instance()->getDevice(i));
 
     return true;
 }
@@ -54,6 +88,38 @@ WSServer::~WSServer()
 {
     wsServer->close();
     qDeleteAll(wsClients.begin(), wsClients.end());
+    qDeleteAll(ipcClients.begin(), ipcClients.end());
+}
+
+void WSServer::addClient(WSServerCon *c)
+{
+    for (MPDevice *dev: qAsConst(devices))
+        c->addDevice(dev, dev == getDefaultDevice(), false);
+    c->sendInitialStatus();
+    //let clients send broadcast messages
+    connect(c, &WSServerCon::notifyAllClients, this, &WSServer::notifyClients);
+    connect(c, &WSServerCon::sendMessageToGUI, this, &WSServer::notifyGUI);
+    emit clientsChanged();
+}
+
+void WSServer::removeClient(WSServerCon *c)
+{
+    qDebug() << "Connection closed " << c;
+
+    for (MPDevice *dev: qAsConst(devices))
+    {
+        if (isMemModeLocked(dev) &&
+            lockedUids.value(dev) == c->getClientUid())
+        {
+            qWarning() << "Exiting MMM because client exits without doing it.";
+            dev->exitMemMgmtMode();
+        }
+    }
+
+    c->stopFetchData();
+
+    c->deleteLater();
+    emit clientsChanged();
 }
 
 void WSServer::onNewConnection()
@@ -62,11 +128,7 @@ void WSServer::onNewConnection()
 
     connect(wsocket, &QWebSocket::disconnected, this, &WSServer::socketDisconnected);
     WSServerCon *c = new WSServerCon(wsocket);
-    c->resetDevice(device);
-    c->sendInitialStatus();
-    //let clients send broadcast messages
-    connect(c, &WSServerCon::notifyAllClients, this, &WSServer::notifyClients);
-    connect(c, &WSServerCon::sendMessageToGUI, this, &WSServer::notifyGUI);
+    addClient(c);
 
     wsClients[wsocket] = c;
     wsClientsReverse[c] = wsocket;
@@ -79,19 +141,61 @@ void WSServer::socketDisconnected()
     QWebSocket *wsocket = qobject_cast<QWebSocket *>(sender());
     if (wsocket && wsClients.contains(wsocket))
     {
-        qDebug() << "Connection closed " << wsClients[wsocket];
+        WSServerCon *c = wsClients.take(wsocket);
+        wsClientsReverse.remove(c);
+        removeClient(c);
+    }
+}
 
-        if (isMemModeLocked() &&
-            lockedUid == wsClients[wsocket]->getClientUid())
-        {
-            qWarning() << "Exiting MMM because client exits without doing it.";
-            device->exitMemMgmtMode();
-        }
+void WSServer::onNewIpcConnection()
+{
+    IpcSocket *ipc = new IpcSocket(ipcServer->nextPendingConnection());
+    connect(ipc, &IpcSocket::helloReceived, this, &WSServer::ipcHelloReceived);
+    connect(ipc, &IpcSocket::disconnected, this, &WSServer::ipcDisconnected);
 
-        wsClients[wsocket]->deleteLater();
-        wsClientsReverse.remove(wsClients[wsocket]);
-        wsClients.remove(wsocket);
+    //Handshake, the GUI learns who is listening and answers with its own hello
+    ipc->sendHello({{ "daemon_pid", QString::number(qApp->applicationPid()) },
+                    { "version", QStringLiteral(APP_VERSION) }});
+}
+
+void WSServer::ipcHelloReceived(const QJsonObject &obj)
+{
+    IpcSocket *ipc = qobject_cast<IpcSocket *>(sender());
+    if (!ipc || ipcClients.contains(ipc))
+        return;
+
+    if (obj["encoding"].toString() != IpcSocket::encodingName())
+    {
+        qWarning() << "Local socket client uses encoding" << obj["encoding"].toString() << ", closing it";
+        ipc->close();
+        return;
+    }
+
+    WSServerCon *c = new WSServerCon(ipc);
+    addClient(c);
+
+    ipcClients[ipc] = c;
+    ipcClientsReverse[c] = ipc;
+
+    qDebug() << "New local connection";
+}
+
+void WSServer::ipcDisconnected()
+{
+    IpcSocket *ipc = qobject_cast<IpcSocket *>(sender());
+    if (!ipc)
+        return;
+
+    //Connection closed before the handshake was done
+    if (!ipcClients.contains(ipc))
+    {
+        ipc->deleteLater();
+        return;
     }
+
+    WSServerCon *c = ipcClients.take(ipc);
+    ipcClientsReverse.remove(c);
+    removeClient(c);
 }
 
 void WSServer::notifyClients(const QJsonObject &obj)
@@ -100,10 +204,22 @@ void WSServer::notifyClients(const QJsonObject &obj)
     {
         it.value()->sendJsonMessage(obj);
     }
+    for (auto it = ipcClients.begin();it != ipcClients.end();it++)
+    {
+        it.value()->sendJsonMessage(obj);
+    }
 }
 
 void WSServer::notifyGUI(const QString &message, bool &isGuiRunning)
 {
+    //Only the GUI connects through the local socket
+    if (!ipcClients.isEmpty())
+    {
+        ipcClients.begin().value()->sendJsonMessageString(message);
+        isGuiRunning = true;
+        return;
+    }
+
     for (auto it = wsClients.begin(); it != wsClients.end(); ++it)
     {
         //Notify GUI
@@ -119,40 +235,45 @@ void WSServer::notifyGUI(const QString &message, bool &isGuiRunning)
 
 void WSServer::mpAdded(MPDevice *dev)
 {
-    if (device == dev)
+    if (devices.contains(dev))
         return;
 
-    //tell clients that current mp is not connected anymore
-    //and use new connected mp instead
-    if (device && device != dev)
-        mpRemoved(device);
-
-    qDebug() << "Mooltipass connected";
-    device = dev;
+    qDebug() << "Mooltipass connected:" << MPManager::Instance()->getDeviceId(dev);
+    devices.append(dev);
 
+    //The new device becomes the default one
     for (auto it = wsClients.begin();it != wsClients.end();it++)
     {
-        it.value()->resetDevice(device);
+        it.value()->addDevice(dev, true);
+    }
+    for (auto it = ipcClients.begin();it != ipcClients.end();it++)
+    {
+        it.value()->addDevice(dev, true);
     }
 }
 
 void WSServer::mpRemoved(MPDevice *dev)
 {
-    if (device == dev)
-    {
-        qDebug() << "Mooltipass disconnected";
-        device = nullptr;
+    if (!devices.removeOne(dev))
+        return;
 
-        for (auto it = wsClients.begin();it != wsClients.end();it++)
-        {
-            it.value()->resetDevice(device);
-        }
+    qDebug() << "Mooltipass disconnected:" << MPManager::Instance()->getDeviceId(dev);
+    lockedUids.remove(dev);
+
+    for (auto it = wsClients.begin();it != wsClients.end();it++)
+    {
+        it.value()->removeDevice(dev, getDefaultDevice());
+    }
+    for (auto it = ipcClients.begin();it != ipcClients.end();it++)
+    {
+        it.value()->removeDevice(dev, getDefaultDevice());
     }
 }
 
 bool WSServer::checkClientExists(WSServerCon *wscon)
 {
-    if (!wsClientsReverse.contains(wscon))
+    if (!wsClientsReverse.contains(wscon) &&
+        !ipcClientsReverse.contains(wscon))
         return false;
     return true;
 }
@@ -164,15 +285,16 @@ bool WSServer::checkClientExists(QWebSocket *ws)
     return true;
 }
 
-bool WSServer::isMemModeLocked(QString uid)
+bool WSServer::isMemModeLocked(MPDevice *dev, QString uid)
 {
+    if (!dev)
+        return false;
+
     //if the current client that has locked
     //the mem mode query for locked state, return false
-    if (uid == lockedUid)
+    if (uid == lockedUids.value(dev))
         return false;
 
     //if mem mode is enabled, it is locked
-    if (device && device->get_memMgmtMode())
-        return true;
-    return false;
+    return dev->get_memMgmtMode();
 }
@@ -22,10 +22,12 @@
 #include <QtCore>
 #include <QWebSocket>
 #include <QWebSocketServer>
+#include <QLocalServer>
 #include <QJsonDocument>
 #include "Common.h"
 #include "MPManager.h"
 #include "WSServerCon.h"
+#include "IpcSocket.h"
 
 class WSServer: public QObject
 {
@@ -44,12 +46,26 @@ public:
     bool checkClientExists(WSServerCon *wscon);
     bool checkClientExists(QWebSocket *ws);
 
-    void setMemLockedClient(QString uid) { lockedUid = uid; }
-    bool isMemModeLocked(QString uid = QString());
+    //MMM locks are per device, other devices stay usable
+    void setMemLockedClient(MPDevice *dev, QString uid) { lockedUids[dev] = uid; }
+    bool isMemModeLocked(MPDevice *dev, QString uid = QString());
+
+    //Device used by requests without a device_id
+    MPDevice *getDefaultDevice() const { return devices.isEmpty()? nullptr : devices.last(); }
+    const QList<MPDevice *> &getDevices() const { return devices; }
+
+    int getClientCount() const { return wsClients.size() + ipcClients.size(); }
+
+signals:
+    //A client connected or disconnected
+    void clientsChanged();
 
 private slots:
     void onNewConnection();
     void socketDisconnected();
+    void onNewIpcConnection();
+    void ipcHelloReceived(const QJsonObject &obj);
+    void ipcDisconnected();
     void notifyClients(const QJsonObject &obj);
     void notifyGUI(const QString& message, bool &isGuiRunning);
 
@@ -58,16 +74,23 @@ private slots:
 
 private:
     WSServer();
+    void addClient(WSServerCon *c);
+    void removeClient(WSServerCon *c);
+
     QWebSocketServer *wsServer = nullptr;
     QHash<QWebSocket *, WSServerCon *> wsClients;
     QHash<WSServerCon *, QWebSocket *> wsClientsReverse; //reverse map for fast lookup
 
-    QString lockedUid;
+    //Local socket server for the GUI, same API with binary framing
+    QLocalServer *ipcServer = nullptr;
+    QHash<IpcSocket *, WSServerCon *> ipcClients;
+    QHash<WSServerCon *, IpcSocket *> ipcClientsReverse;
+
+    QHash<MPDevice *, QString> lockedUids;
 
-    //Current MP
-    //For now only one MP is supported. maybe add multi support
-    // one day (but it's not really useful anyway)
-    MPDevice *device = nullptr;
+    //Connected MPs, in connection order. The last connected one
+    //is the default device for clients that don't send a device_id
+    QList<MPDevice *> devices;
 };
 
 #endif // WSSERVER_H
@@ -22,6 +22,8 @@
 #include "ParseDomain.h"
 #include "MPDeviceBleImpl.h"
 #include "HaveIBeenPwned.h"
+#include "IpcSocket.h"
+#include "WsCompression.h"
 
 #include <QCryptographicHash>
 
@@ -32,23 +34,83 @@ WSServerCon::WSServerCon(QWebSocket *conn):
 {
     connect(wsClient, &QWebSocket::textMessageReceived, this, &WSServerCon::processMessage);
     connect(hibp, &HaveIBeenPwned::sendPwnedMessage, this, &WSServerCon::sendHibpNotification);
+
+    //Compression is asked in the url, the same way permessage-deflate
+    //would be negotiated during the handshake
+    QUrlQuery query(wsClient->requestUrl());
+    if (query.queryItemValue(WsCompression::queryItem()) == WsCompression::algorithm())
+    {
+        QSettings s;
+        compressionThreshold = s.value("settings/ws_compression_threshold", WsCompression::DEFAULT_THRESHOLD).toInt();
+        compressionLevel = s.value("settings/ws_compression_level", WsCompression::DEFAULT_LEVEL).toInt();
+        if (compressionLevel == 0)
+            compressionThreshold = 0;
+    }
+}
+
+WSServerCon::WSServerCon(IpcSocket *conn):
+    ipcClient(conn),
+    clientUid(Common::createUid(QStringLiteral("ipc-"))),
+    hibp(new HaveIBeenPwned(this))
+{
+    connect(ipcClient, &IpcSocket::jsonReceived, this, &WSServerCon::processIpcMessage);
+    connect(hibp, &HaveIBeenPwned::sendPwnedMessage, this, &WSServerCon::sendHibpNotification);
 }
 
 WSServerCon::~WSServerCon()
 {
     delete wsClient;
+    delete ipcClient;
+}
+
+void WSServerCon::stopFetchData()
+{
+    if (!fetchDataDevice || !devices.contains(fetchDataDevice))
+        return;
+
+    qWarning() << "Stopping fetch data because its client exits";
+    if (fetchDataDevice->ble())
+        fetchDataDevice->ble()->stopFetchData();
+    fetchDataDevice = nullptr;
 }
 
 void WSServerCon::sendJsonMessage(const QJsonObject &data)
 {
+    if (ipcClient)
+    {
+        ipcClient->sendJson(data);
+        return;
+    }
+
     QJsonDocument jdoc(data);
-    wsClient->sendTextMessage(jdoc.toJson(QJsonDocument::JsonFormat::Compact));
+    QByteArray message = jdoc.toJson(QJsonDocument::JsonFormat::Compact);
+    if (compressionThreshold > 0 && message.size() >= compressionThreshold)
+        sendCompressedMessage(message);
+    else
+        wsClient->sendTextMessage(message);
     // wsClient->flush();
 }
 
+void WSServerCon::sendCompressedMessage(const QByteArray &message)
+{
+    QByteArray frame = WsCompression::compress(message, compressionLevel);
+    qCDebug(lcWsMessage) << "Sending compressed message:" << message.size() << "->" << frame.size() << "bytes";
+    wsClient->sendBinaryMessage(frame);
+}
+
 void WSServerCon::sendJsonMessageString(const QString &data)
 {
-    wsClient->sendTextMessage(data);
+    if (ipcClient)
+    {
+        ipcClient->sendJson(QJsonDocument::fromJson(data.toUtf8()).object());
+        return;
+    }
+
+    //UTF-8 is never shorter than the string length
+    if (compressionThreshold > 0 && data.size() >= compressionThreshold)
+        sendCompressedMessage(data.toUtf8());
+    else
+        wsClient->sendTextMessage(data);
 }
 
 void WSServerCon::processMessage(const QString &message)
@@ -65,8 +127,23 @@ void WSServerCon::processMessage(const QString &message)
         return;
     }
 
-    QJsonObject root = jdoc.object();
+    processJsonMessage(jdoc.object());
+}
 
+void WSServerCon::processIpcMessage(const QJsonObject &root)
+{
+    //Messages are not text anymore, only build one when it is logged
+    if (root["msg"] != "ping" && QLoggingCategory::defaultCategory()->isDebugEnabled())
+    {
+        QString message = QJsonDocument(root).toJson(QJsonDocument::Compact);
+        qDebug().noquote() << "IPC API recv:" << Common::maskLog(message);
+    }
+
+    processJsonMessage(root);
+}
+
+void WSServerCon::processJsonMessage(QJsonObject root)
+{
     /* API that does not require device */
     if (root["msg"] == "show_app")
     {
@@ -85,6 +162,15 @@ void WSServerCon::processMessage(const QString &message)
         sendJsonMessage(oroot);
         return;
     }
+    else if (root["msg"] == "get_startup_timing")
+    {
+        QJsonObject ores;
+        QJsonObject oroot = root;
+        ores["phases"] = Common::getStartupPhases();
+        oroot["data"] = ores;
+        sendJsonMessage(oroot);
+        return;
+    }
     else if (root["msg"] == "show_status_notification_warning")
     {
         QJsonDocument showWarningDoc(root);
@@ -96,6 +182,29 @@ void WSServerCon::processMessage(const QString &message)
         }
         return;
     }
+    else if (root["msg"] == "get_device_list")
+    {
+        //Clients asking for the device list handle device ids,
+        //send them events from all devices from now on
+        multiDevice = true;
+        sendDeviceList(root);
+        return;
+    }
+
+    //Route the request to the requested device, or the default one.
+    //The device_id is kept in root so every answer carries it
+    MPDevice *device = mpdevice;
+    if (root.contains("device_id"))
+    {
+        device = MPManager::Instance()->getDeviceById(root["device_id"].toString());
+        if (!device || !devices.contains(device))
+        {
+            sendFailedJson(root, "Unknown device");
+            return;
+        }
+    }
+    else if (device)
+        root["device_id"] = MPManager::Instance()->getDeviceId(device);
 
     //Strip the data for the progress lambda,
     //uneeded data should not be passed around
@@ -137,22 +246,22 @@ void WSServerCon::processMessage(const QString &message)
         sendJsonMessage(oroot);
     };
 
-    if (!mpdevice)
+    if (!device)
     {
         sendFailedJson(root, "No device connected");
         return;
     }
 
-    if (checkMemModeEnabled(root))
+    if (checkMemModeEnabled(root, device))
         return;
 
-    if (mpdevice->isBLE())
+    if (device->isBLE())
     {
-        processMessageBLE(root, defaultProgressCb);
+        processMessageBLE(root, device, defaultProgressCb);
     }
     else
     {
-        processMessageMini(root, defaultProgressCb);
+        processMessageMini(root, device, defaultProgressCb);
     }
 }
 
@@ -168,63 +277,107 @@ void WSServerCon::sendFailedJson(QJsonObject obj, QString errstr, int errCode)
     sendJsonMessage(obj);
 }
 
-void WSServerCon::resetDevice(MPDevice *dev)
+void WSServerCon::addDevice(MPDevice *dev, bool makeDefault, bool notify)
 {
-    mpdevice = dev;
+    if (devices.contains(dev))
+        return;
+    devices.append(dev);
 
-    if (!mpdevice)
-    {
-        sendJsonMessage({{ "msg", "mp_disconnected" }});
+    //Whenever mp status changes, send state update to client
+    connect(dev, &MPDevice::statusChanged, this, [this, dev]() { statusChanged(dev); });
+
+    connect(dev, &MPDevice::keyboardLayoutChanged, this, [this, dev]() { sendKeyboardLayout(dev); });
+    connect(dev, &MPDevice::lockTimeoutEnabledChanged, this, [this, dev]() { sendLockTimeoutEnabled(dev); });
+    connect(dev, &MPDevice::lockTimeoutChanged, this, [this, dev]() { sendLockTimeout(dev); });
+    connect(dev, &MPDevice::screensaverChanged, this, [this, dev]() { sendScreensaver(dev); });
+    connect(dev, &MPDevice::userRequestCancelChanged, this, [this, dev]() { sendUserRequestCancel(dev); });
+    connect(dev, &MPDevice::userInteractionTimeoutChanged, this, [this, dev]() { sendUserInteractionTimeout(dev); });
+    connect(dev, &MPDevice::flashScreenChanged, this, [this, dev]() { sendFlashScreen(dev); });
+    connect(dev, &MPDevice::offlineModeChanged, this, [this, dev]() { sendOfflineMode(dev); });
+    connect(dev, &MPDevice::tutorialEnabledChanged, this, [this, dev]() { sendTutorialEnabled(dev); });
+    connect(dev, &MPDevice::memMgmtModeChanged, this, [this, dev]() { sendMemMgmtMode(dev); });
+    connect(dev, &MPDevice::flashMbSizeChanged, this, [this, dev]() { sendVersion(dev); });
+    connect(dev, &MPDevice::hwVersionChanged, this, [this, dev]() { sendVersion(dev); });
+    connect(dev, &MPDevice::serialNumberChanged, this, [this, dev]() { sendVersion(dev); });
+    connect(dev, &MPDevice::screenBrightnessChanged, this, [this, dev]() { sendScreenBrightness(dev); });
+    connect(dev, &MPDevice::knockEnabledChanged, this, [this, dev]() { sendKnockEnabled(dev); });
+    connect(dev, &MPDevice::knockSensitivityChanged, this, [this, dev]() { sendKnockSensitivity(dev); });
+    connect(dev, &MPDevice::randomStartingPinChanged, this, [this, dev]() { sendRandomStartingPin(dev); });
+    connect(dev, &MPDevice::hashDisplayChanged, this, [this, dev]() { sendHashDisplayEnabled(dev); });
+    connect(dev, &MPDevice::lockUnlockModeChanged, this, [this, dev]() { sendLockUnlockMode(dev); });
+
+    connect(dev, &MPDevice::keyAfterLoginSendEnableChanged, this, [this, dev]() { sendKeyAfterLoginSendEnable(dev); });
+    connect(dev, &MPDevice::keyAfterLoginSendChanged, this, [this, dev]() { sendKeyAfterLoginSend(dev); });
+    connect(dev, &MPDevice::keyAfterPassSendEnableChanged, this, [this, dev]() { sendKeyAfterPassSendEnable(dev); });
+    connect(dev, &MPDevice::keyAfterPassSendChanged, this, [this, dev]() { sendKeyAfterPassSend(dev); });
+    connect(dev, &MPDevice::delayAfterKeyEntryEnableChanged, this, [this, dev]() { sendDelayAfterKeyEntryEnable(dev); });
+    connect(dev, &MPDevice::delayAfterKeyEntryChanged, this, [this, dev]() { sendDelayAfterKeyEntry(dev); });
+
+    connect(dev, &MPDevice::uidChanged, this, [this, dev]() { sendDeviceUID(dev); });
+
+    connect(dev, &MPDevice::filesCacheChanged, this, [this, dev]() { sendFilesCache(dev); });
+
+    connect(dev, &MPDevice::dbChangeNumbersChanged, this, [this, dev]() { sendCardDbMetadata(dev); });
+    connect(dev, &MPDevice::statusPollPolicyChanged, this, [this, dev]() { sendStatusPollPolicy(dev); });
+
+    if (makeDefault)
+        mpdevice = dev;
+
+    if (notify)
+        sendDeviceJsonMessage(dev, {{ "msg", "mp_connected" }});
+}
+
+void WSServerCon::removeDevice(MPDevice *dev, MPDevice *newDefault)
+{
+    if (!devices.removeOne(dev))
         return;
-    }
 
-    sendJsonMessage({{ "msg", "mp_connected" }});
+    disconnect(dev, nullptr, this, nullptr);
 
-    //Whenever mp status changes, send state update to client
-    connect(mpdevice, &MPDevice::statusChanged, this, &WSServerCon::statusChanged);
-
-    connect(mpdevice, SIGNAL(keyboardLayoutChanged(int)), this, SLOT(sendKeyboardLayout()));
-    connect(mpdevice, SIGNAL(lockTimeoutEnabledChanged(bool)), this, SLOT(sendLockTimeoutEnabled()));
-    connect(mpdevice, SIGNAL(lockTimeoutChanged(int)), this, SLOT(sendLockTimeout()));
-    connect(mpdevice, SIGNAL(screensaverChanged(bool)), this, SLOT(sendScreensaver()));
-    connect(mpdevice, SIGNAL(userRequestCancelChanged(bool)), this, SLOT(sendUserRequestCancel()));
-    connect(mpdevice, SIGNAL(userInteractionTimeoutChanged(int)), this, SLOT(sendUserInteractionTimeout()));
-    connect(mpdevice, SIGNAL(flashScreenChanged(bool)), this, SLOT(sendFlashScreen()));
-    connect(mpdevice, SIGNAL(offlineModeChanged(bool)), this, SLOT(sendOfflineMode()));
-    connect(mpdevice, SIGNAL(tutorialEnabledChanged(bool)), this, SLOT(sendTutorialEnabled()));
-    connect(mpdevice, SIGNAL(memMgmtModeChanged(bool)), this, SLOT(sendMemMgmtMode()));
-    connect(mpdevice, SIGNAL(flashMbSizeChanged(int)), this, SLOT(sendVersion()));
-    connect(mpdevice, SIGNAL(hwVersionChanged(QString)), this, SLOT(sendVersion()));
-    connect(mpdevice, SIGNAL(serialNumberChanged(quint32)), this, SLOT(sendVersion()));
-    connect(mpdevice, SIGNAL(screenBrightnessChanged(int)), this, SLOT(sendScreenBrightness()));
-    connect(mpdevice, SIGNAL(knockEnabledChanged(bool)), this, SLOT(sendKnockEnabled()));
-    connect(mpdevice, SIGNAL(knockSensitivityChanged(int)), this, SLOT(sendKnockSensitivity()));
-    connect(mpdevice, SIGNAL(randomStartingPinChanged(bool)), this, SLOT(sendRandomStartingPin()));
-    connect(mpdevice, SIGNAL(hashDisplayChanged(bool)), this, SLOT(sendHashDisplayEnabled()));
-    connect(mpdevice, SIGNAL(lockUnlockModeChanged(int)), this, SLOT(sendLockUnlockMode()));
-
-    connect(mpdevice, SIGNAL(keyAfterLoginSendEnableChanged(bool)), this, SLOT(sendKeyAfterLoginSendEnable()));
-    connect(mpdevice, SIGNAL(keyAfterLoginSendChanged(int)), this, SLOT(sendKeyAfterLoginSend()));
-    connect(mpdevice, SIGNAL(keyAfterPassSendEnableChanged(bool)), this, SLOT(sendKeyAfterPassSendEnable()));
-    connect(mpdevice, SIGNAL(keyAfterPassSendChanged(int)), this, SLOT(sendKeyAfterPassSend()));
-    connect(mpdevice, SIGNAL(delayAfterKeyEntryEnableChanged(bool)), this, SLOT(sendDelayAfterKeyEntryEnable()));
-    connect(mpdevice, SIGNAL(delayAfterKeyEntryChanged(int)), this, SLOT(sendDelayAfterKeyEntry()));
-
-    connect(mpdevice, SIGNAL(uidChanged(qint64)), this, SLOT(sendDeviceUID()));
-
-    connect(mpdevice, &MPDevice::filesCacheChanged, this, &WSServerCon::sendFilesCache);
-
-    connect(mpdevice, &MPDevice::dbChangeNumbersChanged, this, &WSServerCon::sendCardDbMetadata);
+    if (fetchDataDevice == dev)
+        fetchDataDevice = nullptr;
 
+    if (multiDevice || !newDefault)
+    {
+        QJsonObject oroot = {{ "msg", "mp_disconnected" }};
+        oroot["device_id"] = MPManager::Instance()->getDeviceId(dev);
+        sendJsonMessage(oroot);
+    }
+
+    if (mpdevice == dev)
+    {
+        mpdevice = newDefault;
+
+        //Single device clients switch to the remaining device
+        if (mpdevice && !multiDevice)
+            sendInitialStatus();
+    }
 }
 
-void WSServerCon::statusChanged()
+void WSServerCon::sendDeviceJsonMessage(MPDevice *dev, QJsonObject obj)
 {
-    qDebug() << "Update client status changed: " << this;
-    if (!mpdevice)
+    //Clients that don't handle device ids only get events from the default device
+    if (dev != mpdevice && !multiDevice)
         return;
-    sendJsonMessage({{ "msg", "status_changed" },
-                     { "data", Common::MPStatusString[mpdevice->get_status()] }});
+
+    obj["device_id"] = MPManager::Instance()->getDeviceId(dev);
+    sendJsonMessage(obj);
+}
+
+void WSServerCon::sendDeviceList(const QJsonObject &root)
+{
+    QJsonArray list;
+    for (MPDevice *dev: qAsConst(devices))
+    {
+        list.append(QJsonObject{{ "device_id", MPManager::Instance()->getDeviceId(dev) },
+                                { "ble", dev->isBLE() },
+                                { "status", Common::MPStatusString[dev->get_status()] },
+                                { "default", dev == mpdevice }});
+    }
+
+    QJsonObject oroot = root;
+    oroot["data"] = list;
+    sendJsonMessage(oroot);
 }
 
 void WSServerCon::sendInitialStatus()
@@ -233,244 +386,277 @@ void WSServerCon::sendInitialStatus()
     //is any mp connected? and if true send mp state too
 
     if (!mpdevice)
+    {
         sendJsonMessage({{ "msg", "mp_disconnected" }});
-    else
+        return;
+    }
+
+    //Multi device clients get the state of every device
+    for (MPDevice *dev: qAsConst(devices))
     {
-        sendJsonMessage({{ "msg", "mp_connected" }});
-        sendJsonMessage({{ "msg", "status_changed" },
-                         { "data", Common::MPStatusString[mpdevice->get_status()] }});
-        sendKeyboardLayout();
-        sendLockTimeoutEnabled();
-        sendLockTimeout();
-        sendScreensaver();
-        sendUserRequestCancel();
-        sendUserInteractionTimeout();
-        sendFlashScreen();
-        sendOfflineMode();
-        sendTutorialEnabled();
-        sendMemMgmtMode();
-        sendVersion();
-        sendScreenBrightness();
-        sendKnockEnabled();
-        sendKnockSensitivity();
-        sendRandomStartingPin();
-        sendHashDisplayEnabled();
-        sendLockUnlockMode();
-        sendKeyAfterLoginSendEnable();
-        sendKeyAfterLoginSend();
-        sendKeyAfterPassSendEnable();
-        sendKeyAfterPassSend();
-        sendDelayAfterKeyEntryEnable();
-        sendDelayAfterKeyEntry();
-        sendCardDbMetadata();
+        if (dev != mpdevice && !multiDevice)
+            continue;
+
+        sendDeviceJsonMessage(dev, {{ "msg", "mp_connected" }});
+        statusChanged(dev);
+        sendKeyboardLayout(dev);
+        sendLockTimeoutEnabled(dev);
+        sendLockTimeout(dev);
+        sendScreensaver(dev);
+        sendUserRequestCancel(dev);
+        sendUserInteractionTimeout(dev);
+        sendFlashScreen(dev);
+        sendOfflineMode(dev);
+        sendTutorialEnabled(dev);
+        sendMemMgmtMode(dev);
+        sendVersion(dev);
+        sendScreenBrightness(dev);
+        sendKnockEnabled(dev);
+        sendKnockSensitivity(dev);
+        sendRandomStartingPin(dev);
+        sendHashDisplayEnabled(dev);
+        sendLockUnlockMode(dev);
+        sendKeyAfterLoginSendEnable(dev);
+        sendKeyAfterLoginSend(dev);
+        sendKeyAfterPassSendEnable(dev);
+        sendKeyAfterPassSend(dev);
+        sendDelayAfterKeyEntryEnable(dev);
+        sendDelayAfterKeyEntry(dev);
+        sendCardDbMetadata(dev);
+        sendStatusPollPolicy(dev);
     }
 }
 
-void WSServerCon::sendKeyboardLayout()
+void WSServerCon::statusChanged(MPDevice *dev)
 {
-    if (!mpdevice)
+    qDebug() << "Update client status changed: " << this;
+    if (!dev)
+        return;
+    sendDeviceJsonMessage(dev, {{ "msg", "status_changed" },
+                                { "data", Common::MPStatusString[dev->get_status()] }});
+}
+
+void WSServerCon::sendKeyboardLayout(MPDevice *dev)
+{
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "keyboard_layout" },
-                        { "value", mpdevice->get_keyboardLayout() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_keyboardLayout() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendLockTimeoutEnabled()
+void WSServerCon::sendLockTimeoutEnabled(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "lock_timeout_enabled" },
-                        { "value", mpdevice->get_lockTimeoutEnabled() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_lockTimeoutEnabled() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendLockTimeout()
+void WSServerCon::sendLockTimeout(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "lock_timeout" },
-                        { "value", mpdevice->get_lockTimeout() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_lockTimeout() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendScreensaver()
+void WSServerCon::sendScreensaver(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "screensaver" },
-                        { "value", mpdevice->get_screensaver() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_screensaver() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendUserRequestCancel()
+void WSServerCon::sendUserRequestCancel(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "user_request_cancel" },
-                        { "value", mpdevice->get_userRequestCancel() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_userRequestCancel() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendUserInteractionTimeout()
+void WSServerCon::sendUserInteractionTimeout(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "user_interaction_timeout" },
-                        { "value", mpdevice->get_userInteractionTimeout() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_userInteractionTimeout() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendFlashScreen()
+void WSServerCon::sendFlashScreen(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "flash_screen" },
-                        { "value", mpdevice->get_flashScreen() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_flashScreen() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendOfflineMode()
+void WSServerCon::sendOfflineMode(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "offline_mode" },
-                        { "value", mpdevice->get_offlineMode() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_offlineMode() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendTutorialEnabled()
+void WSServerCon::sendTutorialEnabled(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "tutorial_enabled" },
-                        { "value", mpdevice->get_tutorialEnabled() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_tutorialEnabled() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendScreenBrightness()
+void WSServerCon::sendScreenBrightness(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "screen_brightness" },
-                        { "value", mpdevice->get_screenBrightness() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_screenBrightness() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendKnockEnabled()
+void WSServerCon::sendKnockEnabled(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "knock_enabled" },
-                        { "value", mpdevice->get_knockEnabled() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_knockEnabled() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendKnockSensitivity()
+void WSServerCon::sendKnockSensitivity(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "knock_sensitivity" },
-                        { "value", mpdevice->get_knockSensitivity() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_knockSensitivity() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
 
-void WSServerCon::sendRandomStartingPin()
+void WSServerCon::sendRandomStartingPin(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "random_starting_pin" },
-                        { "value", mpdevice->get_randomStartingPin() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_randomStartingPin() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendHashDisplayEnabled()
+void WSServerCon::sendHashDisplayEnabled(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "hash_display" },
-                        { "value", mpdevice->get_hashDisplay() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_hashDisplay() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendLockUnlockMode()
+void WSServerCon::sendLockUnlockMode(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "lock_unlock_mode" },
-                        { "value", mpdevice->get_lockUnlockMode() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_lockUnlockMode() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendKeyAfterLoginSendEnable()
+void WSServerCon::sendKeyAfterLoginSendEnable(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "key_after_login_enabled" },
-                        { "value", mpdevice->get_keyAfterLoginSendEnable() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_keyAfterLoginSendEnable() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendKeyAfterLoginSend()
+void WSServerCon::sendKeyAfterLoginSend(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "key_after_login" },
-                        { "value", mpdevice->get_keyAfterLoginSend() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_keyAfterLoginSend() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendKeyAfterPassSendEnable()
+void WSServerCon::sendKeyAfterPassSendEnable(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "key_after_pass_enabled" },
-                        { "value", mpdevice->get_keyAfterPassSendEnable() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_keyAfterPassSendEnable() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendKeyAfterPassSend()
+void WSServerCon::sendKeyAfterPassSend(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "key_after_pass" },
-                        { "value", mpdevice->get_keyAfterPassSend() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_keyAfterPassSend() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendDelayAfterKeyEntryEnable()
+void WSServerCon::sendDelayAfterKeyEntryEnable(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "delay_after_key_enabled" },
-                        { "value", mpdevice->get_delayAfterKeyEntryEnable() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_delayAfterKeyEntryEnable() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendDelayAfterKeyEntry()
+void WSServerCon::sendDelayAfterKeyEntry(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
     QJsonObject data = {{ "parameter", "delay_after_key" },
-                        { "value", mpdevice->get_delayAfterKeyEntry() }};
-    sendJsonMessage({{ "msg", "param_changed" }, { "data", data }});
+                        { "value", dev->get_delayAfterKeyEntry() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendMemMgmtMode()
+void WSServerCon::sendStatusPollPolicy(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
-    sendJsonMessage({{ "msg", "memorymgmt_changed" },
-                     { "data", mpdevice->get_memMgmtMode() }});
+    //Daemon side setting, reported like the device params
+    QJsonObject data = {{ "parameter", "status_poll_adaptive" },
+                        { "value", dev->isStatusPollAdaptive() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
+    data = {{ "parameter", "status_poll_min_ms" },
+            { "value", dev->getStatusPollMinMs() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
+    data = {{ "parameter", "status_poll_max_ms" },
+            { "value", dev->getStatusPollMaxMs() }};
+    sendDeviceJsonMessage(dev, {{ "msg", "param_changed" }, { "data", data }});
+}
+
+void WSServerCon::sendMemMgmtMode(MPDevice *dev)
+{
+    if (!dev)
+        return;
+    sendDeviceJsonMessage(dev, {{ "msg", "memorymgmt_changed" },
+                     { "data", dev->get_memMgmtMode() }});
 
     QJsonArray logins;
-    foreach (MPNode *n, mpdevice->getLoginNodes())
+    foreach (MPNode *n, dev->getLoginNodes())
     {
         logins.append(n->toJson());
     }
 
     QJsonArray datas;
-    foreach (MPNode *n, mpdevice->getDataNodes())
+    foreach (MPNode *n, dev->getDataNodes())
     {
         datas.append(n->toJson());
     }
@@ -479,47 +665,47 @@ void WSServerCon::sendMemMgmtMode()
     jdata["login_nodes"] = logins;
     jdata["data_nodes"] = datas;
 
-    sendJsonMessage({{ "msg", "memorymgmt_data" },
+    sendDeviceJsonMessage(dev, {{ "msg", "memorymgmt_data" },
                      { "data", jdata }});
 }
 
-void WSServerCon::sendVersion()
+void WSServerCon::sendVersion(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
-    QJsonObject data = {{ "hw_version", mpdevice->get_hwVersion() },
-                        { "flash_size", mpdevice->get_flashMbSize() }};
-    data["hw_serial"] = static_cast<qint64>(mpdevice->get_serialNumber());
-    if (mpdevice->isBLE())
+    QJsonObject data = {{ "hw_version", dev->get_hwVersion() },
+                        { "flash_size", dev->get_flashMbSize() }};
+    data["hw_serial"] = static_cast<qint64>(dev->get_serialNumber());
+    if (dev->isBLE())
     {
         data["hw_version"] = "ble";
-        if (auto bleImpl = mpdevice->ble())
+        if (auto bleImpl = dev->ble())
         {
             data["aux_mcu_version"] = bleImpl->get_auxMCUVersion();
             data["main_mcu_version"] = bleImpl->get_mainMCUVersion();
         }
     }
-    sendJsonMessage({{ "msg", "version_changed" }, { "data", data }});
+    sendDeviceJsonMessage(dev, {{ "msg", "version_changed" }, { "data", data }});
 }
 
-void WSServerCon::sendDeviceUID()
+void WSServerCon::sendDeviceUID(MPDevice *dev)
 {
-    if (!mpdevice)
+    if (!dev)
         return;
-    sendJsonMessage({{ "msg", "device_uid" },
-                     { "data", QJsonObject{ {"uid", mpdevice->get_uid()} } }
+    sendDeviceJsonMessage(dev, {{ "msg", "device_uid" },
+                     { "data", QJsonObject{ {"uid", dev->get_uid()} } }
                     });
 }
 
-void WSServerCon::sendFilesCache()
+void WSServerCon::sendFilesCache(MPDevice *dev)
 {
-    if (!mpdevice->hasFilesCache())
+    if (!dev->hasFilesCache())
     {
         qDebug() << "There is fo files cache to send";
         return;
     }
 
-    auto deviceStatus = mpdevice->get_status();
+    auto deviceStatus = dev->get_status();
     if (deviceStatus != Common::Unlocked)
     {
         qDebug() << "It's an unknown smartcard or it's locked, no need to search for files cache";
@@ -529,20 +715,20 @@ void WSServerCon::sendFilesCache()
     qDebug() << "Sending files cache";
     QJsonObject oroot = { {"msg", "files_cache_list"} };
     QJsonArray array;
-    for (QVariantMap item : mpdevice->getFilesCache())
+    for (QVariantMap item : dev->getFilesCache())
         array.append(QJsonDocument::fromVariant(item).object());
 
     oroot["data"] = array;
-    oroot["sync"] = mpdevice->isFilesCacheInSync();
-    sendJsonMessage(oroot);
+    oroot["sync"] = dev->isFilesCacheInSync();
+    sendDeviceJsonMessage(dev, oroot);
 }
 
-void WSServerCon::sendCardDbMetadata()
+void WSServerCon::sendCardDbMetadata(MPDevice *dev)
 {
     qDebug() << "Send card db metadata";
-    QByteArray cpz = mpdevice->get_cardCPZ();
-    int credentialsCn = mpdevice->get_credentialsDbChangeNumber();
-    int dataCn = mpdevice->get_dataDbChangeNumber();
+    QByteArray cpz = dev->get_cardCPZ();
+    int credentialsCn = dev->get_credentialsDbChangeNumber();
+    int dataCn = dev->get_dataDbChangeNumber();
     if (cpz.isEmpty())
     {
         qDebug() << "There is no card data to be send.";
@@ -562,7 +748,7 @@ void WSServerCon::sendCardDbMetadata()
         data.insert("dataDbChangeNumber", dataCn);
         oroot["data"] = data;
 
-        sendJsonMessage(oroot);
+        sendDeviceJsonMessage(dev, oroot);
         qDebug() << "Sended card db metadata";
     }
 }
@@ -583,56 +769,78 @@ void WSServerCon::sendHibpNotification(QString message)
     }
 }
 
-void WSServerCon::processParametersSet(const QJsonObject &data)
+//Websocket API names of the device parameters
+static const struct
 {
-    if (!mpdevice)
+    const char *key;
+    const char *property;
+} PARAM_KEYS[] = {
+    { "keyboard_layout", "keyboardLayout" },
+    { "lock_timeout_enabled", "lockTimeoutEnabled" },
+    { "lock_timeout", "lockTimeout" },
+    { "screensaver", "screensaver" },
+    { "user_request_cancel", "userRequestCancel" },
+    { "user_interaction_timeout", "userInteractionTimeout" },
+    { "flash_screen", "flashScreen" },
+    { "offline_mode", "offlineMode" },
+    { "tutorial_enabled", "tutorialEnabled" },
+    { "screen_brightness", "screenBrightness" },
+    { "knock_enabled", "knockEnabled" },
+    { "knock_sensitivity", "knockSensitivity" },
+    { "random_starting_pin", "randomStartingPin" },
+    { "hash_display", "hashDisplay" },
+    { "lock_unlock_mode", "lockUnlockMode" },
+    { "key_after_login_enabled", "keyAfterLoginSendEnable" },
+    { "key_after_login", "keyAfterLoginSend" },
+    { "key_after_pass_enabled", "keyAfterPassSendEnable" },
+    { "key_after_pass", "keyAfterPassSend" },
+    { "delay_after_key_enabled", "delayAfterKeyEntryEnable" },
+    { "delay_after_key", "delayAfterKeyEntry" },
+};
+
+void WSServerCon::processParametersSet(const QJsonObject &root, MPDevice *device)
+{
+    if (!device)
         return;
-    if (data.contains("keyboard_layout"))
-        mpdevice->updateKeyboardLayout(data["keyboard_layout"].toInt());
-    if (data.contains("lock_timeout_enabled"))
-        mpdevice->updateLockTimeoutEnabled(data["lock_timeout_enabled"].toBool());
-    if (data.contains("lock_timeout"))
-        mpdevice->updateLockTimeout(data["lock_timeout"].toInt());
-    if (data.contains("screensaver"))
-        mpdevice->updateScreensaver(data["screensaver"].toBool());
-    if (data.contains("user_request_cancel"))
-        mpdevice->updateUserRequestCancel(data["user_request_cancel"].toBool());
-    if (data.contains("user_interaction_timeout"))
-        mpdevice->updateUserInteractionTimeout(data["user_interaction_timeout"].toInt());
-    if (data.contains("flash_screen"))
-        mpdevice->updateFlashScreen(data["flash_screen"].toBool());
-    if (data.contains("offline_mode"))
-        mpdevice->updateOfflineMode(data["offline_mode"].toBool());
-    if (data.contains("tutorial_enabled"))
-        mpdevice->updateTutorialEnabled(data["tutorial_enabled"].toBool());
-    if (data.contains("screen_brightness"))
-        mpdevice->updateScreenBrightness(data["screen_brightness"].toInt());
-    if (data.contains("knock_enabled"))
-        mpdevice->updateKnockEnabled(data["knock_enabled"].toBool());
-    if (data.contains("knock_sensitivity"))
-        mpdevice->updateKnockSensitivity(data["knock_sensitivity"].toInt());
-    if (data.contains("random_starting_pin"))
-        mpdevice->updateRandomStartingPin(data["random_starting_pin"].toBool());
-    if (data.contains("hash_display"))
-        mpdevice->updateHashDisplay(data["hash_display"].toBool());
-    if (data.contains("lock_unlock_mode"))
-        mpdevice->updateLockUnlockMode(data["lock_unlock_mode"].toInt());
-    if (data.contains("key_after_login_enabled"))
-         mpdevice->updateKeyAfterLoginSendEnable(data["key_after_login_enabled"].toBool());
-    if (data.contains("key_after_login"))
-         mpdevice->updateKeyAfterLoginSend(data["key_after_login"].toInt());
-    if (data.contains("key_after_pass_enabled"))
-         mpdevice->updateKeyAfterPassSendEnable(data["key_after_pass_enabled"].toBool());
-    if (data.contains("key_after_pass"))
-         mpdevice->updateKeyAfterPassSend(data["key_after_pass"].toInt());
-    if (data.contains("delay_after_key_enabled"))
-         mpdevice->updateDelayAfterKeyEntryEnable( data["delay_after_key_enabled"].toBool());
-    if (data.contains("delay_after_key"))
-         mpdevice->updateDelayAfterKeyEntry(data["delay_after_key"].toInt());
-
-    //reload parameters from device after changed all params, this will trigger
-    //websocket update of clients too
-    mpdevice->loadParameters();
+
+    QJsonObject data = root["data"].toObject();
+    if (data.contains("status_poll_adaptive") ||
+        data.contains("status_poll_min_ms") ||
+        data.contains("status_poll_max_ms"))
+    {
+        device->setStatusPollPolicy(data.value("status_poll_adaptive").toBool(device->isStatusPollAdaptive()),
+                                      data.value("status_poll_min_ms").toInt(device->getStatusPollMinMs()),
+                                      data.value("status_poll_max_ms").toInt(device->getStatusPollMaxMs()));
+    }
+
+    //All params are written by one job queue, the device is not read back:
+    //only the params that changed are notified to clients
+    QVariantMap params;
+    for (const auto &k: PARAM_KEYS)
+    {
+        if (data.contains(k.key))
+            params[k.property] = data[k.key].toVariant();
+    }
+
+    device->updateParams(params, [this, root](bool success, QString errstr)
+    {
+        //param_set has no answer, set_params does
+        if (root["msg"] != "set_params" ||
+            !WSServer::Instance()->checkClientExists(this))
+            return;
+
+        if (!success)
+        {
+            sendFailedJson(root, errstr);
+            return;
+        }
+
+        QJsonObject ores;
+        QJsonObject oroot = root;
+        ores["success"] = "true";
+        oroot["data"] = ores;
+        sendJsonMessage(oroot);
+    });
 }
 
 QString WSServerCon::getRequestId(const QJsonValue &v)
@@ -642,20 +850,21 @@ QString WSServerCon::getRequestId(const QJsonValue &v)
     return v.toString();
 }
 
-void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb &cbProgress)
+void WSServerCon::processMessageMini(QJsonObject root, MPDevice *device, const MPDeviceProgressCb &cbProgress)
 {
-    if (root["msg"] == "param_set")
+    if (root["msg"] == "param_set" ||
+        root["msg"] == "set_params")
     {
-        processParametersSet(root["data"].toObject());
+        processParametersSet(root, device);
     }
     else if (root["msg"] == "start_memorymgmt")
     {
         QJsonObject o = root["data"].toObject();
 
-        WSServer::Instance()->setMemLockedClient(clientUid);
+        WSServer::Instance()->setMemLockedClient(device, clientUid);
 
         //send command to start MMM
-        mpdevice->startMemMgmtMode(o["want_data"].toBool(),
+        device->startMemMgmtMode(o["want_data"].toBool(),
                 cbProgress,
                 [=](bool success, int errCode, QString errMsg)
         {
@@ -673,12 +882,12 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
     else if (root["msg"] == "exit_memorymgmt")
     {
         //send command to exit MMM
-        mpdevice->exitMemMgmtMode();
+        device->exitMemMgmtMode();
     }
     else if (root["msg"] == "start_memcheck")
     {
         //start integrity check
-        mpdevice->startIntegrityCheck(
+        device->startIntegrityCheck(
                     [=](bool success, int freeBlocks, int totalBlocks, QString errstr)
         {
             if (!WSServer::Instance()->checkClientExists(this))
@@ -711,7 +920,7 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
         if (o.contains("request_id"))
             reqid = QStringLiteral("%1-%2").arg(clientUid).arg(getRequestId(o["request_id"]));
 
-        mpdevice->getCredential(o["service"].toString(), o["login"].toString(), o["fallback_service"].toString(),
+        device->getCredential(o["service"].toString(), o["login"].toString(), o["fallback_service"].toString(),
                 reqid,
                 [=](bool success, QString errstr, const QString &service, const QString &login, const QString &pass, const QString &desc)
         {
@@ -736,7 +945,7 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
             ores["service"] = service;
             ores["login"] = login;
             ores["password"] = pass;
-            if (mpdevice && mpdevice->isFw12()) //only add description for fw > 1.2
+            if (device && device->isFw12()) //only add description for fw > 1.2
                 ores["description"] = desc;
             oroot["data"] = ores;
             sendJsonMessage(oroot);
@@ -800,7 +1009,7 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
             hibp->isPasswordPwned(o["password"].toString(), formatString);
         }
 
-        mpdevice->setCredential(o["service"].toString(), o["login"].toString(),
+        device->setCredential(o["service"].toString(), o["login"].toString(),
                 o["password"].toString(), o["description"].toString(), o.contains("description"),
                 [=](bool success, QString errstr)
         {
@@ -822,7 +1031,7 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
     else if (root["msg"] == "del_credential")
     {
         QJsonObject o = root["data"].toObject();
-        mpdevice->delCredentialAndLeave(o["service"].toString(), o["login"].toString(),
+        device->delCredentialAndLeave(o["service"].toString(), o["login"].toString(),
                 cbProgress,
                 [=](bool success, QString errstr)
         {
@@ -844,12 +1053,12 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
     {
         QJsonObject o = root["data"].toObject();
         const QByteArray key = o.value("key").toString().toUtf8().simplified();
-        mpdevice->getUID(key);
+        device->getUID(key);
     }
 
     else if (root["msg"] == "get_random_numbers")
     {
-        mpdevice->getRandomNumber([=](bool success, QString errstr, const QByteArray &rndNums)
+        device->getRandomNumber([=](bool success, QString errstr, const QByteArray &rndNums)
         {
             if (!WSServer::Instance()->checkClientExists(this))
                 return;
@@ -875,7 +1084,7 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
         if (o.contains("request_id"))
             reqid = QStringLiteral("%1-%2").arg(clientUid).arg(getRequestId(o["request_id"]));
 
-        mpdevice->cancelUserRequest(reqid);
+        device->cancelUserRequest(reqid);
     }
     else if (root["msg"] == "get_data_node")
     {
@@ -884,7 +1093,7 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
         if (o.contains("request_id"))
             reqid = QStringLiteral("%1-%2").arg(clientUid).arg(getRequestId(o["request_id"]));
 
-        mpdevice->getDataNode(o["service"].toString(), o["fallback_service"].toString(),
+        device->getDataNode(o["service"].toString(), o["fallback_service"].toString(),
                 reqid,
                 [=](bool success, QString errstr, const QString &service, const QByteArray &dataNode)
         {
@@ -926,7 +1135,7 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
             return;
         }
 
-        mpdevice->setDataNode(service, data,
+        device->setDataNode(service, data,
                 [=](bool success, QString errstr)
         {
             if (!WSServer::Instance()->checkClientExists(this))
@@ -950,7 +1159,7 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
     {
         QJsonObject o = root["data"].toObject();
 
-        if (!mpdevice->get_memMgmtMode())
+        if (!device->get_memMgmtMode())
         {
             sendFailedJson(root, "Not in memory management mode");
             return;
@@ -961,7 +1170,7 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
         for (int i = 0;i < jarr.size();i++)
             services.append(jarr[i].toString());
 
-        mpdevice->deleteDataNodesAndLeave(services,
+        device->deleteDataNodesAndLeave(services,
                 [=](bool success, QString errstr)
         {
             if (!WSServer::Instance()->checkClientExists(this))
@@ -987,7 +1196,7 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
         if (o.contains("request_id"))
             reqid = QStringLiteral("%1-%2").arg(clientUid).arg(getRequestId(o["request_id"]));
 
-        mpdevice->serviceExists(false, o["service"].toString(),
+        device->serviceExists(false, o["service"].toString(),
                 reqid,
                 [=](bool success, QString errstr, const QString &service, bool exists)
         {
@@ -1016,7 +1225,7 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
         if (o.contains("request_id"))
             reqid = QStringLiteral("%1-%2").arg(clientUid).arg(getRequestId(o["request_id"]));
 
-        mpdevice->serviceExists(true, o["service"].toString(),
+        device->serviceExists(true, o["service"].toString(),
                 reqid,
                 [=](bool success, QString errstr, const QString &service, bool exists)
         {
@@ -1039,13 +1248,13 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
     }
     else if (root["msg"] == "set_credentials")
     {
-        if (!mpdevice->get_memMgmtMode())
+        if (!device->get_memMgmtMode())
         {
             sendFailedJson(root, "Not in memory management mode");
             return;
         }
 
-        mpdevice->setMMCredentials(
+        device->setMMCredentials(
                     root["data"].toArray(),
                     false,
                     cbProgress,
@@ -1076,7 +1285,7 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
             encryptionMethod = o.value("encryption").toString();
         }
 
-        mpdevice->exportDatabase(encryptionMethod,
+        device->exportDatabase(encryptionMethod,
                                  [=](bool success, QString errstr, QByteArray fileData)
         {
             qDebug() << "send exported DB on WS: success:" << success
@@ -1111,7 +1320,7 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
             return;
         }
 
-        mpdevice->importDatabase(data, o["no_delete"].toBool(),
+        device->importDatabase(data, o["no_delete"].toBool(),
                     [=](bool success, QString errstr)
         {
             if (!WSServer::Instance()->checkClientExists(this))
@@ -1133,7 +1342,7 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
     }
     else if (root["msg"] == "import_csv")
     {
-        mpdevice->importFromCSV(
+        device->importFromCSV(
                     root["data"].toArray(),
                     cbProgress,
                     [=](bool success, QString errstr)
@@ -1156,15 +1365,15 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
     }
     else if (root["msg"] == "refresh_files_cache")
     {
-        mpdevice->updateFilesCache();
+        device->updateFilesCache();
     }
     else if (root["msg"] == "list_files_cache")
     {
-        sendFilesCache();
+        sendFilesCache(device);
     }
     else if (root["msg"] == "reset_card")
     {
-        mpdevice->resetSmartCard([=](bool success, QString errstr)
+        device->resetSmartCard([=](bool success, QString errstr)
         {
             if (!WSServer::Instance()->checkClientExists(this))
                 return;
@@ -1185,7 +1394,7 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
     }
     else if (root["msg"] == "lock_device")
     {
-        mpdevice->lockDevice([this, root](bool success, QString errstr)
+        device->lockDevice([this, root](bool success, QString errstr)
         {
             if (!success)
             {
@@ -1202,10 +1411,10 @@ void WSServerCon::processMessageMini(QJsonObject root, const MPDeviceProgressCb
     }
 }
 
-void WSServerCon::processMessageBLE(QJsonObject root, const MPDeviceProgressCb &cbProgress)
+void WSServerCon::processMessageBLE(QJsonObject root, MPDevice *device, const MPDeviceProgressCb &cbProgress)
 {
     //Ble related commands
-    MPDeviceBleImpl *bleImpl = mpdevice->ble();
+    MPDeviceBleImpl *bleImpl = device->ble();
     if (nullptr == bleImpl)
     {
         return;
@@ -1268,11 +1477,34 @@ void WSServerCon::processMessageBLE(QJsonObject root, const MPDeviceProgressCb &
         auto type = static_cast<Common::FetchType>(o["type"].toInt());
         const auto cmd = Common::FetchType::ACCELEROMETER == type ?
                     MPCmd::CMD_DBG_GET_ACC_32_SAMPLES : MPCmd::GET_RANDOM_NUMBER;
-        bleImpl->fetchData(o["file"].toString(), cmd);
+        FetchDataSettings settings;
+        settings.flushIntervalMs = o.value("flush_interval_ms").toInt(settings.flushIntervalMs);
+        settings.maxDurationMs = static_cast<qint64>(o.value("max_duration_ms").toDouble(0));
+        settings.maxBytes = static_cast<qint64>(o.value("max_bytes").toDouble(0));
+        if (bleImpl->isFetchingData())
+        {
+            sendFailedJson(root, "Fetch data already running");
+            return;
+        }
+        fetchDataDevice = device;
+        bleImpl->fetchData(o["file"].toString(), cmd, settings, [this, root](const QVariantMap &stats)
+        {
+            if (!WSServer::Instance()->checkClientExists(this))
+                return;
+
+            if (stats.value("finished").toBool())
+                fetchDataDevice = nullptr;
+
+            QJsonObject oroot = root;
+            oroot["msg"] = "fetch_data_stats";
+            oroot["data"] = QJsonObject::fromVariantMap(stats);
+            sendJsonMessage(oroot);
+        });
     }
     else if (root["msg"] == "stop_fetch_data")
     {
         bleImpl->stopFetchData();
+        fetchDataDevice = nullptr;
     }
     else if (root["msg"] == "ask_password" ||
              root["msg"] == "get_credential")
@@ -1362,9 +1594,9 @@ void WSServerCon::processMessageBLE(QJsonObject root, const MPDeviceProgressCb &
     }
 }
 
-bool WSServerCon::checkMemModeEnabled(const QJsonObject &root)
+bool WSServerCon::checkMemModeEnabled(const QJsonObject &root, MPDevice *device)
 {
-    if (WSServer::Instance()->isMemModeLocked(clientUid))
+    if (WSServer::Instance()->isMemModeLocked(device, clientUid))
     {
         sendFailedJson(root, "Device is in memory management mode");
         return true;
@@ -25,6 +25,7 @@
 #include "MPManager.h"
 
 class WSServer;
+class IpcSocket;
 class HaveIBeenPwned;
 
 class WSServerCon: public QObject
@@ -32,12 +33,16 @@ class WSServerCon: public QObject
     Q_OBJECT
 public:
     WSServerCon(QWebSocket *conn);
+    WSServerCon(IpcSocket *conn);
     virtual ~WSServerCon();
 
     void sendJsonMessage(const QJsonObject &data);
     void sendJsonMessageString(const QString &data);
-    void resetDevice(MPDevice *dev);
+    void addDevice(MPDevice *dev, bool makeDefault, bool notify = true);
+    void removeDevice(MPDevice *dev, MPDevice *newDefault);
     void sendInitialStatus();
+    //Stops the fetch_data capture started by this client, if any
+    void stopFetchData();
 
     QString getClientUid() { return clientUid; }
 
@@ -47,45 +52,64 @@ signals:
 
 private slots:
     void processMessage(const QString &msg);
-
-    void statusChanged();
-
-    //parameters slots that sends json to websocket
-    void sendKeyboardLayout();
-    void sendLockTimeoutEnabled();
-    void sendLockTimeout();
-    void sendScreensaver();
-    void sendUserRequestCancel();
-    void sendUserInteractionTimeout();
-    void sendFlashScreen();
-    void sendOfflineMode();
-    void sendTutorialEnabled();
-    void sendMemMgmtMode();
-    void sendVersion();
-    void sendScreenBrightness();
-    void sendKnockEnabled();
-    void sendKnockSensitivity();
-    void sendRandomStartingPin();
-    void sendHashDisplayEnabled();
-    void sendLockUnlockMode();
-    void sendKeyAfterLoginSendEnable();
-    void sendKeyAfterLoginSend();
-    void sendKeyAfterPassSendEnable();
-    void sendKeyAfterPassSend();
-    void sendDelayAfterKeyEntryEnable();
-    void sendDelayAfterKeyEntry();
-    void sendDeviceUID();
-    void sendFilesCache();
-
-    void sendCardDbMetadata();
+    void processIpcMessage(const QJsonObject &root);
 
     void sendHibpNotification(QString message);
 private:
-    bool checkMemModeEnabled(const QJsonObject &root);
-
-    QWebSocket *wsClient;
-
+    void processJsonMessage(QJsonObject root);
+    bool checkMemModeEnabled(const QJsonObject &root, MPDevice *device);
+
+    void statusChanged(MPDevice *dev);
+
+    //parameters that sends json to websocket, tagged with the device id
+    void sendKeyboardLayout(MPDevice *dev);
+    void sendLockTimeoutEnabled(MPDevice *dev);
+    void sendLockTimeout(MPDevice *dev);
+    void sendScreensaver(MPDevice *dev);
+    void sendUserRequestCancel(MPDevice *dev);
+    void sendUserInteractionTimeout(MPDevice *dev);
+    void sendFlashScreen(MPDevice *dev);
+    void sendOfflineMode(MPDevice *dev);
+    void sendTutorialEnabled(MPDevice *dev);
+    void sendMemMgmtMode(MPDevice *dev);
+    void sendVersion(MPDevice *dev);
+    void sendScreenBrightness(MPDevice *dev);
+    void sendKnockEnabled(MPDevice *dev);
+    void sendKnockSensitivity(MPDevice *dev);
+    void sendRandomStartingPin(MPDevice *dev);
+    void sendHashDisplayEnabled(MPDevice *dev);
+    void sendLockUnlockMode(MPDevice *dev);
+    void sendKeyAfterLoginSendEnable(MPDevice *dev);
+    void sendKeyAfterLoginSend(MPDevice *dev);
+    void sendKeyAfterPassSendEnable(MPDevice *dev);
+    void sendKeyAfterPassSend(MPDevice *dev);
+    void sendDelayAfterKeyEntryEnable(MPDevice *dev);
+    void sendDelayAfterKeyEntry(MPDevice *dev);
+    void sendDeviceUID(MPDevice *dev);
+    void sendFilesCache(MPDevice *dev);
+    void sendCardDbMetadata(MPDevice *dev);
+    void sendStatusPollPolicy(MPDevice *dev);
+
+    void sendDeviceJsonMessage(MPDevice *dev, QJsonObject obj);
+    void sendDeviceList(const QJsonObject &root);
+
+    QWebSocket *wsClient = nullptr;
+    //Local socket connection from the GUI, used instead of wsClient
+    IpcSocket *ipcClient = nullptr;
+
+    //Messages of at least this size are sent compressed, 0 if
+    //the client did not ask for compression
+    int compressionThreshold = 0;
+    int compressionLevel = 0;
+    void sendCompressedMessage(const QByteArray &message);
+
+    //Default device, used for requests without device_id
     MPDevice *mpdevice = nullptr;
+    QList<MPDevice *> devices;
+    //Client knows about device ids and gets events from all devices
+    bool multiDevice = false;
+    //Device running a fetch_data capture for this client
+    MPDevice *fetchDataDevice = nullptr;
 
     QString clientUid;
 
@@ -93,11 +117,11 @@ private:
 
     QString HIBP_COMPROMISED_FORMAT = tr("this password has been compromised %1 times.");
 
-    void processParametersSet(const QJsonObject &data);
+    void processParametersSet(const QJsonObject &root, MPDevice *device);
     void sendFailedJson(QJsonObject obj, QString errstr = QString(), int errCode = -999);
     QString getRequestId(const QJsonValue &v);
-    void processMessageMini(QJsonObject root, const MPDeviceProgressCb &cbProgress);
-    void processMessageBLE(QJsonObject root, const MPDeviceProgressCb &cbProgress);
+    void processMessageMini(QJsonObject root, MPDevice *device, const MPDeviceProgressCb &cbProgress);
+    void processMessageBLE(QJsonObject root, MPDevice *device, const MPDeviceProgressCb &cbProgress);
 };
 
 #endif // WSSERVERCON_H
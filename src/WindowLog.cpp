@@ -18,23 +18,107 @@
  ******************************************************************************/
 #include "WindowLog.h"
 #include "ui_WindowLog.h"
+#include "LogParser.h"
 
 WindowLog::WindowLog(QWidget *parent) :
     QMainWindow(parent),
-    ui(new Ui::WindowLog)
+    ui(new Ui::WindowLog),
+    m_logModel(new LogModel(MAX_LINE_COUNT, this)),
+    m_filterModel(new LogFilterModel(this)),
+    m_parser(new LogParser)
 {
     setAttribute(Qt::WA_DeleteOnClose, true); //delete the dialog on close
     ui->setupUi(this);
+
+    qRegisterMetaType<QVector<LogLine>>();
+
+    QFont f = ui->listViewLog->font();
+#if defined(Q_OS_WIN)
+    f.setFamily("Courier");
+#elif defined(Q_OS_MAC)
+    f.setFamily("Monaco");
+#else
+    f.setFamily("Monospace");
+#endif
+    ui->listViewLog->setFont(f);
+    //Only visible rows are laid out, all lines have the same height
+    ui->listViewLog->setUniformItemSizes(true);
+    ui->listViewLog->setModel(m_logModel);
+    m_filterModel->setSourceModel(m_logModel);
+
+    m_parser->moveToThread(&m_parserThread);
+    connect(&m_parserThread, &QThread::finished, m_parser, &QObject::deleteLater);
+    connect(this, &WindowLog::parseRequested, m_parser, &LogParser::parse);
+    connect(m_parser, &LogParser::linesParsed, this, &WindowLog::appendLines);
+    m_parserThread.start(QThread::LowPriority);
+
+    m_flushTimer.setInterval(FLUSH_INTERVAL_MS);
+    m_flushTimer.setSingleShot(true);
+    connect(&m_flushTimer, &QTimer::timeout, this, &WindowLog::flushPendingData);
+
+    connect(ui->lineEditSearch, &QLineEdit::textChanged, this, &WindowLog::updateFilter);
+    connect(ui->comboBoxLevel, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+            this, &WindowLog::updateFilter);
+
+    auto copyShortcut = new QShortcut(QKeySequence::Copy, ui->listViewLog);
+    copyShortcut->setContext(Qt::WidgetShortcut);
+    connect(copyShortcut, &QShortcut::activated, this, &WindowLog::copySelection);
 }
 
 WindowLog::~WindowLog()
 {
+    m_parserThread.quit();
+    m_parserThread.wait();
     delete ui;
 }
 
 void WindowLog::appendData(const QByteArray &logdata)
 {
-    ui->plainTextEdit->appendMessage(QString::fromUtf8(logdata));
+    m_pendingData.append(logdata);
+    if (!m_flushTimer.isActive())
+        m_flushTimer.start();
+}
+
+void WindowLog::flushPendingData()
+{
+    emit parseRequested(m_pendingData);
+    m_pendingData.clear();
+}
+
+void WindowLog::appendLines(const QVector<LogLine> &lines)
+{
+    QScrollBar *scrollBar = ui->listViewLog->verticalScrollBar();
+    const bool atBottom = scrollBar->value() == scrollBar->maximum();
+
+    m_logModel->appendLines(lines);
+
+    if (atBottom)
+        ui->listViewLog->scrollToBottom();
+}
+
+void WindowLog::updateFilter()
+{
+    m_filterModel->setMinimumLevel(ui->comboBoxLevel->currentIndex());
+    m_filterModel->setSearchText(ui->lineEditSearch->text());
+
+    //The proxy is only used while filtering, it has to remap
+    //its rows each time old lines are dropped from the ring buffer
+    QAbstractItemModel *model = m_filterModel->isFiltering() ?
+                static_cast<QAbstractItemModel *>(m_filterModel) : m_logModel;
+    if (ui->listViewLog->model() != model)
+        ui->listViewLog->setModel(model);
+    ui->listViewLog->scrollToBottom();
+}
+
+void WindowLog::copySelection()
+{
+    QModelIndexList indexes = ui->listViewLog->selectionModel()->selectedIndexes();
+    std::sort(indexes.begin(), indexes.end());
+
+    QStringList lines;
+    for (const QModelIndex &index : indexes)
+        lines.append(index.data().toString());
+    QApplication::clipboard()->setText(lines.join('\n'));
 }
 
 void WindowLog::on_pushButtonClose_clicked()
@@ -44,7 +128,7 @@ void WindowLog::on_pushButtonClose_clicked()
 
 void WindowLog::on_pushButtonClear_clicked()
 {
-    ui->plainTextEdit->clear();
+    m_logModel->clear();
 }
 
 void WindowLog::changeEvent(QEvent *event)
@@ -21,6 +21,9 @@
 
 #include <QtWidgets>
 #include <QtCore>
+#include "LogModel.h"
+
+class LogParser;
 
 namespace Ui {
 class WindowLog;
@@ -36,16 +39,36 @@ public:
 
     void appendData(const QByteArray &logdata);
 
+signals:
+    void parseRequested(const QByteArray &data);
+
 private:
     virtual void changeEvent(QEvent *event);
+    void updateFilter();
 
 private slots:
     void on_pushButtonClose_clicked();
 
     void on_pushButtonClear_clicked();
 
+    void flushPendingData();
+    void appendLines(const QVector<LogLine> &lines);
+    void copySelection();
+
 private:
     Ui::WindowLog *ui;
+
+    LogModel *m_logModel;
+    LogFilterModel *m_filterModel;
+    QThread m_parserThread;
+    LogParser *m_parser;
+
+    //Data received since last frame, parsed by batch
+    QByteArray m_pendingData;
+    QTimer m_flushTimer;
+
+    static const int MAX_LINE_COUNT = 100000;
+    static const int FLUSH_INTERVAL_MS = 16;
 };
 
 #endif // WINDOWLOG_H
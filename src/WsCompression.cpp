@@ -0,0 +1,39 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#include "WsCompression.h"
+
+//First byte of a binary message, allows other encodings later
+#define WS_COMPRESSION_ZLIB     'Z'
+
+QByteArray WsCompression::compress(const QByteArray &message, int level)
+{
+    QByteArray frame(1, WS_COMPRESSION_ZLIB);
+    frame += qCompress(message, level);
+    return frame;
+}
+
+bool WsCompression::uncompress(const QByteArray &frame, QByteArray &message)
+{
+    //marker and qCompress size header
+    if (frame.size() < 5 || frame.at(0) != WS_COMPRESSION_ZLIB)
+        return false;
+
+    message = qUncompress(reinterpret_cast<const uchar *>(frame.constData()) + 1, frame.size() - 1);
+    return !message.isEmpty();
+}
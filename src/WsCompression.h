@@ -0,0 +1,43 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Foobar; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#ifndef WSCOMPRESSION_H
+#define WSCOMPRESSION_H
+
+#include <QByteArray>
+#include <QString>
+
+/* Compression of large websocket messages.
+ * A client that adds "compression=zlib" to the websocket url accepts binary
+ * messages holding a compressed JSON text, smaller messages stay text.
+ */
+class WsCompression
+{
+public:
+    static QString queryItem() { return QStringLiteral("compression"); }
+    static QString algorithm() { return QStringLiteral("zlib"); }
+
+    static const int DEFAULT_THRESHOLD = 16 * 1024;
+    static const int DEFAULT_LEVEL = 6;
+
+    static QByteArray compress(const QByteArray &message, int level = DEFAULT_LEVEL);
+    //Returns false if the frame is not a valid compressed message
+    static bool uncompress(const QByteArray &frame, QByteArray &message);
+};
+
+#endif // WSCOMPRESSION_H
@@ -333,3 +333,35 @@ void DbBackupsTrackerTests::getFileFormatSimpleCrypt()
     QCOMPARE(QString("SimpleCrypt"), t->getTrackedBackupFileFormat());
     t->deleteLater();
 }
+
+void DbBackupsTrackerTests::backupFileRewritten()
+{
+    DbBackupsTracker* t = new DbBackupsTracker("/tmp/test_db_backups_tracker.info");
+    t->setCardId("00000");
+    t->setCredentialsDbChangeNumber(5);
+    t->setDataDbChangeNumber(0);
+
+    QTemporaryFile file;
+    file.open();
+    file.write(R"({"credentialsDbChangeNumber": 5, "dataDbChangeNumber": 0, "payload": ""})");
+    file.flush();
+
+    t->track(file.fileName());
+    Q_ASSERT(!t->isUpdateRequired());
+
+    // Change numbers are probed again once the file changed on disk
+    file.resize(0);
+    file.write(R"({"credentialsDbChangeNumber": 10, "dataDbChangeNumber": 0, "encryption": "SimpleCrypt", "payload": ""})");
+    file.flush();
+    Q_ASSERT(t->isUpdateRequired());
+
+    // Change numbers stored after the payload are still found
+    file.resize(0);
+    file.write(QByteArray(R"({"payload": ")") + QByteArray(8192, 'A') + R"(", "credentialsDbChangeNumber": 5, "dataDbChangeNumber": 0})");
+    file.flush();
+    Q_ASSERT(!t->isUpdateRequired());
+    QCOMPARE(QString("SimpleCrypt"), t->getTrackedBackupFileFormat());
+
+    t->deleteLater();
+    file.close();
+}
@@ -31,6 +31,7 @@ private slots:
 
     void getFileFormatLegacy();
     void getFileFormatSimpleCrypt();
+    void backupFileRewritten();
 
 private:
     DbBackupsTracker tracker;
@@ -32,3 +32,53 @@ void FilesCacheTests::testSaveAndLoadFileNames()
 
     QVERIFY(cache.erase());
 }
+
+void FilesCacheTests::testJournaledChanges()
+{
+    QList<QVariantMap> testFiles;
+    for (int i = 0; i< 3; i++)
+    {
+        QVariantMap item;
+        item.insert("revision", 0);
+        item.insert("name", QString("file %1").arg(i));
+        item.insert("size", 1024*i);
+        testFiles << item;
+    }
+
+    {
+        FilesCache cache;
+        cache.setDbChangeNumber(0);
+        cache.setCardCPZ("cbe9cad108aad501");
+        QVERIFY(cache.save(testFiles));
+
+        QVERIFY(cache.addFile("file 3", 42));
+        QVERIFY(!cache.addFile("file 3", 42));
+        QVERIFY(cache.updateFile("file 1", 10));
+        QVERIFY(cache.removeFile("file 0"));
+        QVERIFY(!cache.removeFile("file 0"));
+
+        // Enough changes to trigger a compaction
+        for (int i = 0; i < 100; i++)
+            QVERIFY(cache.updateFile("file 2", i));
+
+        // Change number is journaled, files are kept
+        cache.setDbChangeNumber(1);
+    }
+
+    // Replay the journal from disk
+    FilesCache cache;
+    cache.setDbChangeNumber(1);
+    cache.setCardCPZ("cbe9cad108aad501");
+
+    QList<QVariantMap> fileInCache = cache.load();
+    QVERIFY(cache.isInSync());
+    QCOMPARE(fileInCache.size(), 3);
+    QCOMPARE(fileInCache.at(0).value("name").toString(), QString("file 1"));
+    QCOMPARE(fileInCache.at(0).value("revision").toInt(), 1);
+    QCOMPARE(fileInCache.at(0).value("size").toInt(), 10);
+    QCOMPARE(fileInCache.at(1).value("name").toString(), QString("file 2"));
+    QCOMPARE(fileInCache.at(1).value("revision").toInt(), 100);
+    QCOMPARE(fileInCache.at(2).value("name").toString(), QString("file 3"));
+
+    QVERIFY(cache.erase());
+}
@@ -13,6 +13,7 @@ public:
 
 private Q_SLOTS:
     void testSaveAndLoadFileNames();
+    void testJournaledChanges();
 };
 
 
@@ -0,0 +1,162 @@
+#include <qtestcase.h>
+
+#include "TestAeadCrypt.h"
+#include "../src/AeadCrypt/AeadCrypt.h"
+#include "../src/AeadCrypt/ChaChaPoly.h"
+
+static const QByteArray CPZ = QByteArray::fromHex("00112233445566778899aabbccddeeff");
+
+TestAeadCrypt::TestAeadCrypt(QObject *parent) : QObject(parent)
+{
+}
+
+void TestAeadCrypt::test_rfc8439Vector()
+{
+    //RFC 8439 section 2.8.2
+    QByteArray plaintext("Ladies and Gentlemen of the class of '99: If I could offer you only one tip "
+                         "for the future, sunscreen would be it.");
+    QByteArray key = QByteArray::fromHex("808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f");
+    QByteArray nonce = QByteArray::fromHex("070000004041424344454647");
+    QByteArray aad = QByteArray::fromHex("50515253c0c1c2c3c4c5c6c7");
+    QByteArray expected = QByteArray::fromHex(
+                "d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d6"
+                "3dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b36"
+                "92ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc"
+                "3ff4def08e4b7a9de576d26586cec64b6116"
+                "1ae10b594f09e26a7e902ecbd0600691");
+
+    QByteArray out(plaintext.size() + static_cast<int>(ChaChaPoly::TAG_SIZE), 0);
+    ChaChaPoly::seal(reinterpret_cast<const uint8_t *>(key.constData()),
+                     reinterpret_cast<const uint8_t *>(nonce.constData()),
+                     reinterpret_cast<const uint8_t *>(aad.constData()), static_cast<size_t>(aad.size()),
+                     reinterpret_cast<const uint8_t *>(plaintext.constData()), static_cast<size_t>(plaintext.size()),
+                     reinterpret_cast<uint8_t *>(out.data()));
+    QCOMPARE(out, expected);
+
+    QByteArray decrypted(plaintext.size(), 0);
+    QVERIFY(ChaChaPoly::open(reinterpret_cast<const uint8_t *>(key.constData()),
+                             reinterpret_cast<const uint8_t *>(nonce.constData()),
+                             reinterpret_cast<const uint8_t *>(aad.constData()), static_cast<size_t>(aad.size()),
+                             reinterpret_cast<const uint8_t *>(out.constData()), static_cast<size_t>(plaintext.size()),
+                             reinterpret_cast<uint8_t *>(decrypted.data())));
+    QCOMPARE(decrypted, plaintext);
+}
+
+void TestAeadCrypt::test_roundTrip()
+{
+    QFETCH(int, size);
+
+    QByteArray plaintext(size, Qt::Uninitialized);
+    for (int i = 0;i < size;i++)
+        plaintext[i] = static_cast<char>(i * 31 + 7);
+
+    AeadCrypt crypt(CPZ);
+    QString cipher = crypt.encryptToString(plaintext);
+    QCOMPARE(crypt.lastError(), AeadCrypt::ErrorNoError);
+    QVERIFY(AeadCrypt::isAeadString(cipher));
+
+    QCOMPARE(crypt.decryptToByteArray(cipher), plaintext);
+    QCOMPARE(crypt.lastError(), AeadCrypt::ErrorNoError);
+
+    //Random salt, the same input never gives the same output
+    QVERIFY(crypt.encryptToString(plaintext) != cipher);
+}
+
+void TestAeadCrypt::test_roundTrip_data()
+{
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("empty") << 0;
+    QTest::newRow("small") << 100;
+    QTest::newRow("one chunk") << (1 << AeadCrypt::DEFAULT_CHUNK_LOG2);
+    QTest::newRow("several chunks") << 3 * (1 << AeadCrypt::DEFAULT_CHUNK_LOG2) + 17;
+}
+
+void TestAeadCrypt::test_streaming()
+{
+    QByteArray plaintext(5000, 'x');
+    AeadCrypt crypt(CPZ);
+
+    //Small chunks and uneven writes
+    AeadCrypt::Encryptor enc(crypt, 10);
+    QByteArray cipher;
+    for (int i = 0;i < plaintext.size();i += 333)
+        cipher.append(enc.update(plaintext.mid(i, 333)));
+    cipher.append(enc.finish());
+
+    AeadCrypt::Decryptor dec(crypt);
+    QByteArray decrypted;
+    for (int i = 0;i < cipher.size();i += 100)
+        QVERIFY(dec.update(cipher.mid(i, 100), decrypted));
+    QVERIFY(dec.finish(decrypted));
+    QCOMPARE(decrypted, plaintext);
+}
+
+void TestAeadCrypt::test_tampering()
+{
+    QByteArray plaintext(3 * 1024, 'a');
+    AeadCrypt crypt(CPZ);
+
+    AeadCrypt::Encryptor enc(crypt, 10);
+    QByteArray cipher = enc.update(plaintext);
+    cipher.append(enc.finish());
+
+    QByteArray flipped = cipher;
+    flipped[flipped.size() / 2] = flipped[flipped.size() / 2] ^ 0x01;
+    QVERIFY(crypt.decrypt(flipped).isEmpty());
+    QCOMPARE(crypt.lastError(), AeadCrypt::ErrorIntegrityFailed);
+
+    //Dropping the last chunk must not go unnoticed
+    QByteArray truncated = cipher.left(AeadCrypt::HEADER_SIZE + 2 * (1024 + AeadCrypt::TAG_SIZE));
+    QVERIFY(crypt.decrypt(truncated).isEmpty());
+    QCOMPARE(crypt.lastError(), AeadCrypt::ErrorIntegrityFailed);
+
+    QByteArray header = cipher;
+    header[5] = static_cast<char>(0x80); //unknown flag
+    QVERIFY(crypt.decrypt(header).isEmpty());
+    QCOMPARE(crypt.lastError(), AeadCrypt::ErrorInvalidHeader);
+}
+
+void TestAeadCrypt::test_wrongKey()
+{
+    AeadCrypt crypt(CPZ);
+    QString cipher = crypt.encryptToString("secret");
+
+    AeadCrypt other(QByteArray::fromHex("ffeeddccbbaa99887766554433221100"));
+    QVERIFY(other.decryptToByteArray(cipher).isEmpty());
+    QCOMPARE(other.lastError(), AeadCrypt::ErrorIntegrityFailed);
+
+    AeadCrypt noKey;
+    QVERIFY(noKey.decryptToByteArray(cipher).isEmpty());
+    QCOMPARE(noKey.lastError(), AeadCrypt::ErrorNoKeySet);
+}
+
+void TestAeadCrypt::test_compression()
+{
+    QByteArray json;
+    for (int i = 0;i < 100000;i++)
+        json.append(QStringLiteral("{\"service\": \"%1\"},").arg(i % 500).toUtf8());
+
+    AeadCrypt crypt(CPZ);
+    QByteArray cipher = crypt.encrypt(json);
+    QCOMPARE(static_cast<int>(cipher.at(5)), static_cast<int>(BlockCompressor::CodecZlib));
+    QVERIFY(cipher.size() < json.size() / 2);
+    QCOMPARE(crypt.decrypt(cipher), json);
+
+    //Random looking data is stored, the samples don't shrink
+    QByteArray noise(BlockCompressor::BLOCK_SIZE * 2, Qt::Uninitialized);
+    quint32 seed = 1;
+    for (int i = 0;i < noise.size();i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        noise[i] = static_cast<char>(seed >> 16);
+    }
+    cipher = crypt.encrypt(noise);
+    QCOMPARE(static_cast<int>(cipher.at(5)), static_cast<int>(BlockCompressor::CodecStore));
+    QCOMPARE(crypt.decrypt(cipher), noise);
+
+    crypt.setCompressionLevel(0);
+    cipher = crypt.encrypt(json);
+    QCOMPARE(static_cast<int>(cipher.at(5)), static_cast<int>(BlockCompressor::CodecStore));
+    QCOMPARE(crypt.decrypt(cipher), json);
+}
@@ -0,0 +1,23 @@
+#ifndef TESTAEADCRYPT_H
+#define TESTAEADCRYPT_H
+
+#include <QtTest/QtTest>
+
+class TestAeadCrypt : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TestAeadCrypt(QObject *parent = nullptr);
+
+private slots:
+    void test_rfc8439Vector();
+    void test_roundTrip();
+    void test_roundTrip_data();
+    void test_streaming();
+    void test_tampering();
+    void test_wrongKey();
+    void test_compression();
+};
+
+#endif // TESTAEADCRYPT_H
@@ -0,0 +1,86 @@
+#include "TestAsyncLogger.h"
+
+#include "../src/AsyncLogger.h"
+
+static LogEntry entry(int i)
+{
+    LogEntry e;
+    e.type = QtWarningMsg;
+    e.line = i;
+    e.msg = QString::number(i);
+    return e;
+}
+
+TestAsyncLogger::TestAsyncLogger(QObject *parent) : QObject(parent)
+{
+
+}
+
+void TestAsyncLogger::ringOrdering()
+{
+    LogRingBuffer ring(8);
+    QVERIFY(ring.isEmpty());
+
+    // Wrap around the ring a few times
+    int next = 0;
+    for (int i = 0; i < 20; i++)
+    {
+        QVERIFY(ring.push(entry(i)));
+        if (i % 3 == 2)
+        {
+            LogEntry e;
+            while (ring.pop(e))
+                QCOMPARE(e.line, next++);
+        }
+    }
+
+    LogEntry e;
+    while (ring.pop(e))
+        QCOMPARE(e.line, next++);
+    QCOMPARE(next, 20);
+    QVERIFY(ring.isEmpty());
+}
+
+void TestAsyncLogger::ringFull()
+{
+    LogRingBuffer ring(4);
+    for (int i = 0; i < 4; i++)
+        QVERIFY(ring.push(entry(i)));
+    QVERIFY(!ring.push(entry(4)));
+
+    // A freed cell can be used again
+    LogEntry e;
+    QVERIFY(ring.pop(e));
+    QCOMPARE(e.msg, QString("0"));
+    QVERIFY(ring.push(entry(5)));
+    QVERIFY(!ring.push(entry(6)));
+}
+
+void TestAsyncLogger::droppedWhenFull()
+{
+    // Writer thread is not started, nothing is consumed
+    AsyncLogger logger;
+    QMessageLogContext context(__FILE__, __LINE__, Q_FUNC_INFO, "test");
+
+    for (int i = 0; i < AsyncLogger::RING_SIZE + 3; i++)
+        logger.log(QtWarningMsg, context, QString::number(i));
+
+    QCOMPARE(logger.getDroppedFull(), quint64(3));
+    QCOMPARE(logger.getDroppedRate(), quint64(0));
+}
+
+void TestAsyncLogger::rateLimit()
+{
+    AsyncLogger logger;
+    QMessageLogContext context(__FILE__, __LINE__, Q_FUNC_INFO, "test");
+
+    for (int i = 0; i < AsyncLogger::RATE_LIMIT_PER_SEC + 5; i++)
+        logger.log(QtDebugMsg, context, QString::number(i));
+    QCOMPARE(logger.getDroppedRate(), quint64(5));
+
+    // Warnings are never limited
+    for (int i = 0; i < 5; i++)
+        logger.log(QtWarningMsg, context, QString::number(i));
+    QCOMPARE(logger.getDroppedRate(), quint64(5));
+    QCOMPARE(logger.getDroppedFull(), quint64(0));
+}
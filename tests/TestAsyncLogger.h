@@ -0,0 +1,20 @@
+#ifndef TESTASYNCLOGGER_H
+#define TESTASYNCLOGGER_H
+
+#include <QtTest/QtTest>
+
+class TestAsyncLogger : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TestAsyncLogger(QObject *parent = nullptr);
+
+private slots:
+    void ringOrdering();
+    void ringFull();
+    void droppedWhenFull();
+    void rateLimit();
+};
+
+#endif // TESTASYNCLOGGER_H
@@ -2,8 +2,11 @@
 
 #include <QJsonDocument>
 #include <QJsonArray>
+#include <QJsonObject>
+#include <QtTest>
 
 #include "../src/CredentialModel.h"
+#include "../src/LoginItem.h"
 
 TestCredentialModel::TestCredentialModel(QObject *parent) : QObject(parent)
 {
@@ -49,6 +52,141 @@ void TestCredentialModel::oneCredentialRemoved()
     Q_ASSERT(l2.value("login").toString().compare("loginB") == 0);
 }
 
+void TestCredentialModel::serviceLookupIsCaseInsensitive()
+{
+    CredentialModel *model = createCredentialModelWithThreeLogins();
+
+    // Same service with another case must not create a new service
+    model->addCredential("SERVICE.io", "loginC", "password");
+    QCOMPARE(model->rowCount(), 1);
+    QCOMPARE(model->getJsonChanges().count(), 4);
+
+    // Existing login is not added twice
+    model->addCredential("service.io", "loginA", "password");
+    QCOMPARE(model->getJsonChanges().count(), 4);
+
+    delete model;
+}
+
+void TestCredentialModel::reloadUpdatesRowsInPlace()
+{
+    CredentialModel *model = createCredentialModelWithThreeLogins();
+    QModelIndex serviceIdx = model->index(0, 0);
+
+    // Login rows are fetched on demand
+    QCOMPARE(model->rowCount(serviceIdx), 0);
+    QVERIFY(model->hasChildren(serviceIdx));
+    QVERIFY(model->canFetchMore(serviceIdx));
+    model->fetchMore(serviceIdx);
+    QCOMPARE(model->rowCount(serviceIdx), 3);
+
+    QJsonArray array = createChangedCredentialsJson();
+
+    QSignalSpy resetSpy(model, &QAbstractItemModel::modelReset);
+    QSignalSpy insertSpy(model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removeSpy(model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy changeSpy(model, &QAbstractItemModel::dataChanged);
+    model->load(array);
+
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(insertSpy.count(), 1);
+    QCOMPARE(removeSpy.count(), 1);
+    // loginB, then the service row once for the added and once for the removed login
+    QCOMPARE(changeSpy.count(), 3);
+    QCOMPARE(model->rowCount(serviceIdx), 3);
+
+    QJsonArray result = model->getJsonChanges();
+    QCOMPARE(result.count(), 3);
+    QCOMPARE(result.at(0).toObject().value("login").toString(), QString("loginA"));
+    QCOMPARE(result.at(1).toObject().value("description").toString(), QString("changed"));
+    QCOMPARE(result.at(2).toObject().value("login").toString(), QString("loginC"));
+
+    // Dates are parsed when read
+    LoginItem *pLoginItem = model->getLoginItemByIndex(model->index(0, 0, serviceIdx));
+    QCOMPARE(pLoginItem->updatedDate(), QDate(2018, 1, 28));
+
+    delete model;
+}
+
+void TestCredentialModel::reloadKeepsLoginsUnfetched()
+{
+    CredentialModel *model = createCredentialModelWithThreeLogins();
+    QModelIndex serviceIdx = model->index(0, 0);
+    QVERIFY(model->canFetchMore(serviceIdx));
+
+    QSignalSpy insertSpy(model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removeSpy(model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy changeSpy(model, &QAbstractItemModel::dataChanged);
+    model->load(createChangedCredentialsJson());
+
+    // Only the service row is updated, once per changed, added and removed
+    // login, its logins are still not fetched
+    QCOMPARE(insertSpy.count(), 0);
+    QCOMPARE(removeSpy.count(), 0);
+    QCOMPARE(changeSpy.count(), 3);
+    QVERIFY(model->canFetchMore(serviceIdx));
+    QCOMPARE(model->rowCount(serviceIdx), 0);
+
+    model->fetchMore(serviceIdx);
+    QCOMPARE(model->rowCount(serviceIdx), 3);
+    QCOMPARE(model->getJsonChanges().at(1).toObject().value("description").toString(), QString("changed"));
+
+    delete model;
+}
+
+void TestCredentialModel::loadTenThousandCredentials()
+{
+    QJsonArray array = createCredentialsJson(5000, 2);
+
+    QBENCHMARK
+    {
+        CredentialModel model;
+        model.load(array);
+        QCOMPARE(model.rowCount(), 5000);
+    }
+}
+
+QJsonArray TestCredentialModel::createChangedCredentialsJson()
+{
+    // Remove the first login, change loginB and add loginC
+    QJsonArray array = QJsonDocument::fromJson(emptyLoginTestJson).array();
+    QJsonObject service = array.at(0).toObject();
+    QJsonArray childs = service["childs"].toArray();
+    childs.removeFirst();
+    QJsonObject loginB = childs.at(1).toObject();
+    loginB["description"] = "changed";
+    childs.replace(1, loginB);
+    QJsonObject loginC = childs.at(0).toObject();
+    loginC["login"] = "loginC";
+    childs.append(loginC);
+    service["childs"] = childs;
+    array.replace(0, service);
+
+    return array;
+}
+
+QJsonArray TestCredentialModel::createCredentialsJson(int serviceCount, int loginsPerService)
+{
+    QJsonArray services;
+    for (int s = 0; s < serviceCount; s++)
+    {
+        QJsonArray childs;
+        for (int l = 0; l < loginsPerService; l++)
+        {
+            childs.append(QJsonObject {{ "address", QJsonArray { s % 256, l } },
+                                       { "date_created", "2018-01-28" },
+                                       { "date_last_used", "2018-01-28" },
+                                       { "description", "" },
+                                       { "favorite", -1 },
+                                       { "login", QString("login%1").arg(l) }});
+        }
+        services.append(QJsonObject {{ "childs", childs },
+                                     { "service", QString("service%1.com").arg(s) }});
+    }
+
+    return services;
+}
+
 QModelIndex TestCredentialModel::findLoginIndex(QString loginName, QString serviceName, QAbstractItemModel *model)
 {
     bool found = false;
@@ -58,6 +196,8 @@ QModelIndex TestCredentialModel::findLoginIndex(QString loginName, QString servi
         const QModelIndex sIdx = model->index(r, 0);
         const QString sItemName = sIdx.data(Qt::DisplayRole).toString();
         if (serviceName.compare(sItemName) == 0) {
+            if (model->canFetchMore(sIdx))
+                model->fetchMore(sIdx);
             for (int sr = 0; sr < model->rowCount(sIdx) && !found; sr ++) {
                 const QModelIndex lIdx = model->index(r, 0, sIdx);
                 const QString lItemName = lIdx.data(Qt::DisplayRole).toString();
@@ -1,6 +1,7 @@
 #include "TestCredentialModelFilter.h"
 
 #include <QJsonObject>
+#include <QtTest>
 
 #include "../src/TreeItem.h"
 #include "../src/LoginItem.h"
@@ -45,3 +46,106 @@ void TestCredentialModelFilter::findAndRemoveCredentialFromSourceModel()
     filter->deleteLater();
     sourceModel->deleteLater();
 }
+
+void TestCredentialModelFilter::filterFollowsSourceModelChanges()
+{
+    CredentialModel *sourceModel = TestCredentialModel::createCredentialModelWithThreeLogins();
+    CredentialModelFilter *filter = new CredentialModelFilter();
+    filter->setSourceModel(sourceModel);
+    filter->fetchMore(filter->index(0, 0));
+
+    filter->setFilter("logina");
+    QCOMPARE(filter->rowCount(), 1);
+    QCOMPARE(filter->rowCount(filter->index(0, 0)), 1);
+
+    // Service name matches, all its logins are shown
+    filter->setFilter("service");
+    QCOMPARE(filter->rowCount(filter->index(0, 0)), 3);
+
+    filter->setFilter("nomatch");
+    QCOMPARE(filter->rowCount(), 0);
+
+    // New credential is indexed when added to the source model
+    filter->setFilter("login");
+    sourceModel->addCredential("service.io", "loginC", "password");
+    QCOMPARE(filter->rowCount(filter->index(0, 0)), 3);
+
+    // Renamed login is reindexed
+    QModelIndex idx = sourceModel->index(2, 0, sourceModel->index(0, 0));
+    QCOMPARE(sourceModel->getLoginItemByIndex(idx)->name(), QString("loginB"));
+    sourceModel->updateLoginItem(idx, CredentialModel::ItemNameRole, "renamedB");
+    QCOMPARE(filter->rowCount(filter->index(0, 0)), 2);
+
+    filter->setFilter("renamed");
+    QCOMPARE(filter->rowCount(filter->index(0, 0)), 1);
+
+    filter->setFilter("");
+    QCOMPARE(filter->rowCount(filter->index(0, 0)), 4);
+
+    filter->deleteLater();
+    sourceModel->deleteLater();
+}
+
+void TestCredentialModelFilter::filterFollowsUnfetchedLogins()
+{
+    CredentialModel *sourceModel = TestCredentialModel::createCredentialModelWithThreeLogins();
+    CredentialModelFilter *filter = new CredentialModelFilter();
+    filter->setSourceModel(sourceModel);
+
+    filter->setFilter("changed");
+    QCOMPARE(filter->rowCount(), 0);
+
+    // Logins are changed, added and removed without being fetched
+    sourceModel->load(TestCredentialModel::createChangedCredentialsJson());
+    QVERIFY(sourceModel->canFetchMore(sourceModel->index(0, 0)));
+    QCOMPARE(filter->rowCount(), 1);
+
+    filter->setFilter("loginc");
+    QCOMPARE(filter->rowCount(), 1);
+
+    filter->setFilter("");
+    filter->fetchMore(filter->index(0, 0));
+    QCOMPARE(filter->rowCount(filter->index(0, 0)), 3);
+
+    filter->setFilter("changed");
+    QCOMPARE(filter->rowCount(filter->index(0, 0)), 1);
+
+    filter->deleteLater();
+    sourceModel->deleteLater();
+}
+
+void TestCredentialModelFilter::fuzzyFilter()
+{
+    CredentialModel *sourceModel = TestCredentialModel::createCredentialModelWithThreeLogins();
+    CredentialModelFilter *filter = new CredentialModelFilter();
+    filter->setSourceModel(sourceModel);
+    filter->fetchMore(filter->index(0, 0));
+
+    filter->setFilter("lgnb");
+    QCOMPARE(filter->rowCount(), 0);
+
+    filter->setFuzzyFilter(true);
+    QCOMPARE(filter->rowCount(), 1);
+    QCOMPARE(filter->rowCount(filter->index(0, 0)), 1);
+
+    filter->deleteLater();
+    sourceModel->deleteLater();
+}
+
+void TestCredentialModelFilter::filterTenThousandCredentials()
+{
+    CredentialModel sourceModel;
+    sourceModel.load(TestCredentialModel::createCredentialsJson(5000, 2));
+    CredentialModelFilter filter;
+    filter.setSourceModel(&sourceModel);
+
+    QBENCHMARK
+    {
+        filter.setFilter("s");
+        filter.setFilter("se");
+        filter.setFilter("ser");
+        filter.setFilter("service49");
+        filter.setFilter("service4999");
+    }
+    QCOMPARE(filter.rowCount(), 1);
+}
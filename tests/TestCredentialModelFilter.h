@@ -11,6 +11,10 @@ public:
 
 private slots:
     void findAndRemoveCredentialFromSourceModel();
+    void filterFollowsSourceModelChanges();
+    void filterFollowsUnfetchedLogins();
+    void fuzzyFilter();
+    void filterTenThousandCredentials();
 };
 
 #endif // TESTCREDENTIALMODELFILTER_H
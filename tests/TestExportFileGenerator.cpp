@@ -0,0 +1,151 @@
+#include "TestExportFileGenerator.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "../src/ExportFileGenerator.h"
+#include "../src/SimpleCrypt/SimpleCrypt.h"
+#include "../src/AeadCrypt/AeadCrypt.h"
+
+static const QByteArray CPZ = QByteArray::fromHex("00112233445566778899aabbccddeeff");
+static const quint64 SIMPLECRYPT_KEY = Q_UINT64_C(0x0123456789abcdef);
+// More child nodes than the progress step, so progress is reported on the way
+static const int LOGIN_CHILD_COUNT = 100;
+
+static QVector<ExportFileGenerator::Node> createNodes(int count, const QString &prefix, quint8 addrHigh)
+{
+    QVector<ExportFileGenerator::Node> nodes;
+    for (int i = 0; i < count; i++)
+    {
+        ExportFileGenerator::Node n;
+        n.address = QByteArray(1, static_cast<char>(i)) + QByteArray(1, static_cast<char>(addrHigh));
+        n.name = QString("%1%2").arg(prefix).arg(i);
+        n.data = QByteArray(4, static_cast<char>(i));
+        nodes.append(n);
+    }
+    return nodes;
+}
+
+static ExportFileGenerator::Snapshot createSnapshot()
+{
+    ExportFileGenerator::Snapshot snapshot;
+    snapshot.ctrValue = QByteArray::fromHex("010203");
+    snapshot.cpzCtrValue << QByteArray::fromHex("0a0b0c0d");
+    snapshot.startNode = QByteArray::fromHex("0010");
+    snapshot.startDataNode = QByteArray::fromHex("0020");
+    snapshot.favoritesAddrs << QByteArray::fromHex("00100011");
+    snapshot.loginNodes = createNodes(2, "service", 0x10);
+    snapshot.loginChildNodes = createNodes(LOGIN_CHILD_COUNT, "login", 0x11);
+    snapshot.dataNodes = createNodes(1, "file", 0x20);
+    snapshot.dataChildNodes = createNodes(1, QString(), 0x21);
+    snapshot.credentialsDbChangeNumber = 12;
+    snapshot.dataDbChangeNumber = 34;
+    snapshot.serialNumber = 1234567;
+    snapshot.cardCPZ = CPZ;
+    snapshot.simpleCryptKey = SIMPLECRYPT_KEY;
+    snapshot.compressionLevel = AeadCrypt::DEFAULT_COMPRESSION_LEVEL;
+    return snapshot;
+}
+
+TestExportFileGenerator::TestExportFileGenerator(QObject *parent) : QObject(parent)
+{
+
+}
+
+void TestExportFileGenerator::generate_data()
+{
+    QTest::addColumn<QString>("encryption");
+
+    QTest::newRow("none") << QString("none");
+    QTest::newRow("SimpleCrypt") << QString("SimpleCrypt");
+    QTest::newRow("ChaCha20-Poly1305") << QString("ChaCha20-Poly1305");
+}
+
+void TestExportFileGenerator::generate()
+{
+    QFETCH(QString, encryption);
+
+    ExportFileGenerator::Snapshot snapshot = createSnapshot();
+    const int nodeCount = snapshot.loginNodes.size() + snapshot.loginChildNodes.size() +
+                          snapshot.dataNodes.size() + snapshot.dataChildNodes.size();
+
+    QList<int> progress;
+    int progressTotal = 0;
+    QByteArray fileData = ExportFileGenerator::generate(snapshot, encryption,
+                                                        [&progress, &progressTotal](int current, int total, const QString &)
+    {
+        progress << current;
+        progressTotal = total;
+    });
+
+    // Progress goes up to the nodes and the encryption step
+    QCOMPARE(progressTotal, nodeCount + 1);
+    QVERIFY(progress.size() > 1);
+    for (int i = 1; i < progress.size(); i++)
+        QVERIFY(progress[i] >= progress[i - 1]);
+    QCOMPARE(progress.last(), progressTotal);
+
+    QByteArray payload;
+    if (encryption == "none")
+    {
+        payload = fileData;
+    }
+    else
+    {
+        QJsonObject envelope = QJsonDocument::fromJson(fileData).object();
+        QCOMPARE(envelope["encryption"].toString(), encryption);
+        QCOMPARE(envelope["credentialsDbChangeNumber"].toInt(), 12);
+        QCOMPARE(envelope["dataDbChangeNumber"].toInt(), 34);
+
+        if (encryption == "SimpleCrypt")
+        {
+            SimpleCrypt simpleCrypt(SIMPLECRYPT_KEY);
+            payload = simpleCrypt.decryptToByteArray(envelope["payload"].toString());
+            QCOMPARE(simpleCrypt.lastError(), SimpleCrypt::ErrorNoError);
+        }
+        else
+        {
+            AeadCrypt aeadCrypt(CPZ);
+            payload = aeadCrypt.decryptToByteArray(envelope["payload"].toString());
+            QCOMPARE(aeadCrypt.lastError(), AeadCrypt::ErrorNoError);
+        }
+    }
+
+    QJsonParseError parseError;
+    QJsonArray top = QJsonDocument::fromJson(payload, &parseError).array();
+    QCOMPARE(parseError.error, QJsonParseError::NoError);
+    QCOMPARE(top.size(), 14);
+
+    QCOMPARE(top[0].toObject().size(), 3);
+    QCOMPARE(top[0].toObject()["2"].toInt(), 3);
+    QCOMPARE(top[1].toArray().size(), 1);
+    QCOMPARE(top[2].toArray(), QJsonArray({ 0x00, 0x10 }));
+    QCOMPARE(top[3].toArray(), QJsonArray({ 0x00, 0x20 }));
+    QCOMPARE(top[4].toArray().size(), 1);
+
+    QJsonArray loginNodes = top[5].toArray();
+    QCOMPARE(loginNodes.size(), 2);
+    QCOMPARE(loginNodes[1].toObject()["name"].toString(), QString("service1"));
+    QVERIFY(!loginNodes[1].toObject().contains("pointed"));
+
+    QJsonArray loginChildNodes = top[6].toArray();
+    QCOMPARE(loginChildNodes.size(), LOGIN_CHILD_COUNT);
+    QJsonObject child = loginChildNodes[5].toObject();
+    QCOMPARE(child["address"].toArray(), QJsonArray({ 5, 0x11 }));
+    QCOMPARE(child["name"].toString(), QString("login5"));
+    QCOMPARE(child["data"].toObject().size(), 4);
+    QCOMPARE(child["data"].toObject()["3"].toInt(), 5);
+    QCOMPARE(child.value("pointed"), QJsonValue(false));
+
+    QCOMPARE(top[7].toArray().size(), 1);
+    QJsonObject dataChild = top[8].toArray()[0].toObject();
+    QVERIFY(!dataChild.contains("name"));
+    QCOMPARE(dataChild.value("pointed"), QJsonValue(false));
+
+    QCOMPARE(top[9].toString(), QString("moolticute"));
+    QCOMPARE(top[10].toInt(), 1);
+    QCOMPARE(top[11].toInt(), 12);
+    QCOMPARE(top[12].toInt(), 34);
+    QCOMPARE(top[13].toInt(), 1234567);
+}
@@ -0,0 +1,18 @@
+#ifndef TESTEXPORTFILEGENERATOR_H
+#define TESTEXPORTFILEGENERATOR_H
+
+#include <QtTest/QtTest>
+
+class TestExportFileGenerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TestExportFileGenerator(QObject *parent = nullptr);
+
+private slots:
+    void generate();
+    void generate_data();
+};
+
+#endif // TESTEXPORTFILEGENERATOR_H
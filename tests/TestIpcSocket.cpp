@@ -0,0 +1,67 @@
+#include "TestIpcSocket.h"
+
+#include <QJsonArray>
+#include <QJsonObject>
+
+#include "../src/IpcSocket.h"
+
+TestIpcSocket::TestIpcSocket(QObject *parent) : QObject(parent)
+{
+
+}
+
+void TestIpcSocket::frameRoundTrip()
+{
+    QJsonObject obj {{ "msg", "memorymgmt_data" },
+                     { "data", QJsonObject {{ "login_nodes", QJsonArray { 1, 2, 3 } },
+                                            { "service", QString::fromUtf8("s\xc3\xa9rvice") }}}};
+
+    QByteArray buffer = IpcSocket::encodeFrame(IpcSocket::FrameJson, obj);
+
+    int pos = 0;
+    IpcSocket::FrameType type;
+    QJsonObject decoded;
+    bool error = false;
+    QVERIFY(IpcSocket::takeFrame(buffer, pos, type, decoded, error));
+    QVERIFY(!error);
+    QCOMPARE(type, IpcSocket::FrameJson);
+    QCOMPARE(decoded, obj);
+    QCOMPARE(pos, buffer.size());
+}
+
+void TestIpcSocket::partialAndMultipleFrames()
+{
+    QByteArray buffer = IpcSocket::encodeFrame(IpcSocket::FrameHello, {{ "encoding", IpcSocket::encodingName() }});
+    buffer += IpcSocket::encodeFrame(IpcSocket::FrameJson, {{ "msg", "ping" }});
+
+    int pos = 0;
+    IpcSocket::FrameType type;
+    QJsonObject decoded;
+    bool error = false;
+
+    // Incomplete data waits for more
+    QByteArray partial = buffer.left(buffer.size() - 1);
+    QVERIFY(IpcSocket::takeFrame(partial, pos, type, decoded, error));
+    QCOMPARE(type, IpcSocket::FrameHello);
+    int helloEnd = pos;
+    QVERIFY(!IpcSocket::takeFrame(partial, pos, type, decoded, error));
+    QVERIFY(!error);
+    QCOMPARE(pos, helloEnd);
+
+    QVERIFY(IpcSocket::takeFrame(buffer, pos, type, decoded, error));
+    QCOMPARE(type, IpcSocket::FrameJson);
+    QCOMPARE(decoded["msg"].toString(), QString("ping"));
+    QCOMPARE(pos, buffer.size());
+}
+
+void TestIpcSocket::invalidFrameLength()
+{
+    QByteArray buffer("\x00\x00\x00\x00\x02", 5);
+
+    int pos = 0;
+    IpcSocket::FrameType type;
+    QJsonObject decoded;
+    bool error = false;
+    QVERIFY(!IpcSocket::takeFrame(buffer, pos, type, decoded, error));
+    QVERIFY(error);
+}
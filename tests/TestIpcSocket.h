@@ -0,0 +1,19 @@
+#ifndef TESTIPCSOCKET_H
+#define TESTIPCSOCKET_H
+
+#include <QtTest/QtTest>
+
+class TestIpcSocket : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TestIpcSocket(QObject *parent = nullptr);
+
+private slots:
+    void frameRoundTrip();
+    void partialAndMultipleFrames();
+    void invalidFrameLength();
+};
+
+#endif // TESTIPCSOCKET_H
@@ -0,0 +1,138 @@
+#include "TestPasswordStrengthScorer.h"
+
+#include "../src/PasswordStrengthScorer.h"
+
+static const QString STRONG_PASSWORD = QStringLiteral("Xq7#vT9!mLp2@Rz8$wK4");
+
+TestPasswordStrengthScorer::TestPasswordStrengthScorer(QObject *parent) : QObject(parent)
+{
+
+}
+
+void TestPasswordStrengthScorer::debounce()
+{
+    PasswordStrengthScorer scorer;
+    scorer.setDebounceInterval(50);
+    QObject context, otherContext;
+
+    // Keystrokes of one field collapse into the last one
+    QStringList scored;
+    double entropy = -1;
+    scorer.score(&context, "p", [&scored](double) { scored << "p"; });
+    scorer.score(&context, "pa", [&scored](double) { scored << "pa"; });
+    scorer.score(&context, "pas", [&scored, &entropy](double e) { scored << "pas"; entropy = e; });
+
+    // Another field is not affected
+    bool otherScored = false;
+    scorer.score(&otherContext, "other", [&otherScored](double) { otherScored = true; });
+
+    QTRY_COMPARE(scored, QStringList() << "pas");
+    QTRY_VERIFY(otherScored);
+    QVERIFY(entropy > 0);
+
+    QTest::qWait(100);
+    QCOMPARE(scored, QStringList() << "pas");
+}
+
+void TestPasswordStrengthScorer::cacheHit()
+{
+    PasswordStrengthScorer scorer;
+    scorer.setDebounceInterval(0);
+    QObject context;
+
+    double first = -1;
+    scorer.score(&context, STRONG_PASSWORD, [&first](double e) { first = e; });
+    QCOMPARE(first, -1.0);
+    QTRY_VERIFY(first > 0);
+    QVERIFY(!PasswordStrengthScorer::isWeak(first));
+
+    // Known password is answered right away
+    double second = -1;
+    scorer.score(&context, STRONG_PASSWORD, [&second](double e) { second = e; });
+    QCOMPARE(second, first);
+
+    scorer.clearCache();
+    double third = -1;
+    scorer.score(&context, STRONG_PASSWORD, [&third](double e) { third = e; });
+    QCOMPARE(third, -1.0);
+    QTRY_COMPARE(third, first);
+}
+
+void TestPasswordStrengthScorer::cacheHitAfterInFlight()
+{
+    PasswordStrengthScorer scorer;
+    scorer.setDebounceInterval(0);
+    QObject context, probe;
+
+    QStringList scored;
+    scorer.score(&context, "ab", [&scored](double) { scored << "ab"; });
+    QTRY_COMPARE(scored, QStringList() << "ab");
+    scored.clear();
+
+    // "abc" is sent to the worker, then backspace gives the cached "ab"
+    scorer.score(&context, "abc", [&scored](double) { scored << "abc"; });
+    QVERIFY(QMetaObject::invokeMethod(&scorer, "flushPending"));
+    scorer.score(&context, "ab", [&scored](double) { scored << "ab"; });
+    QCOMPARE(scored, QStringList() << "ab");
+
+    // The late "abc" result is cached but not delivered
+    QTest::qWait(100);
+    bool probed = false;
+    scorer.score(&probe, "abc", [&probed](double) { probed = true; });
+    QVERIFY(probed);
+    QCOMPARE(scored, QStringList() << "ab");
+}
+
+void TestPasswordStrengthScorer::destroyedContext()
+{
+    PasswordStrengthScorer scorer;
+    scorer.setDebounceInterval(0);
+
+    bool scored = false;
+    {
+        QObject context;
+        scorer.score(&context, "password", [&scored](double) { scored = true; });
+    }
+
+    QTest::qWait(100);
+    QVERIFY(!scored);
+}
+
+void TestPasswordStrengthScorer::batch()
+{
+    PasswordStrengthScorer scorer;
+    scorer.setDebounceInterval(0);
+    QObject context;
+
+    double cached = -1;
+    scorer.score(&context, STRONG_PASSWORD, [&cached](double e) { cached = e; });
+    QTRY_VERIFY(cached > 0);
+
+    QHash<QString, QString> passwords;
+    passwords["example.com/alice"] = "password";
+    passwords["example.com/bob"] = STRONG_PASSWORD;
+    passwords["example.org/carol"] = "123456";
+
+    QHash<QString, double> result;
+    bool done = false;
+    scorer.scoreBatch(&context, passwords, [&result, &done](const QHash<QString, double> &entropies)
+    {
+        result = entropies;
+        done = true;
+    });
+    QTRY_VERIFY(done);
+
+    QCOMPARE(result.size(), passwords.size());
+    QCOMPARE(result["example.com/bob"], cached);
+    QVERIFY(PasswordStrengthScorer::isWeak(result["example.com/alice"]));
+    QVERIFY(PasswordStrengthScorer::isWeak(result["example.org/carol"]));
+    QVERIFY(!PasswordStrengthScorer::isWeak(result["example.com/bob"]));
+
+    // Batch results are cached too, the same set is answered right away
+    QHash<QString, double> again;
+    scorer.scoreBatch(&context, passwords, [&again](const QHash<QString, double> &entropies)
+    {
+        again = entropies;
+    });
+    QCOMPARE(again, result);
+}
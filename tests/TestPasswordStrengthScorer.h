@@ -0,0 +1,21 @@
+#ifndef TESTPASSWORDSTRENGTHSCORER_H
+#define TESTPASSWORDSTRENGTHSCORER_H
+
+#include <QtTest/QtTest>
+
+class TestPasswordStrengthScorer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TestPasswordStrengthScorer(QObject *parent = nullptr);
+
+private slots:
+    void debounce();
+    void cacheHit();
+    void cacheHitAfterInFlight();
+    void destroyedContext();
+    void batch();
+};
+
+#endif // TESTPASSWORDSTRENGTHSCORER_H
@@ -1,5 +1,8 @@
 #include "TestTreeItem.h"
+#include <QtTest>
 #include "../src/TreeItem.h"
+#include "../src/ServiceItem.h"
+#include "../src/LoginItem.h"
 
 
 
@@ -82,3 +85,22 @@ void TestTreeItem::removeChild()
     delete k;
     delete b;
 }
+
+void TestTreeItem::serviceLoginsCache()
+{
+    ServiceItem service("service");
+    QCOMPARE(service.logins(), QString());
+
+    LoginItem *alice = service.addLogin("alice");
+    QCOMPARE(service.logins(), QString("(alice)"));
+
+    service.addLogin("bob");
+    QCOMPARE(service.logins(), QString("(alice, bob)"));
+
+    alice->setName("carol");
+    QCOMPARE(service.logins(), QString("(carol, bob)"));
+
+    service.removeOne(alice);
+    delete alice;
+    QCOMPARE(service.logins(), QString("(bob)"));
+}
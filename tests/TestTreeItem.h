@@ -31,6 +31,7 @@ private Q_SLOTS:
     void createTreeItem();
     void addChild();
     void removeChild();
+    void serviceLoginsCache();
 private:
     QString baseItemName = "base";
     QString baseItemDescription = "base item";
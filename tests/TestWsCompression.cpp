@@ -0,0 +1,58 @@
+#include "TestWsCompression.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "../src/WsCompression.h"
+
+// Same shape as a memorymgmt_data message from the emulator
+static QByteArray memoryManagementData(int services)
+{
+    QJsonArray logins;
+    for (int i = 0; i < services; i++)
+    {
+        QJsonArray childs;
+        for (int j = 0; j < 3; j++)
+        {
+            childs.append(QJsonObject {{ "login", QString("user%1@mail%2.com").arg(j).arg(i) },
+                                       { "description", "" },
+                                       { "date_created", "2018-03-12" },
+                                       { "date_last_used", "2019-01-08" },
+                                       { "favorite", -1 },
+                                       { "address", QJsonArray { i % 256, j } }});
+        }
+        logins.append(QJsonObject {{ "service", QString("service%1.example.com").arg(i) },
+                                   { "address", QJsonArray { i % 256, 0 } },
+                                   { "multiple_domains", "" },
+                                   { "childs", childs }});
+    }
+
+    QJsonObject root {{ "msg", "memorymgmt_data" },
+                      { "data", QJsonObject {{ "login_nodes", logins }}}};
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+TestWsCompression::TestWsCompression(QObject *parent) : QObject(parent)
+{
+
+}
+
+void TestWsCompression::roundTrip()
+{
+    QByteArray message = memoryManagementData(10);
+    QByteArray frame = WsCompression::compress(message);
+    QVERIFY(frame.size() < message.size());
+
+    QByteArray decoded;
+    QVERIFY(WsCompression::uncompress(frame, decoded));
+    QCOMPARE(decoded, message);
+}
+
+void TestWsCompression::invalidFrame()
+{
+    QByteArray decoded;
+    QVERIFY(!WsCompression::uncompress(QByteArray(), decoded));
+    QVERIFY(!WsCompression::uncompress(QByteArray("{\"msg\":\"ping\"}"), decoded));
+    QVERIFY(!WsCompression::uncompress(QByteArray("Z\x00\x00\x00\x10garbage", 12), decoded));
+}
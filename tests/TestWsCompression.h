@@ -0,0 +1,18 @@
+#ifndef TESTWSCOMPRESSION_H
+#define TESTWSCOMPRESSION_H
+
+#include <QtTest/QtTest>
+
+class TestWsCompression : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TestWsCompression(QObject *parent = nullptr);
+
+private slots:
+    void roundTrip();
+    void invalidFrame();
+};
+
+#endif // TESTWSCOMPRESSION_H
@@ -0,0 +1,206 @@
+#include "ProtocolBenchmark.h"
+#include "MessageProtocol/MessageProtocolBLE.h"
+#include "MessageProtocol/MessageProtocolMini.h"
+
+//Iterations used for the packets/s figure printed next to QBENCHMARK results
+static const int RATE_ITERATIONS = 20000;
+
+static QByteArray makePayload(int size)
+{
+    QByteArray payload(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i)
+        payload[i] = static_cast<char>(i * 7);
+    return payload;
+}
+
+template<typename Func>
+static void printRate(const char *name, int packetsPerRun, Func func)
+{
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < RATE_ITERATIONS; ++i)
+        func();
+    const qint64 ns = qMax<qint64>(1, timer.nsecsElapsed());
+    const double rate = static_cast<double>(packetsPerRun) * RATE_ITERATIONS * 1e9 / ns;
+    qDebug("%s: %.0f packets/s", name, rate);
+}
+
+static void addSizes(std::initializer_list<int> sizes)
+{
+    QTest::addColumn<int>("size");
+    for (int size : sizes)
+        QTest::newRow(QByteArray::number(size).constData()) << size;
+}
+
+ProtocolBenchmark::ProtocolBenchmark(QObject *parent) : QObject(parent)
+{
+}
+
+void ProtocolBenchmark::bench_bleEncode_data()
+{
+    //BLE messages are limited to 16 packets
+    addSizes({0, 58, 300, 900});
+}
+
+void ProtocolBenchmark::bench_bleEncode()
+{
+    QFETCH(int, size);
+    MessageProtocolBLE prot;
+    const QByteArray payload = makePayload(size);
+    const int packetCount = prot.createPackets(payload, MPCmd::PING).size();
+
+    QBENCHMARK
+    {
+        QVector<QByteArray> packets = prot.createPackets(payload, MPCmd::PING);
+        Q_UNUSED(packets);
+    }
+
+    printRate("BLE encode", packetCount, [&prot, &payload]()
+    {
+        QVector<QByteArray> packets = prot.createPackets(payload, MPCmd::PING);
+        Q_UNUSED(packets);
+    });
+}
+
+void ProtocolBenchmark::bench_bleDecode_data()
+{
+    addSizes({0, 58, 300, 900});
+}
+
+void ProtocolBenchmark::bench_bleDecode()
+{
+    QFETCH(int, size);
+    MessageProtocolBLE prot;
+    const QByteArray payload = makePayload(size);
+    const QVector<QByteArray> packets = prot.createPackets(payload, MPCmd::PING);
+
+    QByteArray decoded;
+    decoded.reserve(size);
+    for (const QByteArray &packet : packets)
+    {
+        const PayloadView view = prot.getPayloadView(packet);
+        decoded.append(view.data, view.size);
+    }
+    //First packet view is bounded by the message size, the last packet
+    //of a multi packet message carries only what is left
+    QCOMPARE(decoded, payload);
+    QCOMPARE(prot.getCommand(packets.first()), MPCmd::PING);
+
+    QBENCHMARK
+    {
+        decoded.resize(0);
+        for (const QByteArray &packet : packets)
+        {
+            const PayloadView view = prot.getPayloadView(packet);
+            decoded.append(view.data, view.size);
+        }
+    }
+
+    printRate("BLE decode", packets.size(), [&prot, &packets, &decoded]()
+    {
+        decoded.resize(0);
+        for (const QByteArray &packet : packets)
+        {
+            const PayloadView view = prot.getPayloadView(packet);
+            decoded.append(view.data, view.size);
+        }
+    });
+}
+
+void ProtocolBenchmark::bench_miniEncode_data()
+{
+    addSizes({0, 16, 62});
+}
+
+void ProtocolBenchmark::bench_miniEncode()
+{
+    QFETCH(int, size);
+    MessageProtocolMini prot;
+    const QByteArray payload = makePayload(size);
+
+    QBENCHMARK
+    {
+        QVector<QByteArray> packets = prot.createPackets(payload, MPCmd::PING);
+        Q_UNUSED(packets);
+    }
+
+    printRate("Mini encode", 1, [&prot, &payload]()
+    {
+        QVector<QByteArray> packets = prot.createPackets(payload, MPCmd::PING);
+        Q_UNUSED(packets);
+    });
+}
+
+void ProtocolBenchmark::bench_miniDecode_data()
+{
+    addSizes({0, 16, 62});
+}
+
+void ProtocolBenchmark::bench_miniDecode()
+{
+    QFETCH(int, size);
+    MessageProtocolMini prot;
+    const QByteArray payload = makePayload(size);
+    const QByteArray packet = prot.createPackets(payload, MPCmd::PING).first();
+    QCOMPARE(prot.getFullPayload(packet), payload);
+
+    int total = 0;
+    QBENCHMARK
+    {
+        total += prot.getPayloadView(packet).size;
+    }
+
+    printRate("Mini decode", 1, [&prot, &packet, &total]()
+    {
+        total += prot.getPayloadView(packet).size;
+    });
+}
+
+void ProtocolBenchmark::bench_miniWriteNode()
+{
+    MessageProtocolMini prot;
+    const QByteArray node = makePayload(132);
+    const QByteArray address = QByteArray::fromHex("1234");
+    const QVector<QByteArray> expected = prot.createWriteNodePackets(node, address);
+    QCOMPARE(expected.size(), 3);
+    QCOMPARE(expected.at(0).mid(3), node.mid(0, 59));
+    QCOMPARE(expected.at(2).mid(3), node.mid(118, 14));
+
+    QBENCHMARK
+    {
+        QVector<QByteArray> packets = prot.createWriteNodePackets(node, address);
+        Q_UNUSED(packets);
+    }
+
+    printRate("Mini write node", expected.size(), [&prot, &node, &address]()
+    {
+        QVector<QByteArray> packets = prot.createWriteNodePackets(node, address);
+        Q_UNUSED(packets);
+    });
+}
+
+void ProtocolBenchmark::bench_commandDecode()
+{
+    MessageProtocolBLE prot;
+    QVector<QByteArray> packets;
+    for (MPCmd::Command cmd : {MPCmd::PING, MPCmd::GET_CREDENTIAL, MPCmd::CMD_DBG_REINDEX_BUNDLE})
+        packets.append(prot.createPackets(QByteArray(), cmd).first());
+
+    //Commands sharing a device id decode to the lowest generic id
+    QCOMPARE(prot.getCommand(packets.at(0)), MPCmd::PING);
+    QCOMPARE(prot.getCommand(packets.at(1)), MPCmd::GET_CREDENTIAL);
+    QCOMPARE(prot.getCommand(packets.at(2)), MPCmd::CMD_DBG_REINDEX_BUNDLE);
+
+    int sum = 0;
+    QBENCHMARK
+    {
+        for (const QByteArray &packet : packets)
+            sum += prot.getCommand(packet);
+    }
+
+    printRate("BLE command decode", packets.size(), [&prot, &packets, &sum]()
+    {
+        for (const QByteArray &packet : packets)
+            sum += prot.getCommand(packet);
+    });
+}
@@ -0,0 +1,26 @@
+#ifndef PROTOCOLBENCHMARK_H
+#define PROTOCOLBENCHMARK_H
+
+#include <QtTest/QtTest>
+
+class ProtocolBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProtocolBenchmark(QObject *parent = nullptr);
+
+private slots:
+    void bench_bleEncode();
+    void bench_bleEncode_data();
+    void bench_bleDecode();
+    void bench_bleDecode_data();
+    void bench_miniEncode();
+    void bench_miniEncode_data();
+    void bench_miniDecode();
+    void bench_miniDecode_data();
+    void bench_miniWriteNode();
+    void bench_commandDecode();
+};
+
+#endif // PROTOCOLBENCHMARK_H
@@ -0,0 +1,149 @@
+#include "WsCompressionBenchmark.h"
+#include "WsCompression.h"
+#include "ExportFileGenerator.h"
+#include "AeadCrypt/AeadCrypt.h"
+#include <random>
+
+//Same shape as a memorymgmt_data message from the emulator
+static QByteArray memoryManagementData(int services)
+{
+    QJsonArray logins;
+    for (int i = 0; i < services; i++)
+    {
+        QJsonArray childs;
+        for (int j = 0; j < 3; j++)
+        {
+            childs.append(QJsonObject {{ "login", QString("user%1@mail%2.com").arg(j).arg(i) },
+                                       { "description", "" },
+                                       { "date_created", "2018-03-12" },
+                                       { "date_last_used", "2019-01-08" },
+                                       { "favorite", -1 },
+                                       { "address", QJsonArray { i % 256, j } }});
+        }
+        logins.append(QJsonObject {{ "service", QString("service%1.example.com").arg(i) },
+                                   { "address", QJsonArray { i % 256, 0 } },
+                                   { "multiple_domains", "" },
+                                   { "childs", childs }});
+    }
+
+    QJsonObject root {{ "msg", "memorymgmt_data" },
+                      { "data", QJsonObject {{ "login_nodes", logins }}}};
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+static QByteArray randomBytes(int size)
+{
+    //Fixed seed, runs are comparable
+    static std::mt19937 rng(42);
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; i++)
+        data[i] = static_cast<char>(rng());
+    return data;
+}
+
+//Mini flash node: flags, linked list addresses, text and for childs the encrypted password
+static QByteArray nodeData(const QString &text, bool child)
+{
+    QByteArray data(132, 0);
+    data[0] = static_cast<char>(child? 0xC0 : 0x40);
+    QByteArray t = text.toUtf8().left(58);
+    data.replace(child? 38 : 8, t.size(), t);
+    if (child)
+        data.replace(100, 32, randomBytes(32));
+    return data;
+}
+
+//Database of the given number of services with 3 logins each, as read in MMM
+static ExportFileGenerator::Snapshot exportSnapshot(int services)
+{
+    ExportFileGenerator::Snapshot s;
+    s.ctrValue = randomBytes(3);
+    s.cpzCtrValue << randomBytes(16) << randomBytes(16);
+    s.startNode = QByteArray(2, 0);
+    s.startDataNode = QByteArray(2, 0);
+    for (int i = 0; i < 14; i++)
+        s.favoritesAddrs << QByteArray(4, 0);
+
+    for (int i = 0; i < services; i++)
+    {
+        QByteArray address(2, 0);
+        address[0] = static_cast<char>(i % 256);
+        address[1] = static_cast<char>(i / 256);
+        QString service = QString("service%1.example.com").arg(i);
+        s.loginNodes.append({ address, service, nodeData(service, false) });
+
+        for (int j = 0; j < 3; j++)
+        {
+            QString login = QString("user%1@mail%2.com").arg(j).arg(i);
+            s.loginChildNodes.append({ address, login, nodeData(login, true) });
+        }
+    }
+
+    s.credentialsDbChangeNumber = 3;
+    s.dataDbChangeNumber = 2;
+    s.serialNumber = 12345;
+    s.cardCPZ = randomBytes(8);
+    s.simpleCryptKey = 0x0c2ad4a4acb9f023;
+    s.compressionLevel = AeadCrypt::DEFAULT_COMPRESSION_LEVEL;
+    return s;
+}
+
+WsCompressionBenchmark::WsCompressionBenchmark(QObject *parent) : QObject(parent)
+{
+}
+
+void WsCompressionBenchmark::bench_memoryManagementData_data()
+{
+    QTest::addColumn<int>("level");
+
+    QTest::newRow("level 1") << 1;
+    QTest::newRow("level 6") << WsCompression::DEFAULT_LEVEL;
+    QTest::newRow("level 9") << 9;
+}
+
+void WsCompressionBenchmark::bench_memoryManagementData()
+{
+    QFETCH(int, level);
+
+    QByteArray message = memoryManagementData(1000);
+    QByteArray frame;
+    QBENCHMARK
+    {
+        frame = WsCompression::compress(message, level);
+    }
+
+    qDebug("memorymgmt_data: %d -> %d bytes on wire", message.size(), frame.size());
+    QVERIFY(frame.size() < message.size());
+}
+
+void WsCompressionBenchmark::bench_exportDatabase_data()
+{
+    QTest::addColumn<QString>("encryption");
+
+    QTest::newRow("none") << QString("none");
+    QTest::newRow("SimpleCrypt") << QString("SimpleCrypt");
+    QTest::newRow("ChaCha20-Poly1305") << QString("ChaCha20-Poly1305");
+}
+
+void WsCompressionBenchmark::bench_exportDatabase()
+{
+    QFETCH(QString, encryption);
+
+    const ExportFileGenerator::Snapshot snapshot = exportSnapshot(1000);
+    QByteArray message;
+    QByteArray frame;
+
+    //Daemon side of an export_database answer: file generation, message and compression
+    QBENCHMARK
+    {
+        QByteArray fileData = ExportFileGenerator::generate(snapshot, encryption);
+        QJsonObject oroot {{ "msg", "export_database" },
+                           { "data", QJsonObject {{ "file_data", QString(fileData.toBase64()) }}}};
+        message = QJsonDocument(oroot).toJson(QJsonDocument::Compact);
+        frame = WsCompression::compress(message);
+    }
+
+    qDebug("export_database (%s): %d -> %d bytes on wire",
+           qPrintable(encryption), message.size(), frame.size());
+    QVERIFY(frame.size() < message.size());
+}
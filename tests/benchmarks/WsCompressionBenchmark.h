@@ -0,0 +1,20 @@
+#ifndef WSCOMPRESSIONBENCHMARK_H
+#define WSCOMPRESSIONBENCHMARK_H
+
+#include <QtTest/QtTest>
+
+class WsCompressionBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WsCompressionBenchmark(QObject *parent = nullptr);
+
+private slots:
+    void bench_memoryManagementData();
+    void bench_memoryManagementData_data();
+    void bench_exportDatabase();
+    void bench_exportDatabase_data();
+};
+
+#endif // WSCOMPRESSIONBENCHMARK_H
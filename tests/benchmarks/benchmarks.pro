@@ -0,0 +1,55 @@
+#-------------------------------------------------
+#
+# Protocol codec and websocket message benchmarks, run with ./benchmarks
+# (add -tickcounter or -callgrind for other backends)
+#
+#-------------------------------------------------
+
+QT       += testlib network
+
+QT       -= gui
+
+QMAKE_CXXFLAGS += -std=c++0x
+
+TARGET = benchmarks
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += ../../src
+
+SOURCES += \
+    ../../src/MooltipassCmds.cpp \
+    ../../src/MessageProtocol/MessageProtocolMini.cpp \
+    ../../src/MessageProtocol/MessageProtocolBLE.cpp \
+    ../../src/Common.cpp \
+    ../../src/AsyncLogger.cpp \
+    ../../src/WsCompression.cpp \
+    ../../src/ExportFileGenerator.cpp \
+    ../../src/SimpleCrypt/SimpleCrypt.cpp \
+    ../../src/AeadCrypt/AeadCrypt.cpp \
+    ../../src/AeadCrypt/ChaChaPoly.cpp \
+    ../../src/AeadCrypt/BlockCompressor.cpp \
+    main.cpp \
+    ProtocolBenchmark.cpp \
+    WsCompressionBenchmark.cpp
+
+HEADERS += \
+    ../../src/MooltipassCmds.h \
+    ../../src/MessageProtocol/IMessageProtocol.h \
+    ../../src/MessageProtocol/CommandMap.h \
+    ../../src/MessageProtocol/MessageProtocolMini.h \
+    ../../src/MessageProtocol/MessageProtocolBLE.h \
+    ../../src/Common.h \
+    ../../src/AsyncLogger.h \
+    ../../src/WsCompression.h \
+    ../../src/ExportFileGenerator.h \
+    ../../src/SimpleCrypt/SimpleCrypt.h \
+    ../../src/AeadCrypt/AeadCrypt.h \
+    ../../src/AeadCrypt/ChaChaPoly.h \
+    ../../src/AeadCrypt/BlockCompressor.h \
+    ProtocolBenchmark.h \
+    WsCompressionBenchmark.h
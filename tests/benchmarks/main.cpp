@@ -0,0 +1,26 @@
+#include <QtTest>
+
+#include "ProtocolBenchmark.h"
+#include "WsCompressionBenchmark.h"
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    int status = 0;
+    const auto runBenchmark = [&status, argc, argv](QObject *benchmark) {
+        status += QTest::qExec(benchmark, argc, argv);
+    };
+
+    {
+        ProtocolBenchmark protocolBenchmark;
+        runBenchmark(&protocolBenchmark);
+    }
+
+    {
+        WsCompressionBenchmark wsCompressionBenchmark;
+        runBenchmark(&wsCompressionBenchmark);
+    }
+
+    return status;
+}
@@ -8,6 +8,12 @@
 #include "TestCredentialModelFilter.h"
 #include "TestDbExportsRegistry.h"
 #include "TestParseDomain.h"
+#include "TestAeadCrypt.h"
+#include "TestIpcSocket.h"
+#include "TestWsCompression.h"
+#include "TestPasswordStrengthScorer.h"
+#include "TestAsyncLogger.h"
+#include "TestExportFileGenerator.h"
 
 // Note: This is equivalent to QTEST_APPLESS_MAIN for multiple test classes.
 int main(int argc, char** argv)
@@ -50,6 +56,36 @@ int main(int argc, char** argv)
         runTest(&testParseDomain);
     }
 
+    {
+        TestAeadCrypt testAeadCrypt;
+        runTest(&testAeadCrypt);
+    }
+
+    {
+        TestIpcSocket testIpcSocket;
+        runTest(&testIpcSocket);
+    }
+
+    {
+        TestWsCompression testWsCompression;
+        runTest(&testWsCompression);
+    }
+
+    {
+        TestPasswordStrengthScorer testPasswordStrengthScorer;
+        runTest(&testPasswordStrengthScorer);
+    }
+
+    {
+        TestAsyncLogger testAsyncLogger;
+        runTest(&testAsyncLogger);
+    }
+
+    {
+        TestExportFileGenerator testExportFileGenerator;
+        runTest(&testExportFileGenerator);
+    }
+
     return status;
 }
 
@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += testlib
+QT       += testlib network
 
 QT       -= gui
 
@@ -31,6 +31,9 @@ include (../src/QSimpleUpdater/QSimpleUpdater.pri)
 
 SOURCES += \
     ../src/SimpleCrypt/SimpleCrypt.cpp \
+    ../src/AeadCrypt/AeadCrypt.cpp \
+    ../src/AeadCrypt/ChaChaPoly.cpp \
+    ../src/AeadCrypt/BlockCompressor.cpp \
     ../src/FilesCache.cpp \
     ../src/DbBackupsTracker.cpp \
     ../src/TreeItem.cpp \
@@ -39,9 +42,17 @@ SOURCES += \
     ../src/ServiceItem.cpp \
     ../src/CredentialModel.cpp \
     ../src/CredentialModelFilter.cpp \
+    ../src/CredentialSearchIndex.cpp \
     ../src/DbExportsRegistry.cpp \
     ../src/DbBackupChangeNumbersComparator.cpp \
     ../src/ParseDomain.cpp \
+    ../src/IpcSocket.cpp \
+    ../src/WsCompression.cpp \
+    ../src/PasswordStrengthScorer.cpp \
+    ../src/AsyncLogger.cpp \
+    ../src/Common.cpp \
+    ../src/ExportFileGenerator.cpp \
+    ../src/zxcvbn-c/zxcvbn.c \
     main.cpp \
     FilesCacheTests.cpp \
     UpdaterTests.cpp \
@@ -50,10 +61,19 @@ SOURCES += \
     TestCredentialModel.cpp \
     TestCredentialModelFilter.cpp \
     TestDbExportsRegistry.cpp \
-    TestParseDomain.cpp
+    TestParseDomain.cpp \
+    TestAeadCrypt.cpp \
+    TestIpcSocket.cpp \
+    TestWsCompression.cpp \
+    TestPasswordStrengthScorer.cpp \
+    TestAsyncLogger.cpp \
+    TestExportFileGenerator.cpp
 
 HEADERS += \
     ../src/SimpleCrypt/SimpleCrypt.h \
+    ../src/AeadCrypt/AeadCrypt.h \
+    ../src/AeadCrypt/ChaChaPoly.h \
+    ../src/AeadCrypt/BlockCompressor.h \
     ../src/FilesCache.h \
     ../src/DbBackupsTracker.h\
     ../src/TreeItem.h \
@@ -62,9 +82,16 @@ HEADERS += \
     ../src/ServiceItem.h \
     ../src/CredentialModel.h \
     ../src/CredentialModelFilter.h \
+    ../src/CredentialSearchIndex.h \
     ../src/DbExportsRegistry.h \
     ../src/DbBackupChangeNumbersComparator.h \
     ../src/ParseDomain.h \
+    ../src/IpcSocket.h \
+    ../src/WsCompression.h \
+    ../src/PasswordStrengthScorer.h \
+    ../src/AsyncLogger.h \
+    ../src/Common.h \
+    ../src/ExportFileGenerator.h \
     UpdaterTests.h \
     FilesCacheTests.h \
     DbBackupsTrackerTests.h \
@@ -72,6 +99,14 @@ HEADERS += \
     TestCredentialModel.h \
     TestCredentialModelFilter.h \
     TestDbExportsRegistry.h \
-    TestParseDomain.h
+    TestParseDomain.h \
+    TestAeadCrypt.h \
+    TestIpcSocket.h \
+    TestWsCompression.h \
+    TestPasswordStrengthScorer.h \
+    TestAsyncLogger.h \
+    TestExportFileGenerator.h
+
+INCLUDEPATH += ../src/zxcvbn-c
 
 DEFINES += SRCDIR=\\\"$$PWD/\\\"